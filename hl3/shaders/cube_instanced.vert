@@ -0,0 +1,20 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in mat4 aModel; // per-instance, occupies locations 1-4
+
+layout(std140) uniform FrameConstants { // Shared per-frame block (gl_frame_constants.h)
+    mat4  u_View;
+    mat4  u_Projection;
+    mat4  u_ViewProjection;
+    vec4  u_CameraPosition;
+    float u_Time;
+    vec2  u_Resolution;
+};
+
+uniform vec4 u_PositionDecode; // xyz: mesh-local origin, w: scale (quantized positions)
+
+void main()
+{
+    vec3 position = u_PositionDecode.xyz + aPos * u_PositionDecode.w;
+    gl_Position = u_ViewProjection * aModel * vec4(position, 1.0);
+}
@@ -1,6 +1,20 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+
+layout(std140) uniform FrameConstants { // Shared per-frame block (gl_frame_constants.h)
+    mat4  u_View;
+    mat4  u_Projection;
+    mat4  u_ViewProjection;
+    vec4  u_CameraPosition;
+    float u_Time;
+    vec2  u_Resolution;
+};
+
+uniform mat4 u_Model;
+uniform vec4 u_PositionDecode; // xyz: mesh-local origin, w: scale (quantized positions)
+
 void main() {
-    gl_Position = vec4(aPos, 1.0); // Direct clip space
+    vec3 position = u_PositionDecode.xyz + aPos * u_PositionDecode.w;
+    gl_Position = u_ViewProjection * u_Model * vec4(position, 1.0);
     gl_PointSize = 3.0;
 }
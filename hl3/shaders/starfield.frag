@@ -2,7 +2,14 @@
 out vec4 FragColor;
 in vec2 TexCoords;
 
-uniform float u_Time;
+layout(std140) uniform FrameConstants { // Shared per-frame block (gl_frame_constants.h)
+    mat4  u_View;
+    mat4  u_Projection;
+    mat4  u_ViewProjection;
+    vec4  u_CameraPosition;
+    float u_Time;
+    vec2  u_Resolution;
+};
 
 float hash(vec2 p) {
     return fract(sin(dot(p ,vec2(12.9898,78.233))) * 43758.5453);
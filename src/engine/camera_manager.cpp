@@ -1,4 +1,5 @@
 #include "camera_manager.h"
+#include "floating_origin_manager.h"
 #include "mathlib/precision_convert.h"
 
 CameraManager::CameraManager()
@@ -101,14 +102,12 @@ Matrix4x4_f CameraManager::GetLocalViewMatrix() const
 
         case CameraPrecision::Double:
         {
-            Vector3_d camPos = m_Camera_d.GetPosition();
-            // Removed debug prints
-            Vector3_d localCamPos = camPos - m_WorldOrigin;
-            // Removed debug prints
-            Camera_d temp = m_Camera_d;
-            temp.SetPosition(localCamPos);
-            Matrix4x4_d localView_d = temp.GetViewMatrix();
-            return precision::ToFloat(localView_d);
+            // Only the small camera-to-origin offset is narrowed to float; no Camera_d
+            // copy and no double matrix. In camera-relative mode the offset is zero.
+            Vector3_d offset = m_Camera_d.GetPosition() - GetRenderOrigin();
+            Vector3_d forward = m_Camera_d.GetForwardVector();
+            return Matrix4x4_f::LookTo(precision::ToFloat(offset), precision::ToFloat(forward),
+                                       Vector3_f(0.0f, 1.0f, 0.0f));
         }
     }
     return Matrix4x4_f::Identity();
@@ -116,41 +115,44 @@ Matrix4x4_f CameraManager::GetLocalViewMatrix() const
 
 void CameraManager::ApplyFloatingOrigin(Vector3_d newOrigin)
 {
-    // Removed debug print
-    m_WorldOrigin = newOrigin;
-    // Shift all world entities by -newOrigin
+    GetFloatingOriginManager().RebaseNow(newOrigin);
 }
 
 // FLOATING ORIGIN LOGIC:
 void CameraManager::UpdateFloatingOrigin(const Vector3_d& playerPosition)
 {
-    Vector3_d delta = playerPosition - m_WorldOrigin;
+    FloatingOriginManager& origin = GetFloatingOriginManager();
+    origin.Update();
+
+    // Let an in-flight rebase finish before measuring against the next origin
+    if (origin.IsRebasing())
+        return;
+
+    Vector3_d delta = playerPosition - origin.GetOrigin();
     double distSquared = delta.LengthSqr();
 
     if (distSquared > (FloatingOriginThreshold * FloatingOriginThreshold))
     {
-        // Removed debug print
-
         ApplyFloatingOriginShift(delta);
     }
 }
 
 void CameraManager::ApplyFloatingOriginShift(const Vector3_d& delta)
 {
-    // Shift the world origin
-    m_WorldOrigin += delta;
-
-    // Shift Camera_d position by negative delta to keep local space near zero
-    Vector3_d camPos = m_Camera_d.GetPosition();
-    m_Camera_d.SetPosition(camPos - delta);
-
-    // TODO: Shift all world entities (players, objects, etc) by -delta
-    // For now, assume player position will be shifted by caller after this
-
-    // Removed debug print
+    // World entities (and the view, via GetWorldOrigin) switch over together once
+    // FloatingOriginManager has rebased them all
+    FloatingOriginManager& origin = GetFloatingOriginManager();
+    origin.RequestRebase(origin.GetTargetOrigin() + delta);
 }
 
 Vector3_d CameraManager::GetWorldOrigin() const
 {
-    return m_WorldOrigin;
-}
\ No newline at end of file
+    return GetFloatingOriginManager().GetOrigin();
+}
+
+Vector3_d CameraManager::GetRenderOrigin() const
+{
+    if (IsCameraRelative())
+        return m_Camera_d.GetPosition();
+    return GetWorldOrigin();
+}
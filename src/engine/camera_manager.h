@@ -8,6 +8,12 @@ enum class CameraPrecision {
     Double
 };
 
+// What the GPU-side float positions are relative to (double precision camera only)
+enum class RenderOriginMode {
+    FloatingOrigin,     // World minus the floating origin; refreshed only when the origin moves
+    CameraRelative      // World minus the camera, every frame; full float precision at any distance
+};
+
 class CameraManager {
 public:
     CameraManager();
@@ -32,16 +38,31 @@ public:
 	
 	void UpdateRotationOnly(float dt, int mouseDX, int mouseDY);
 	
+	// View matrix relative to GetRenderOrigin(); rotation-only in camera-relative mode
 	Matrix4x4_f GetLocalViewMatrix() const;
+
+	void SetRenderOriginMode(RenderOriginMode mode) { m_RenderOriginMode = mode; }
+	RenderOriginMode GetRenderOriginMode() const { return m_RenderOriginMode; }
+
+	// Camera-relative mode with the double camera active; the float camera has no
+	// world position to be relative to, so it always renders against the floating origin
+	bool IsCameraRelative() const {
+		return activePrecision == CameraPrecision::Double && m_RenderOriginMode == RenderOriginMode::CameraRelative;
+	}
+
+	// World position the current frame's float transforms are relative to
+	Vector3_d GetRenderOrigin() const;
 	
-	// IMPLEMENTED LATER!
+	// Moves the origin immediately, rebasing every registered entity this frame
 	void ApplyFloatingOrigin(Vector3_d newOrigin);
 	
 	
 	// FLOATING ORIGIN LOGIC
+	// Camera_d stays in world space; the origin lives in FloatingOriginManager and the
+	// view matrix is built relative to it.
 	Vector3_d GetWorldOrigin() const;
-    void UpdateFloatingOrigin(const Vector3_d& playerPosition);
-    void ApplyFloatingOriginShift(const Vector3_d& delta);
+    void UpdateFloatingOrigin(const Vector3_d& playerPosition); // Once per frame
+    void ApplyFloatingOriginShift(const Vector3_d& delta);      // Amortized over frames
 
 
 private:
@@ -53,11 +74,11 @@ private:
     Camera_d m_Camera_d;    // double precision camera
 	
 	// FLOATING ORIGIN LOGIC
-	Vector3_d m_WorldOrigin = Vector3_d(0.0, 0.0, 0.0);
 	const double FloatingOriginThreshold = 1000.0; // meters; tune as needed
 
 	//////////
 	
     CameraPrecision activePrecision;
+    RenderOriginMode m_RenderOriginMode = RenderOriginMode::CameraRelative;
 
 };
\ No newline at end of file
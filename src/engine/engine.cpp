@@ -1,29 +1,40 @@
 //-----------------------------------------------------------------------------
 // ENGINE.CPP - INC. INC© INCBOX 2007 ALL RIGHTS RESERVED.
 // Core engine logic: SDL window, ShaderAPI abstraction, filesystem DLL loading,
-// map loading (JSON), input, player, and main loop.
+// map loading (compiled .imapc, JSON fallback), input, player, and main loop.
 //-----------------------------------------------------------------------------
 
 #include <Windows.h>
 
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
-#include <fstream>
 #include <filesystem>
 #include <string>
+#include <vector>
 #include "nlohmann/json.hpp"
 
+#include "filesystem/async_read.h"
+#include "filesystem/file_view.h"
 #include "engine_api.h"
 #include "engine_globals.h"              // access the main camera from anywhere in engine
 #include "engine_log.h"
+#include "profiler.h"
 
 #include "engine_renderer.h"
+#include "null_render_backend.h"
 
 #include "world/static_mesh_loader.h"    // Static geometry loader (JSON)
+#include "world/compiled_map.h"          // Compiled binary maps (.imapc)
+#include "world/mesh_cache.h"            // Shared primitive meshes
+#include "world/model_cache.h"           // Shared .imdl models, cooked on first load
+#include "world/sector_streamer.h"       // Background sector streaming around the camera
 
 #include "input.h"
 #include "camera_manager.h"
+#include "floating_origin_manager.h"
 #include "mathlib/matrix4x4_f.h"
 
 #include "player.h"
@@ -52,6 +63,18 @@ static Input g_Input;
 static Player g_Player;
 static SDL_Window* g_Window = nullptr;
 
+// Launcher switches (see engine_api.h)
+struct EngineOptions {
+    bool nullRender = false;
+    bool noRenderThread = false;
+    std::string renderCommandLog;
+    uint32_t benchFrames = 0;   // 0: run until quit
+    size_t uploadBudgetBytes = RendererConfig().uploadBudgetBytes;
+    double uploadBudgetMs = RendererConfig().uploadBudgetMs;
+};
+static EngineOptions g_Options;
+static RendererConfig g_RendererConfig;
+
 //-----------------------------------------------------------------------------
 // FileSystem DLL dynamic loading
 //-----------------------------------------------------------------------------
@@ -61,6 +84,9 @@ typedef const std::string& (*FS_GetGameDirFn)();
 typedef std::string (*FS_ResolvePathFn)(const std::string&);
 static FS_GetGameDirFn FS_GetGameDir = nullptr;
 static FS_ResolvePathFn FS_ResolvePath = nullptr;
+static FSOpenMappedFn FS_OpenMapped = nullptr;
+static FSReadAsyncFn FS_ReadAsync = nullptr;
+static FSCancelAsyncFn FS_CancelAsync = nullptr;
 
 //-----------------------------------------------------------------------------
 // Cross-platform export macros
@@ -81,10 +107,20 @@ void InitEngineLog() {
     EngineLog("[Engine] Log started");
 }
 
+// The log's writer thread has to be joined before the process exits, on every
+// way out of Engine_Run
+struct EngineLogScope {
+    EngineLogScope() { InitEngineLog(); }
+    ~EngineLogScope() { EngineLog_Shutdown(); }
+};
+
 //-----------------------------------------------------------------------------
 // Load filesystem DLL and get function pointers
 //-----------------------------------------------------------------------------
 bool LoadFileSystem() {
+    if (g_FileSystemDLL)
+        return true;
+
     g_FileSystemDLL = LoadLibraryExA("bin/filesystem_stdio.dll", NULL, LOAD_WITH_ALTERED_SEARCH_PATH);
     if (!g_FileSystemDLL) {
         std::cerr << "[Engine] Failed to load filesystem_stdio.dll\n";
@@ -93,8 +129,11 @@ bool LoadFileSystem() {
 
     FS_GetGameDir = reinterpret_cast<FS_GetGameDirFn>(GetProcAddress(g_FileSystemDLL, "FS_GetGameDir"));
     FS_ResolvePath = reinterpret_cast<FS_ResolvePathFn>(GetProcAddress(g_FileSystemDLL, "FS_ResolvePath"));
+    FS_OpenMapped = reinterpret_cast<FSOpenMappedFn>(GetProcAddress(g_FileSystemDLL, "FS_OpenMapped"));
+    FS_ReadAsync = reinterpret_cast<FSReadAsyncFn>(GetProcAddress(g_FileSystemDLL, "FS_ReadAsync"));
+    FS_CancelAsync = reinterpret_cast<FSCancelAsyncFn>(GetProcAddress(g_FileSystemDLL, "FS_CancelAsync"));
 
-    if (!FS_GetGameDir || !FS_ResolvePath) {
+    if (!FS_GetGameDir || !FS_ResolvePath || !FS_OpenMapped || !FS_ReadAsync || !FS_CancelAsync) {
         std::cerr << "[Engine] Failed to resolve FileSystem exports\n";
         FreeLibrary(g_FileSystemDLL);
         g_FileSystemDLL = nullptr;
@@ -106,26 +145,27 @@ bool LoadFileSystem() {
 }
 
 //-----------------------------------------------------------------------------
-// Load JSON map, parse entities, and load static geometry
+// Load compiled map: upload baked geometry straight out of the mapped .imapc
 //-----------------------------------------------------------------------------
-bool LoadMap(const std::string& mapName) {
-    std::string relative = "maps/" + mapName + ".json";
-    std::string resolved = FS_ResolvePath(relative);
-
-    if (resolved.empty()) {
-        std::cerr << "[Engine] Map not found: " << relative << "\n";
+static bool LoadCompiledMap(FSFileViewPtr file, const std::string& relative) {
+    CompiledMap map;
+    if (!map.Open(std::move(file), relative))
         return false;
-    }
 
-    std::ifstream mapFile(resolved);
-    if (!mapFile.is_open()) {
-        std::cerr << "[Engine] Failed to open map: " << resolved << "\n";
-        return false;
-    }
+    std::cout << "[Engine] Loading compiled map: " << relative
+              << " (" << map.GetEntityCount() << " entities)\n";
 
+    LoadStaticGeometryFromCompiledMap(map);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Load JSON map, parse entities, and load static geometry
+//-----------------------------------------------------------------------------
+static bool LoadJSONMap(const FSFileView& file) {
     json mapData;
     try {
-        mapFile >> mapData;
+        mapData = json::parse(file.data, file.data + file.size);
     } catch (const std::exception& e) {
         std::cerr << "[Engine] JSON parsing error: " << e.what() << "\n";
         return false;
@@ -144,17 +184,109 @@ bool LoadMap(const std::string& mapName) {
     return true;
 }
 
+//-----------------------------------------------------------------------------
+// Load map by name: prefer maps/<name>.imapc, fall back to maps/<name>.json
+//-----------------------------------------------------------------------------
+bool LoadMap(const std::string& mapName) {
+    std::string jsonRelative = "maps/" + mapName + ".json";
+    std::string compiledRelative = "maps/" + mapName + ".imapc";
+
+    if (FSFileViewPtr compiled = FS_OpenMapped(compiledRelative)) {
+        // A loose JSON source edited after the last compile wins over the stale binary
+        // (packed files have no timestamps and are taken as built together)
+        std::string compiledPath = FS_ResolvePath(compiledRelative);
+        std::string jsonPath = FS_ResolvePath(jsonRelative);
+        std::error_code ec;
+        bool stale = !compiledPath.empty() && !jsonPath.empty() &&
+            std::filesystem::last_write_time(jsonPath, ec) > std::filesystem::last_write_time(compiledPath, ec);
+
+        if (stale) {
+            std::cerr << "[Engine] Compiled map is older than its JSON source, ignoring: " << compiledPath << "\n";
+        } else if (LoadCompiledMap(std::move(compiled), compiledRelative)) {
+            return true;
+        } else {
+            std::cerr << "[Engine] Compiled map unusable, falling back to JSON: " << compiledRelative << "\n";
+        }
+    }
+
+    FSFileViewPtr jsonFile = FS_OpenMapped(jsonRelative);
+    if (!jsonFile) {
+        std::cerr << "[Engine] Map not found: " << jsonRelative << "\n";
+        return false;
+    }
+
+    return LoadJSONMap(*jsonFile);
+}
+
+//-----------------------------------------------------------------------------
+// Launcher arguments: called before Engine_Run
+//-----------------------------------------------------------------------------
+DLL_EXPORT void STDCALL Engine_SetCommandLine(int argc, char** argv) {
+    g_Options = EngineOptions();
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-nullrender") {
+            g_Options.nullRender = true;
+        } else if (arg == "-norenderthread") {
+            g_Options.noRenderThread = true;
+        } else if (arg == "-rendercmdlog" && i + 1 < argc) {
+            g_Options.renderCommandLog = argv[++i];
+        } else if (arg == "-benchframes" && i + 1 < argc) {
+            g_Options.benchFrames = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "-uploadbudget" && i + 1 < argc) {
+            g_Options.uploadBudgetBytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i]))) * 1024;
+        } else if (arg == "-uploadms" && i + 1 < argc) {
+            g_Options.uploadBudgetMs = std::max(0.0, std::atof(argv[++i]));
+        }
+    }
+
+    if (!g_Options.renderCommandLog.empty() && !g_Options.nullRender)
+        std::cerr << "[Engine] -rendercmdlog needs -nullrender, ignoring it\n";
+}
+
 //-----------------------------------------------------------------------------
 // Initialize SDL, window, input, and ShaderAPI
 //-----------------------------------------------------------------------------
 DLL_EXPORT void STDCALL Engine_Init() {
     SDL_SetMainReady();
 
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
+    // ShaderAPI reads its shader sources through the filesystem
+    if (!LoadFileSystem()) {
+        std::cerr << "[Engine] Failed to load filesystem\n";
+        return;
+    }
+
+    // Cooked models are cached under the game directory
+    GetModelCache().Init(FS_OpenMapped, FS_GetGameDir());
+
+    g_RendererConfig = RendererConfig();
+    g_RendererConfig.renderThread = !g_Options.noRenderThread;
+    g_RendererConfig.uploadBudgetBytes = g_Options.uploadBudgetBytes;
+    g_RendererConfig.uploadBudgetMs = g_Options.uploadBudgetMs;
+    if (g_Options.nullRender) {
+        g_RendererConfig.backend = RenderBackendType::Null;
+        g_RendererConfig.commandLogPath = g_Options.renderCommandLog;
+        g_RendererConfig.renderThread = false;  // See RendererConfig::renderThread
+    }
+
+    // Headless runs need events and timers only, no video driver
+    const Uint32 sdlFlags = g_Options.nullRender ? (SDL_INIT_EVENTS | SDL_INIT_TIMER) : (SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    if (SDL_Init(sdlFlags) != 0) {
         std::cerr << "[Engine] SDL_Init failed: " << SDL_GetError() << "\n";
         return;
     }
 
+    if (g_Options.nullRender) {
+        if (!Renderer_LoadAndInit(nullptr, FS_OpenMapped, g_RendererConfig)) {
+            std::cerr << "[Engine] Failed to initialize Renderer\n";
+            Engine_Shutdown();
+            return;
+        }
+        g_Input.Init();
+        std::cout << "[Engine] SDL + null renderer initialized (headless)\n";
+        return;
+    }
+
     g_Window = SDL_CreateWindow(
         "INC Engine",
         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -174,7 +306,7 @@ DLL_EXPORT void STDCALL Engine_Init() {
     SDL_ShowCursor(SDL_DISABLE);
 
 	// RendererAPI
-	if (!Renderer_LoadAndInit(g_Window)) {
+	if (!Renderer_LoadAndInit(g_Window, FS_OpenMapped, g_RendererConfig)) {
 		std::cerr << "[Engine] Failed to initialize Renderer\n";
 		Engine_Shutdown();
 		return;
@@ -194,13 +326,39 @@ void UpdateInputAndCamera(float deltaTime);
 void RenderFrame(float deltaTime);
 
 DLL_EXPORT bool STDCALL Engine_RunFrame(float deltaTime) {
-    if (!HandleEvents()) return false;
+    {
+        PROFILE_SCOPE("HandleEvents");
+        if (!HandleEvents()) return false;
+    }
 
-    UpdateInputAndCamera(deltaTime);
+    {
+        PROFILE_SCOPE("UpdateInputAndCamera");
+        UpdateInputAndCamera(deltaTime);
+    }
 
-    g_Player.Update(deltaTime, g_Input);
+    {
+        PROFILE_SCOPE("Player::Update");
+        g_Player.Update(deltaTime, g_Input);
+    }
 
-    RenderFrame(deltaTime);
+    {
+        // Recenter the render origin on the player when they stray too far (amortized rebase)
+        PROFILE_SCOPE("FloatingOrigin");
+        g_CameraManager.UpdateFloatingOrigin(g_CameraManager.GetCamera_d().GetPosition());
+    }
+
+    {
+        // Queue/activate/drop universe sectors around the camera
+        PROFILE_SCOPE("SectorStreamer::Update");
+        GetSectorStreamer().Update(g_CameraManager.GetCamera_d().GetPosition());
+    }
+
+    {
+        PROFILE_SCOPE("RenderFrame");
+        RenderFrame(deltaTime);
+    }
+
+    PROFILE_END_FRAME();
 
     return true;
 }
@@ -214,6 +372,16 @@ bool HandleEvents() {
         }
     }
     g_Input.Update();
+
+#ifdef INC_PROFILER_ENABLED
+    // F9: write the next 300 frames to logs/profile_*.json
+    static bool captureKeyWasDown = false;
+    const bool captureKeyDown = g_Input.GetKeyState()[SDL_SCANCODE_F9] != 0;
+    if (captureKeyDown && !captureKeyWasDown)
+        PROFILE_CAPTURE(300);
+    captureKeyWasDown = captureKeyDown;
+#endif
+
     return true;
 }
 
@@ -238,8 +406,9 @@ void UpdateInputAndCamera(float deltaTime) {
 }
 
 void RenderFrame(float deltaTime) {
-    int width, height;
-    SDL_GetWindowSize(g_Window, &width, &height);
+    int width = g_RendererConfig.width, height = g_RendererConfig.height;
+    if (g_Window)
+        SDL_GetWindowSize(g_Window, &width, &height);
 
     static float totalTime = 0.0f;
     totalTime += deltaTime;
@@ -247,14 +416,26 @@ void RenderFrame(float deltaTime) {
     Matrix4x4_f viewMatrix = g_CameraManager.GetLocalViewMatrix();
     Matrix4x4_f projMatrix = Matrix4x4_f::Perspective(70.0f, (float)width / height, 0.01f, 1000.0f);
 
-    Renderer_RenderFrame(viewMatrix, projMatrix, totalTime);
+    if (g_CameraManager.IsCameraRelative()) {
+        Vector3_d cameraPosition = g_CameraManager.GetRenderOrigin();
+        Renderer_RenderFrame(viewMatrix, projMatrix, totalTime, &cameraPosition);
+    } else {
+        Renderer_RenderFrame(viewMatrix, projMatrix, totalTime);
+    }
 }
 
 //-----------------------------------------------------------------------------
 // Engine Shutdown: Cleanup SDL + Renderer + DLL
 //-----------------------------------------------------------------------------
 DLL_EXPORT void STDCALL Engine_Shutdown() {
-	
+
+	// GPU meshes must be released while the render backend still exists
+	GetSectorStreamer().Shutdown();
+	ClearStaticGeometry();
+	GetMeshCache().Clear();
+	GetModelCache().Clear();
+	GetFloatingOriginManager().Clear();
+
 	Renderer_Unload();
 
     if (g_Window) {
@@ -275,11 +456,64 @@ DLL_EXPORT void STDCALL Engine_Shutdown() {
     std::cout << "[Engine] Shutdown complete\n";
 }
 
+//-----------------------------------------------------------------------------
+// Benchmark loop (-benchframes): fixed 1/60 s steps so runs are comparable,
+// no yielding, CPU frame times plus render counters to the log at the end
+//-----------------------------------------------------------------------------
+static void RunBenchmark(uint32_t frameCount) {
+    constexpr float BENCH_DELTA_TIME = 1.0f / 60.0f;
+
+    std::vector<float> frameMs;
+    frameMs.reserve(frameCount);
+    const double ticksToMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    const Uint64 benchStart = SDL_GetPerformanceCounter();
+    for (uint32_t frame = 0; frame < frameCount; ++frame) {
+        const Uint64 frameStart = SDL_GetPerformanceCounter();
+        const bool keepRunning = Engine_RunFrame(BENCH_DELTA_TIME);
+        frameMs.push_back(static_cast<float>((SDL_GetPerformanceCounter() - frameStart) * ticksToMs));
+
+        if (!keepRunning) {
+            std::cout << "[Engine] Engine_RunFrame returned false, ending benchmark\n";
+            break;
+        }
+    }
+    const double totalMs = (SDL_GetPerformanceCounter() - benchStart) * ticksToMs;
+
+    if (frameMs.empty())
+        return;
+    std::vector<float> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+    ENGINE_LOG_INFO(Engine, "[Bench] %zu frames in %.1f ms: avg %.3f, min %.3f, median %.3f, p99 %.3f, max %.3f ms",
+              n, totalMs, totalMs / n, sorted.front(), sorted[n / 2], sorted[std::min(n - 1, n * 99 / 100)], sorted.back());
+
+    const RendererStateTotals state = Renderer_GetStateTotals();
+    if (state.frames > 0) {
+        const double frames = static_cast<double>(state.frames);
+        const double calls = static_cast<double>(std::max<uint64_t>(state.issued + state.filtered, 1));
+        ENGINE_LOG_INFO(Engine, "[Bench] State changes per frame: %.1f issued, %.1f filtered (%.0f%% redundant)",
+                  state.issued / frames, state.filtered / frames, 100.0 * state.filtered / calls);
+    }
+
+    if (const NullRenderStats* stats = Renderer_GetNullRenderStats()) {
+        const double frames = static_cast<double>(std::max<uint64_t>(stats->frames, 1));
+        ENGINE_LOG_INFO(Engine, "[Bench] Per frame: %.1f draw calls, %.1f instances, %.0f triangles, %.1f skipped, "
+                  "%.1f matrix sets, %.1f state changes",
+                  stats->drawCalls / frames, stats->instances / frames, stats->triangles / frames,
+                  stats->skippedDraws / frames, stats->matrixChanges / frames, stats->stateChanges / frames);
+        ENGINE_LOG_INFO(Engine, "[Bench] Meshes: %llu created, %llu destroyed, %llu uploads (%llu bytes)",
+                  (unsigned long long)stats->meshesCreated, (unsigned long long)stats->meshesDestroyed,
+                  (unsigned long long)stats->meshUploads, (unsigned long long)stats->uploadBytes);
+    }
+    std::cout << "[Engine] Benchmark finished: " << n << " frames, avg " << totalMs / n << " ms (see logs/engine.log)\n";
+}
+
 //-----------------------------------------------------------------------------
 // Engine Main entrypoint: Init, load filesystem and map, run main loop
 //-----------------------------------------------------------------------------
 DLL_EXPORT void STDCALL Engine_Run() {
-    InitEngineLog();
+    EngineLogScope logScope;
     std::cout << "[Engine] Starting Engine_Run\n";
 
     Engine_Init();
@@ -291,36 +525,49 @@ DLL_EXPORT void STDCALL Engine_Run() {
 
     if (!LoadMap("start")) {
         std::cerr << "[Engine] Failed to load start map\n";
+        Engine_Shutdown();
         return;
     }
 
+    GetSectorStreamer().Init(FS_OpenMapped, FS_ReadAsync, FS_CancelAsync);
+
     std::cout << "[Engine] Entering main loop\n";
+    PROFILE_THREAD_NAME("Main");
 
-    Uint64 now = SDL_GetPerformanceCounter();
-    Uint64 last = 0;
-    double deltaTime = 0.0;
+    if (g_Options.benchFrames > 0) {
+        RunBenchmark(g_Options.benchFrames);
+    } else {
+        Uint64 now = SDL_GetPerformanceCounter();
+        Uint64 last = 0;
+        double deltaTime = 0.0;
 
-    while (true) {
-        last = now;
-        now = SDL_GetPerformanceCounter();
+        while (true) {
+            last = now;
+            now = SDL_GetPerformanceCounter();
 
-        // Convert performance counter difference to milliseconds
-        deltaTime = (double)((now - last) * 1000 / (double)SDL_GetPerformanceFrequency());
+            // Convert performance counter difference to milliseconds
+            deltaTime = (double)((now - last) * 1000 / (double)SDL_GetPerformanceFrequency());
 
-        // Run one frame (deltaTime converted to seconds)
-        bool keepRunning = Engine_RunFrame(static_cast<float>(deltaTime / 1000.0f));
+            // Run one frame (deltaTime converted to seconds)
+            bool keepRunning = Engine_RunFrame(static_cast<float>(deltaTime / 1000.0f));
 
-        if (!keepRunning) {
-            std::cout << "[Engine] Engine_RunFrame returned false, exiting loop\n";
-            break;
-        }
+            if (!keepRunning) {
+                std::cout << "[Engine] Engine_RunFrame returned false, exiting loop\n";
+                break;
+            }
 
-        // Yield CPU briefly
-        SDL_Delay(1);
+            // Yield CPU briefly; with a render thread, publishing the frame already paces the loop
+            if (!Renderer_IsThreaded())
+                SDL_Delay(1);
+        }
     }
 
+    PROFILE_LOG_STATS();
+
+    // Joins the render thread before the launcher unloads this DLL
+    Engine_Shutdown();
+
     EngineLog("[Engine] Shutdown complete");
-    EngineLog_Shutdown();
 }
 
 //-----------------------------------------------------------------------------
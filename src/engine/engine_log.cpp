@@ -1,31 +1,363 @@
 #include "engine_log.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
 #include <cstdio>
+#include <cstring>
+#include <exception>
 #include <filesystem>
-#include <mutex>
+#include <memory>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//-----------------------------------------------------------------------------
+// Record ring (bounded MPSC, per-slot sequence numbers)
+//-----------------------------------------------------------------------------
+static constexpr uint32_t LOG_RING_CAPACITY = 4096;     // Power of two
+static constexpr uint32_t LOG_RING_MASK = LOG_RING_CAPACITY - 1;
+static constexpr size_t LOG_RECORD_TEXT = 496;          // Longer lines are truncated
+
+struct LogRecord {
+    std::atomic<uint32_t> sequence;
+    LogLevel level;
+    uint16_t length;
+    double time;                    // Seconds since EngineLog_Init
+    char text[LOG_RECORD_TEXT];
+};
+
+#ifdef DEBUG
+static constexpr uint8_t LOG_DEFAULT_LEVEL = static_cast<uint8_t>(LogLevel::Debug);
+#else
+static constexpr uint8_t LOG_DEFAULT_LEVEL = static_cast<uint8_t>(LogLevel::Info);
+#endif
+
+std::atomic<uint8_t> g_EngineLogLevels[static_cast<size_t>(LogCategory::Count)] = {
+    { LOG_DEFAULT_LEVEL }, { LOG_DEFAULT_LEVEL }, { LOG_DEFAULT_LEVEL },
+    { LOG_DEFAULT_LEVEL }, { LOG_DEFAULT_LEVEL }, { LOG_DEFAULT_LEVEL }
+};
+static_assert(static_cast<size_t>(LogCategory::Count) == 6, "update g_EngineLogLevels' initializer");
+
+static std::unique_ptr<LogRecord[]> s_Ring;
+static std::atomic<uint32_t> s_EnqueuePos{ 0 };
+static uint32_t s_DequeuePos = 0;                       // Owned by whoever holds s_Consuming
 
 static FILE* s_LogFile = nullptr;
-static std::mutex s_LogMutex;
+static std::atomic<bool> s_Running{ false };
+static std::atomic<uint32_t> s_Producers{ 0 };           // Inside EngineLog_WriteV; Shutdown waits for zero
+static std::atomic<bool> s_Quit{ false };
+static std::atomic_flag s_Consuming = ATOMIC_FLAG_INIT; // Single-consumer lock: writer, Flush or crash handler
+static std::thread s_Writer;
+static std::chrono::steady_clock::time_point s_StartTime;
+
+static const char LEVEL_CHARS[] = { 'D', 'I', 'W', 'E' };
+
+// Writes out every published record. Caller holds s_Consuming.
+static size_t DrainLocked() {
+    size_t written = 0;
+    for (;;) {
+        LogRecord& record = s_Ring[s_DequeuePos & LOG_RING_MASK];
+        if (record.sequence.load(std::memory_order_acquire) != s_DequeuePos + 1)
+            break; // Empty, or the producer is still writing this slot
 
+        fprintf(s_LogFile, "%9.3f %c ", record.time, LEVEL_CHARS[static_cast<size_t>(record.level)]);
+        fwrite(record.text, 1, record.length, s_LogFile);
+        fputc('\n', s_LogFile);
+
+        record.sequence.store(s_DequeuePos + LOG_RING_CAPACITY, std::memory_order_release);
+        ++s_DequeuePos;
+        ++written;
+    }
+    if (written)
+        fflush(s_LogFile);
+    return written;
+}
+
+static void WriterMain() {
+    while (!s_Quit.load(std::memory_order_acquire)) {
+        size_t written = 0;
+        if (!s_Consuming.test_and_set(std::memory_order_acquire)) {
+            written = DrainLocked();
+            s_Consuming.clear(std::memory_order_release);
+        }
+        if (written == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+static void DrainNow() {
+    if (!s_LogFile)
+        return;
+
+    while (s_Consuming.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+    DrainLocked();
+    s_Consuming.clear(std::memory_order_release);
+}
+
+// Claims the next ring slot. When the ring is full, waits for the writer if
+// 'wait' is set, otherwise gives up and returns nullptr.
+static LogRecord* ClaimSlot(bool wait, uint32_t& pos) {
+    pos = s_EnqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        LogRecord* record = &s_Ring[pos & LOG_RING_MASK];
+        const uint32_t sequence = record->sequence.load(std::memory_order_acquire);
+        const int32_t diff = static_cast<int32_t>(sequence - pos);
+        if (diff == 0) {
+            if (s_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return record;
+        } else if (diff < 0) {
+            if (!wait)
+                return nullptr;
+            std::this_thread::yield();
+            pos = s_EnqueuePos.load(std::memory_order_relaxed);
+        } else {
+            pos = s_EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static double SecondsSinceStart() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - s_StartTime).count();
+}
+
+//-----------------------------------------------------------------------------
+// Crash handlers: get the tail of the log onto disk before the process dies.
+// This path may run inside a signal handler, so it sticks to lock-free atomics,
+// memcpy and raw write(): no stdio, no allocation, no waiting on other threads.
+//-----------------------------------------------------------------------------
+static std::terminate_handler s_PreviousTerminate = nullptr;
+
+#ifdef _WIN32
+#define LOG_RAW_WRITE(fd, data, size) _write(fd, data, static_cast<unsigned int>(size))
+#define LOG_FILENO _fileno
+#else
+#define LOG_RAW_WRITE(fd, data, size) write(fd, data, size)
+#define LOG_FILENO fileno
+#endif
+
+// Same line layout as DrainLocked ("%9.3f %c text"), formatted by hand
+static size_t FormatCrashPrefix(char* out, double time, LogLevel level) {
+    const uint64_t millis = time > 0.0 ? static_cast<uint64_t>(time * 1000.0 + 0.5) : 0;
+    char digits[24];
+    size_t count = 0;
+    uint64_t whole = millis / 1000;
+    do {
+        digits[count++] = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole && count < sizeof(digits));
+
+    size_t length = 0;
+    for (size_t pad = count + 4; pad < 9; ++pad)
+        out[length++] = ' ';
+    while (count)
+        out[length++] = digits[--count];
+    out[length++] = '.';
+    out[length++] = static_cast<char>('0' + millis / 100 % 10);
+    out[length++] = static_cast<char>('0' + millis / 10 % 10);
+    out[length++] = static_cast<char>('0' + millis % 10);
+    out[length++] = ' ';
+    out[length++] = LEVEL_CHARS[static_cast<size_t>(level)];
+    out[length++] = ' ';
+    return length;
+}
+
+// DrainLocked without stdio. Whoever released s_Consuming last flushed the FILE
+// buffer first, so writing to the descriptor directly keeps lines in order.
+static void DrainLockedRaw() {
+    const int fd = LOG_FILENO(s_LogFile);
+    char prefix[48];
+    for (;;) {
+        LogRecord& record = s_Ring[s_DequeuePos & LOG_RING_MASK];
+        if (record.sequence.load(std::memory_order_acquire) != s_DequeuePos + 1)
+            break;
+
+        const size_t prefixLength = FormatCrashPrefix(prefix, record.time, record.level);
+        LOG_RAW_WRITE(fd, prefix, prefixLength);
+        LOG_RAW_WRITE(fd, record.text, record.length);
+        LOG_RAW_WRITE(fd, "\n", 1);
+
+        record.sequence.store(s_DequeuePos + LOG_RING_CAPACITY, std::memory_order_release);
+        ++s_DequeuePos;
+    }
+}
+
+static void CrashFlush(const char* reason) {
+    if (!s_Running.load(std::memory_order_acquire))
+        return;
+
+    // Never waits for room: the crashing thread may be the writer itself
+    uint32_t pos;
+    if (LogRecord* record = ClaimSlot(false, pos)) {
+        static const char SUFFIX[] = ", flushing log";
+        const size_t reasonLength = std::min(strlen(reason), LOG_RECORD_TEXT - sizeof(SUFFIX));
+        std::memcpy(record->text, reason, reasonLength);
+        std::memcpy(record->text + reasonLength, SUFFIX, sizeof(SUFFIX) - 1);
+        record->length = static_cast<uint16_t>(reasonLength + sizeof(SUFFIX) - 1);
+        record->level = LogLevel::Error;
+        record->time = SecondsSinceStart();
+        record->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    // If the consumer lock stays taken, its owner is either still running and
+    // will write the lines itself, or is the thread that crashed inside it
+    for (uint32_t spins = 0; s_Consuming.test_and_set(std::memory_order_acquire); ++spins) {
+        if (spins >= 100000)
+            return;
+    }
+    DrainLockedRaw();
+    s_Consuming.clear(std::memory_order_release);
+}
+
+static void OnTerminate() {
+    CrashFlush("std::terminate");
+    if (s_PreviousTerminate)
+        s_PreviousTerminate();
+    std::abort();
+}
+
+static void OnFatalSignal(int sig) {
+    CrashFlush(sig == SIGSEGV ? "SIGSEGV" : sig == SIGABRT ? "SIGABRT" : sig == SIGFPE ? "SIGFPE" : "SIGILL");
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+
+#ifdef _WIN32
+static LPTOP_LEVEL_EXCEPTION_FILTER s_PreviousFilter = nullptr;
+
+static LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* info) {
+    char reason[64];
+    snprintf(reason, sizeof(reason), "Unhandled exception 0x%08lX",
+             info && info->ExceptionRecord ? static_cast<unsigned long>(info->ExceptionRecord->ExceptionCode) : 0ul);
+    CrashFlush(reason);
+    return s_PreviousFilter ? s_PreviousFilter(info) : EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+
+static void InstallCrashHandlers() {
+    s_PreviousTerminate = std::set_terminate(OnTerminate);
+    std::signal(SIGSEGV, OnFatalSignal);
+    std::signal(SIGABRT, OnFatalSignal);
+    std::signal(SIGFPE, OnFatalSignal);
+    std::signal(SIGILL, OnFatalSignal);
+#ifdef _WIN32
+    s_PreviousFilter = SetUnhandledExceptionFilter(OnUnhandledException);
+#endif
+}
+
+static void RemoveCrashHandlers() {
+    std::set_terminate(s_PreviousTerminate);
+    std::signal(SIGSEGV, SIG_DFL);
+    std::signal(SIGABRT, SIG_DFL);
+    std::signal(SIGFPE, SIG_DFL);
+    std::signal(SIGILL, SIG_DFL);
+#ifdef _WIN32
+    SetUnhandledExceptionFilter(s_PreviousFilter);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
 void EngineLog_Init(const char* filename) {
+    if (s_Running.load(std::memory_order_acquire))
+        return;
+
     std::filesystem::create_directories("logs");
     s_LogFile = fopen(filename, "w");
+    if (!s_LogFile)
+        return;
+    setvbuf(s_LogFile, nullptr, _IOFBF, 64 * 1024);
+
+    s_Ring.reset(new LogRecord[LOG_RING_CAPACITY]);
+    for (uint32_t i = 0; i < LOG_RING_CAPACITY; ++i)
+        s_Ring[i].sequence.store(i, std::memory_order_relaxed);
+    s_EnqueuePos.store(0, std::memory_order_relaxed);
+    s_DequeuePos = 0;
+
+    s_StartTime = std::chrono::steady_clock::now();
+    s_Quit.store(false, std::memory_order_relaxed);
+    s_Running.store(true, std::memory_order_release);
+    s_Writer = std::thread(WriterMain);
+    InstallCrashHandlers();
 }
 
 void EngineLog_Shutdown() {
-    if (s_LogFile) {
-        fclose(s_LogFile);
-        s_LogFile = nullptr;
+    if (!s_Running.exchange(false))
+        return;
+
+    // Producers that got past the s_Running check still own slots; the writer
+    // keeps draining so a full ring can't hold them up
+    while (s_Producers.load() != 0)
+        std::this_thread::yield();
+
+    RemoveCrashHandlers();
+    s_Quit.store(true, std::memory_order_release);
+    if (s_Writer.joinable())
+        s_Writer.join();
+
+    DrainNow();
+    fclose(s_LogFile);
+    s_LogFile = nullptr;
+    s_Ring.reset();
+}
+
+void EngineLog_Flush() {
+    if (s_Running.load(std::memory_order_acquire))
+        DrainNow();
+}
+
+// Category filtering already happened in the caller (ENGINE_LOG_*)
+void EngineLog_WriteV(LogCategory /*category*/, LogLevel level, const char* fmt, va_list args) {
+    // Registered before s_Running is checked (both sequentially consistent), so
+    // Shutdown either sees this producer or this producer sees Shutdown
+    s_Producers.fetch_add(1);
+    if (!s_Running.load()) {
+        s_Producers.fetch_sub(1, std::memory_order_release);
+        return;
     }
+
+    // When the ring is full, wait for the writer instead of dropping the line
+    uint32_t pos;
+    LogRecord* record = ClaimSlot(true, pos);
+
+    const int length = vsnprintf(record->text, LOG_RECORD_TEXT, fmt, args);
+    record->length = static_cast<uint16_t>(length < 0 ? 0 : std::min<size_t>(length, LOG_RECORD_TEXT - 1));
+    if (length >= static_cast<int>(LOG_RECORD_TEXT))
+        std::memcpy(record->text + LOG_RECORD_TEXT - 4, "...", 3);
+    record->level = level;
+    record->time = SecondsSinceStart();
+
+    record->sequence.store(pos + 1, std::memory_order_release);
+    s_Producers.fetch_sub(1, std::memory_order_release);
+}
+
+void EngineLog_Write(LogCategory category, LogLevel level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    EngineLog_WriteV(category, level, fmt, args);
+    va_end(args);
 }
 
 void EngineLog(const char* fmt, ...) {
-    if (!s_LogFile) return;
-    std::lock_guard<std::mutex> lock(s_LogMutex);
+    if (!EngineLog_IsEnabled(LogCategory::General, LogLevel::Info))
+        return;
 
     va_list args;
     va_start(args, fmt);
-    vfprintf(s_LogFile, fmt, args);
-    fprintf(s_LogFile, "\n");
-    fflush(s_LogFile);
+    EngineLog_WriteV(LogCategory::General, LogLevel::Info, fmt, args);
     va_end(args);
-}
\ No newline at end of file
+}
+
+void EngineLog_SetLevel(LogCategory category, LogLevel minLevel) {
+    g_EngineLogLevels[static_cast<size_t>(category)].store(static_cast<uint8_t>(minLevel), std::memory_order_relaxed);
+}
+
+LogLevel EngineLog_GetLevel(LogCategory category) {
+    return static_cast<LogLevel>(g_EngineLogLevels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+}
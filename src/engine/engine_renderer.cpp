@@ -1,6 +1,18 @@
 #include "engine_renderer.h"
+#include "null_render_backend.h"
+#include "render_command_buffer.h"
+#include "render_snapshot.h"
 #include "world/static_mesh_loader.h" // For GetStaticGeometry()
+#include "floating_origin_manager.h"
+#include "mathlib/vector3_batch.h"
+#include "profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <Windows.h>
 
 static HMODULE g_ShaderAPIDLL = nullptr;
@@ -12,14 +24,281 @@ static DestroyGPUAPI_t pDestroyGPUAPI = nullptr;
 
 
 static IGPURenderInterface* s_pGPURender = nullptr;
+static std::unique_ptr<NullRenderBackend> s_NullRender;    // Owned here; the GL backend is owned by shaderapi.dll
 static SDL_Window* s_Window = nullptr;
+static int s_Width = 1280;      // Used when there is no window
+static int s_Height = 720;
+
+// Frames go from the main thread to the renderer as snapshots. With a render thread,
+// the backend (and for GL, its context) is initialized, used and shut down on that
+// thread only; the main thread just creates meshes and publishes snapshots.
+static RenderMailbox s_Mailbox;
+static std::thread s_RenderThread;
+static uint64_t s_SnapshotFrame = 0;
+static bool s_FlushUploadsRequested = false;    // Main thread; rides along with the next snapshot
+
+// GetStateStats() of each frame, summed on the drawing thread for whoever asks
+static std::atomic<uint64_t> s_StateFrames{ 0 };
+static std::atomic<uint64_t> s_StateIssued{ 0 };
+static std::atomic<uint64_t> s_StateFiltered{ 0 };
+
+// Static geometry, grouped by mesh with a small per-mesh id for the render sort keys.
+// Model matrices hold each instance's rotation/scale plus a float translation relative
+// to the frame's render origin:
+//  - floating origin: FloatingOriginManager's local cache, refreshed when the origin commits
+//  - camera-relative: world positions (draw order, double) minus the camera, one batched
+//    ToLocal sweep per frame
+static std::vector<const StaticMeshInstance*> s_StaticDrawOrder;
+static std::vector<uint32_t> s_StaticMeshIds;
+static std::vector<Matrix4x4_f> s_StaticModelMatrices;
+static Vector3Batch_d s_StaticWorldPositions;
+static Vector3Batch_f s_StaticRelativePositions;
+static unsigned int s_StaticDrawListRevision = ~0u;
+static unsigned int s_StaticOriginRevision = ~0u;
+
+// Everything drawn this frame, sorted by key before it goes to the backend (render thread)
+static RenderCommandBuffer s_Commands;
+static const char* const GPU_PASS_NAMES[] = { "GPU::Background", "GPU::Opaque" };
+static_assert(sizeof(GPU_PASS_NAMES) / sizeof(GPU_PASS_NAMES[0]) == static_cast<size_t>(RenderPass::Count),
+              "Every render pass needs a GPU pass name");
+
+// GPU pass timing rides on the profiler: built in exactly when CPU scopes are
+#ifdef INC_PROFILER_ENABLED
+class ScopedGPUPass {
+public:
+    ScopedGPUPass(IGPURenderInterface* gpu, const char* name) : m_GPU(gpu) { m_GPU->BeginPass(name); }
+    ~ScopedGPUPass() { m_GPU->EndPass(); }
+
+private:
+    IGPURenderInterface* m_GPU;
+};
+#define GPU_PASS(name) ScopedGPUPass PROFILE_CONCAT(_gpuPass, __LINE__)(s_pGPURender, name)
+
+static void SubmitGPUPassTimings() {
+    const GPUPassTiming* timings = nullptr;
+    const size_t count = s_pGPURender->GetPassTimings(&timings);
+    for (size_t i = 0; i < count; ++i)
+        Profiler_RecordGPU(timings[i].name, timings[i].cpuStartNs, timings[i].gpuNs);
+}
+#else
+#define GPU_PASS(name) ((void)0)
+static void SubmitGPUPassTimings() {}
+#endif
+
+static void RebuildStaticDrawListIfNeeded() {
+    if (s_StaticDrawListRevision == GetStaticGeometryRevision())
+        return;
+
+    const FloatingOriginManager& origin = GetFloatingOriginManager();
+    const auto& staticGeometry = GetStaticGeometry();
+    s_StaticDrawOrder.clear();
+    s_StaticDrawOrder.reserve(staticGeometry.size());
+    for (const auto& instance : staticGeometry)
+        s_StaticDrawOrder.push_back(&instance);
+
+    std::stable_sort(s_StaticDrawOrder.begin(), s_StaticDrawOrder.end(),
+        [](const StaticMeshInstance* a, const StaticMeshInstance* b) { return a->mesh < b->mesh; });
+
+    const size_t count = s_StaticDrawOrder.size();
+    s_StaticModelMatrices.resize(count);
+    s_StaticWorldPositions.Resize(count);
+    s_StaticRelativePositions.Resize(count);
+    s_StaticMeshIds.resize(count);
+    uint32_t meshId = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const StaticMeshInstance& instance = *s_StaticDrawOrder[i];
+        s_StaticModelMatrices[i] = instance.transform;
+        s_StaticWorldPositions.Set(i, origin.GetWorldPosition(instance.originHandle));
+        if (i > 0 && instance.mesh != s_StaticDrawOrder[i - 1]->mesh)
+            ++meshId;
+        s_StaticMeshIds[i] = meshId;
+    }
+
+    s_StaticDrawListRevision = GetStaticGeometryRevision();
+    s_StaticOriginRevision = ~0u;
+}
+
+static void UpdateStaticTranslations(const Vector3_d* cameraPosition) {
+    const size_t count = s_StaticDrawOrder.size();
+
+    if (cameraPosition) {
+        s_StaticWorldPositions.ToLocal(*cameraPosition, s_StaticRelativePositions, 0, count);
+        s_StaticOriginRevision = ~0u; // Refresh if we drop back to floating-origin mode
+    } else {
+        const FloatingOriginManager& origin = GetFloatingOriginManager();
+        if (s_StaticOriginRevision == origin.GetOriginRevision())
+            return;
+        for (size_t i = 0; i < count; ++i)
+            s_StaticRelativePositions.Set(i, origin.GetLocalPosition(s_StaticDrawOrder[i]->originHandle));
+        s_StaticOriginRevision = origin.GetOriginRevision();
+    }
+
+    const float* x = s_StaticRelativePositions.X();
+    const float* y = s_StaticRelativePositions.Y();
+    const float* z = s_StaticRelativePositions.Z();
+    for (size_t i = 0; i < count; ++i) {
+        Matrix4x4_f& model = s_StaticModelMatrices[i];
+        model[3][0] = x[i];
+        model[3][1] = y[i];
+        model[3][2] = z[i];
+    }
+}
+
+// Main thread: copy what the frame draws into the mailbox's write slot. Meshes and
+// mesh ids only change with the draw list, so each slot re-copies them only when
+// it last saw an older revision; the matrices are copied every frame.
+static void FillSnapshot(RenderSnapshot& snapshot, const Matrix4x4_f& viewMatrix, const Matrix4x4_f& projMatrix,
+                         float totalTime, int width, int height) {
+    snapshot.frame = s_SnapshotFrame++;
+    snapshot.viewMatrix = viewMatrix;
+    snapshot.projMatrix = projMatrix;
+    snapshot.time = totalTime;
+    snapshot.width = width;
+    snapshot.height = height;
+    snapshot.flushUploads = s_FlushUploadsRequested;
+    s_FlushUploadsRequested = false;
+
+    if (snapshot.drawListRevision != s_StaticDrawListRevision) {
+        snapshot.meshes.clear();
+        for (size_t i = 0; i < s_StaticDrawOrder.size(); ++i) {
+            if (i == 0 || s_StaticMeshIds[i] != s_StaticMeshIds[i - 1])
+                snapshot.meshes.push_back(s_StaticDrawOrder[i]->mesh);
+        }
+        snapshot.instanceMeshIds = s_StaticMeshIds;
+        snapshot.drawListRevision = s_StaticDrawListRevision;
+    }
+    snapshot.instanceMatrices = s_StaticModelMatrices;
+}
+
+// One opaque mesh command per static instance, depth keyed front to back
+static void AddStaticCommands(const RenderSnapshot& snapshot) {
+    const Matrix4x4_f& viewMatrix = snapshot.viewMatrix;
+    const size_t count = snapshot.instanceMatrices.size();
+    s_Commands.Reserve(s_Commands.GetCount() + count);
+    for (size_t i = 0; i < count; ++i) {
+        const Matrix4x4_f& model = snapshot.instanceMatrices[i];
+        const uint32_t meshId = snapshot.instanceMeshIds[i];
+
+        // View-space z of the instance origin; the camera looks down -z
+        const float viewZ = viewMatrix[0][2] * model[3][0] + viewMatrix[1][2] * model[3][1] +
+                            viewMatrix[2][2] * model[3][2] + viewMatrix[3][2];
+        const uint64_t key = MakeRenderSortKey(RenderPass::Opaque, RenderShader::Mesh, 0, meshId,
+                                               MakeRenderDepth(-viewZ));
+        s_Commands.AddMesh(key, snapshot.meshes[meshId].get(), &model);
+    }
+}
+
+// Render thread (or the main thread when inline): one snapshot, start to swap
+static void DrawSnapshot(const RenderSnapshot& snapshot) {
+    {
+        PROFILE_SCOPE("Render::BeginFrame"); // Includes the mesh upload queue's budget
+        s_pGPURender->BeginFrame();
+        if (snapshot.flushUploads)
+            s_pGPURender->FlushUploads();
+        s_pGPURender->PrepareFrame(snapshot.width, snapshot.height);
+    }
+    SubmitGPUPassTimings(); // Resolved by BeginFrame, from a frame or two ago
+
+    const GPUStateStats stateStats = s_pGPURender->GetStateStats(); // Previous frame's
+    s_StateIssued.fetch_add(stateStats.issued, std::memory_order_relaxed);
+    s_StateFiltered.fetch_add(stateStats.filtered, std::memory_order_relaxed);
+    s_StateFrames.fetch_add(1, std::memory_order_relaxed);
+
+    // Scene traversal emits commands in any order; the sort groups them by pass, shader and mesh
+    {
+        PROFILE_SCOPE("Render::BuildCommands");
+        s_Commands.Clear();
+        s_Commands.AddStarfield(RenderPass::Background, snapshot.time);
+        AddStaticCommands(snapshot);
+    }
+    {
+        PROFILE_SCOPE("Render::SortCommands");
+        s_Commands.Sort();
+    }
+
+    s_pGPURender->SetViewMatrix(snapshot.viewMatrix);
+    s_pGPURender->SetProjectionMatrix(snapshot.projMatrix);
+    s_pGPURender->SetFrameTime(snapshot.time);
+
+    {
+        PROFILE_SCOPE("Render::ExecuteCommands");
+        for (size_t p = 0; p < static_cast<size_t>(RenderPass::Count); ++p) {
+            size_t first, count;
+            s_Commands.GetPassRange(static_cast<RenderPass>(p), first, count);
+            if (count == 0)
+                continue;
+            GPU_PASS(GPU_PASS_NAMES[p]);
+            s_pGPURender->ExecuteCommands(s_Commands.GetCommands() + first, count);
+        }
+    }
+
+    {
+        PROFILE_SCOPE("Render::SwapBuffers");
+        s_pGPURender->EndFrame();
+    }
+}
+
+static void RenderThreadMain(SDL_Window* window, int width, int height, std::promise<bool> initResult) {
+    PROFILE_THREAD_NAME("Render");
+
+    // The GL context is created here and stays current on this thread
+    const bool initialized = s_pGPURender->Init(window, width, height);
+    initResult.set_value(initialized);
+
+    if (initialized) {
+        while (const RenderSnapshot* snapshot = s_Mailbox.Acquire())
+            DrawSnapshot(*snapshot);
+    }
+
+    // The snapshots may hold the last references to meshes; release them while the
+    // backend can still delete their GPU objects
+    s_Mailbox.Reset();
+    s_Commands.Clear();
+    s_pGPURender->Shutdown();
+}
+
+// Inits the backend on the thread that will draw with it; on failure it is already shut down
+static bool StartBackend(SDL_Window* window, const RendererConfig& config) {
+    if (!config.renderThread) {
+        if (s_pGPURender->Init(window, config.width, config.height))
+            return true;
+        s_pGPURender->Shutdown();
+        return false;
+    }
+
+    std::promise<bool> initResult;
+    std::future<bool> initialized = initResult.get_future();
+    s_RenderThread = std::thread(RenderThreadMain, window, config.width, config.height, std::move(initResult));
+    if (initialized.get()) {
+        std::cout << "[Renderer] Rendering on a dedicated render thread\n";
+        return true;
+    }
+    s_RenderThread.join();
+    return false;
+}
 
 void Renderer_Init(IGPURenderInterface* gpuRender, SDL_Window* window) {
     s_pGPURender = gpuRender;
     s_Window = window;
 }
 
-bool Renderer_LoadAndInit(SDL_Window* window) {
+bool Renderer_LoadAndInit(SDL_Window* window, FSOpenMappedFn openFile, const RendererConfig& config) {
+    s_Width = config.width;
+    s_Height = config.height;
+
+    // Headless: nothing to load, the backend lives in the engine and draws inline
+    // whatever config.renderThread says (see RendererConfig)
+    if (config.backend == RenderBackendType::Null) {
+        s_NullRender = std::make_unique<NullRenderBackend>();
+        if (!config.commandLogPath.empty())
+            s_NullRender->OpenCommandLog(config.commandLogPath.c_str());
+        s_NullRender->Init(window, config.width, config.height);
+        std::cout << "[Renderer] Using null render backend (no GPU)\n";
+
+        Renderer_Init(s_NullRender.get(), window);
+        return true;
+    }
+
     g_ShaderAPIDLL = LoadLibraryA("bin/shaderapi.dll");
     if (!g_ShaderAPIDLL) {
         std::cerr << "[Renderer] Failed to load shaderapi.dll\n";
@@ -36,55 +315,78 @@ bool Renderer_LoadAndInit(SDL_Window* window) {
         return false;
     }
 
-    s_pGPURender = pCreateGPUAPI();
-    if (!s_pGPURender || !s_pGPURender->Init(window, 1280, 720)) {
+    // Set up before the render thread starts, which reads s_pGPURender from then on
+    IGPURenderInterface* gpuRender = pCreateGPUAPI();
+    if (gpuRender) {
+        gpuRender->SetFileSystem(openFile);
+        gpuRender->SetUploadBudget(config.uploadBudgetBytes, config.uploadBudgetMs);
+        Renderer_Init(gpuRender, window);
+    }
+    if (!gpuRender || !StartBackend(window, config)) {
         std::cerr << "[Renderer] Failed to initialize GPU backend!\n";
-        if (s_pGPURender) {
-            s_pGPURender->Shutdown();
-            s_pGPURender = nullptr;
-        }
+        s_pGPURender = nullptr;
+        s_Window = nullptr;
         FreeLibrary(g_ShaderAPIDLL);
         g_ShaderAPIDLL = nullptr;
         return false;
     }
-
-    Renderer_Init(s_pGPURender, window);
     return true;
 }
 
-void Renderer_RenderFrame(const Matrix4x4_f& viewMatrix, const Matrix4x4_f& projMatrix, float totalTime) {
+void Renderer_RenderFrame(const Matrix4x4_f& viewMatrix, const Matrix4x4_f& projMatrix, float totalTime,
+                          const Vector3_d* cameraPosition) {
     if (!s_pGPURender) return;
 
-    int width, height;
-    SDL_GetWindowSize(s_Window, &width, &height);
+    int width = s_Width, height = s_Height;
+    if (s_Window)
+        SDL_GetWindowSize(s_Window, &width, &height);
 
-    s_pGPURender->BeginFrame();
-    s_pGPURender->PrepareFrame(width, height);
-
-    // Starfield rendering
-    s_pGPURender->SetDepthMaskEnabled(false);
-    s_pGPURender->SetDepthTestEnabled(false);
-    s_pGPURender->RenderStarfield(totalTime);
-    s_pGPURender->SetDepthMaskEnabled(true);
-    s_pGPURender->SetDepthTestEnabled(true);
-
-    s_pGPURender->SetViewMatrix(viewMatrix);
-    s_pGPURender->SetProjectionMatrix(projMatrix);
-
-    // Render static geometry
-    const auto& staticGeometry = GetStaticGeometry();
-    for (const auto& instance : staticGeometry) {
-        s_pGPURender->DrawMesh(*instance.mesh, instance.transform);
+    {
+        PROFILE_SCOPE("Render::StaticDrawList");
+        RebuildStaticDrawListIfNeeded();
+        UpdateStaticTranslations(cameraPosition);
+    }
+    {
+        PROFILE_SCOPE("Render::Snapshot");
+        FillSnapshot(s_Mailbox.GetWriteSlot(), viewMatrix, projMatrix, totalTime, width, height);
+    }
+    {
+        PROFILE_SCOPE("Render::Publish"); // Waits here while the render thread is a frame behind
+        s_Mailbox.Publish();
     }
 
-    s_pGPURender->EndFrame();
+    if (!s_RenderThread.joinable()) {
+        if (const RenderSnapshot* snapshot = s_Mailbox.Acquire())
+            DrawSnapshot(*snapshot);
+    }
 }
 
 void Renderer_Shutdown() {
-    if (s_pGPURender) {
-        s_pGPURender->Shutdown();
-        s_pGPURender = nullptr;
+    if (s_RenderThread.joinable()) {
+        s_Mailbox.Close();
+        s_RenderThread.join(); // Releases the snapshots and shuts the backend down on its own thread
+    } else {
+        s_Mailbox.Reset();
+        s_Commands.Clear();
+        if (s_pGPURender)
+            s_pGPURender->Shutdown();
     }
+    s_pGPURender = nullptr;
+    s_SnapshotFrame = 0;
+    s_FlushUploadsRequested = false;
+    s_StateFrames = 0;
+    s_StateIssued = 0;
+    s_StateFiltered = 0;
+
+    s_StaticDrawOrder.clear();
+    s_StaticMeshIds.clear();
+    s_StaticModelMatrices.clear();
+    s_StaticWorldPositions.Clear();
+    s_StaticRelativePositions.Clear();
+    s_StaticDrawListRevision = ~0u;
+    s_StaticOriginRevision = ~0u;
+
+    s_NullRender.reset();
     s_Window = nullptr;
 }
 
@@ -103,4 +405,29 @@ void Renderer_Unload() {
 
 IGPURenderInterface* GetRenderInterface() {
     return s_pGPURender;
+}
+
+RendererStateTotals Renderer_GetStateTotals() {
+    RendererStateTotals totals;
+    totals.frames = s_StateFrames.load(std::memory_order_relaxed);
+    totals.issued = s_StateIssued.load(std::memory_order_relaxed);
+    totals.filtered = s_StateFiltered.load(std::memory_order_relaxed);
+    return totals;
+}
+
+void Renderer_SetUploadBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame) {
+    if (s_pGPURender)
+        s_pGPURender->SetUploadBudget(maxBytesPerFrame, maxMillisecondsPerFrame);
+}
+
+void Renderer_FlushUploads() {
+    s_FlushUploadsRequested = true;
+}
+
+bool Renderer_IsThreaded() {
+    return s_RenderThread.joinable();
+}
+
+const NullRenderStats* Renderer_GetNullRenderStats() {
+    return s_NullRender ? &s_NullRender->GetStats() : nullptr;
 }
\ No newline at end of file
@@ -1,20 +1,71 @@
 #pragma once
+#include "filesystem/file_view.h"
 #include "shaderapi/gpu_render_interface.h"
 #include "mathlib/matrix4x4_f.h"
+#include "mathlib/vector3_d.h"
 
 #include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct NullRenderStats;
 
 IGPURenderInterface* GetRenderInterface();
 
+enum class RenderBackendType {
+    OpenGL,     // shaderapi.dll, needs the window's GL context
+    Null        // No window or GPU: counts and optionally logs every call (see null_render_backend.h)
+};
+
+struct RendererConfig {
+    RenderBackendType backend = RenderBackendType::OpenGL;
+    int width = 1280;               // Frame size while there is no window to ask
+    int height = 720;
+    std::string commandLogPath;     // Null backend only; empty records nothing
+    size_t uploadBudgetBytes = 4 * 1024 * 1024;    // Mesh uploads per frame, see SetUploadBudget
+    double uploadBudgetMs = 2.0;
+    bool renderThread = true;       // OpenGL only: draw on a render thread that owns the GL context.
+                                    // The null backend always draws inline and ignores this: mesh creation
+                                    // and uploads reach it from the main thread, so drawing elsewhere would
+                                    // interleave its command log nondeterministically.
+};
+
 // Initialize the renderer module with the GPU interface pointer
 void Renderer_Init(IGPURenderInterface* gpuRender, SDL_Window* window);
 
-// Called every frame for rendering
-void Renderer_RenderFrame(const Matrix4x4_f& viewMatrix, const Matrix4x4_f& projMatrix, float totalTime);
+// Called every frame for rendering. With cameraPosition set, world geometry is drawn
+// camera-relative (viewMatrix must then be rotation-only); otherwise it is drawn
+// relative to the floating origin.
+// With a render thread this only snapshots the frame and hands it over (waiting if the
+// render thread is still a frame behind); otherwise the frame is drawn before returning.
+void Renderer_RenderFrame(const Matrix4x4_f& viewMatrix, const Matrix4x4_f& projMatrix, float totalTime,
+                          const Vector3_d* cameraPosition = nullptr);
 
 // Shutdown renderer
 void Renderer_Shutdown();
 
 // New functions:
-bool Renderer_LoadAndInit(SDL_Window* window);
-void Renderer_Unload();
\ No newline at end of file
+bool Renderer_LoadAndInit(SDL_Window* window, FSOpenMappedFn openFile, const RendererConfig& config = RendererConfig());
+void Renderer_Unload();
+
+// Backend state changes summed over every frame drawn so far; safe from any thread
+struct RendererStateTotals {
+    uint64_t frames;
+    uint64_t issued;
+    uint64_t filtered;
+};
+RendererStateTotals Renderer_GetStateTotals();
+
+// Per-frame mesh upload budget (IGPURenderInterface::SetUploadBudget); any time after init
+void Renderer_SetUploadBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame);
+
+// Uploads everything queued so far before the next frame is drawn, on whichever
+// thread draws (loading screens)
+void Renderer_FlushUploads();
+
+// True while frames are drawn on the render thread
+bool Renderer_IsThreaded();
+
+// Counters of the null backend, or nullptr when another backend is loaded
+const NullRenderStats* Renderer_GetNullRenderStats();
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "floating_origin_manager.h"
+#include "engine_log.h"
+#include <algorithm>
+
+static FloatingOriginManager g_FloatingOriginManager;
+
+FloatingOriginManager& GetFloatingOriginManager() {
+    return g_FloatingOriginManager;
+}
+
+static Vector3_f ToLocal(const Vector3_d& world, const Vector3_d& origin) {
+    return Vector3_f(static_cast<float>(world.x - origin.x),
+                     static_cast<float>(world.y - origin.y),
+                     static_cast<float>(world.z - origin.z));
+}
+
+OriginHandle FloatingOriginManager::Register(const Vector3_d& worldPosition) {
+    OriginHandle handle;
+    if (!m_FreeHandles.empty()) {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    } else {
+        handle = static_cast<OriginHandle>(m_HandleToSlot.size());
+        m_HandleToSlot.push_back(0);
+    }
+
+    const size_t slot = m_World.PushBack(worldPosition);
+    FrontLocal().PushBack(ToLocal(worldPosition, m_Origin));
+    BackLocal().PushBack(ToLocal(worldPosition, m_PendingOrigin));
+
+    m_HandleToSlot[handle] = static_cast<uint32_t>(slot);
+    m_SlotToHandle.push_back(handle);
+    return handle;
+}
+
+void FloatingOriginManager::Unregister(OriginHandle handle) {
+    if (!IsRegistered(handle)) {
+        ENGINE_LOG_WARNING(World, "[FloatingOrigin] Ignoring unregister of stale handle %u.", handle);
+        return;
+    }
+
+    const uint32_t slot = m_HandleToSlot[handle];
+    const uint32_t last = static_cast<uint32_t>(m_World.Size() - 1);
+
+    m_World.EraseSwap(slot);
+    m_Local[0].EraseSwap(slot);
+    m_Local[1].EraseSwap(slot);
+
+    if (slot != last) {
+        const OriginHandle moved = m_SlotToHandle[last];
+        m_SlotToHandle[slot] = moved;
+        m_HandleToSlot[moved] = slot;
+        // The moved entity may come from the not-yet-rebased range; convert it now
+        if (m_Rebasing)
+            BackLocal().Set(slot, ToLocal(m_World.Get(slot), m_PendingOrigin));
+    }
+    m_SlotToHandle.pop_back();
+    m_HandleToSlot[handle] = FREE_SLOT;
+    m_FreeHandles.push_back(handle);
+}
+
+void FloatingOriginManager::Clear() {
+    m_World.Clear();
+    m_Local[0].Clear();
+    m_Local[1].Clear();
+    m_HandleToSlot.clear();
+    m_SlotToHandle.clear();
+    m_FreeHandles.clear();
+    m_Rebasing = false;
+    m_RebaseCursor = 0;
+}
+
+void FloatingOriginManager::SetWorldPosition(OriginHandle handle, const Vector3_d& worldPosition) {
+    if (!IsRegistered(handle))
+        return;
+    const uint32_t slot = m_HandleToSlot[handle];
+    m_World.Set(slot, worldPosition);
+    FrontLocal().Set(slot, ToLocal(worldPosition, m_Origin));
+    if (m_Rebasing)
+        BackLocal().Set(slot, ToLocal(worldPosition, m_PendingOrigin));
+}
+
+Vector3_d FloatingOriginManager::GetWorldPosition(OriginHandle handle) const {
+    if (!IsRegistered(handle))
+        return Vector3_d();
+    return m_World.Get(m_HandleToSlot[handle]);
+}
+
+Vector3_f FloatingOriginManager::GetLocalPosition(OriginHandle handle) const {
+    if (!IsRegistered(handle))
+        return Vector3_f();
+    return m_Local[m_Front].Get(m_HandleToSlot[handle]);
+}
+
+void FloatingOriginManager::RequestRebase(const Vector3_d& newOrigin) {
+    m_PendingOrigin = newOrigin;
+    m_Rebasing = true;
+    m_RebaseCursor = 0;
+    ENGINE_LOG_DEBUG(World, "[FloatingOrigin] Rebase requested to (%.2f, %.2f, %.2f) for %zu entities.",
+              newOrigin.x, newOrigin.y, newOrigin.z, m_World.Size());
+}
+
+void FloatingOriginManager::RebaseNow(const Vector3_d& newOrigin) {
+    m_PendingOrigin = newOrigin;
+    m_World.ToLocal(m_PendingOrigin, BackLocal(), 0, m_World.Size());
+    CommitRebase();
+}
+
+void FloatingOriginManager::Update() {
+    if (!m_Rebasing)
+        return;
+
+    const size_t count = m_World.Size();
+    const size_t slice = std::min(m_RebaseBudget, count - m_RebaseCursor);
+    m_World.ToLocal(m_PendingOrigin, BackLocal(), m_RebaseCursor, slice);
+    m_RebaseCursor += slice;
+
+    if (m_RebaseCursor >= count)
+        CommitRebase();
+}
+
+void FloatingOriginManager::CommitRebase() {
+    m_Front ^= 1;
+    m_Origin = m_PendingOrigin;
+    m_Rebasing = false;
+    m_RebaseCursor = 0;
+    ++m_OriginRevision;
+}
@@ -0,0 +1,74 @@
+// floating_origin_manager.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "mathlib/vector3_d.h"
+#include "mathlib/vector3_batch.h"
+#include "world/origin_handle.h"
+
+// Registry of everything that lives in world space and renders relative to the
+// floating origin. Each entity keeps its precise Vector3_d world position plus a
+// float local position (world - origin) that rendering reads.
+//
+// Positions are stored SoA, so a rebase is one Vector3Batch_d::ToLocal sweep.
+// A requested rebase is spread over frames: Update() converts up to the budget
+// into a back buffer while the front buffer (old origin) stays valid, then both
+// buffers and the origin switch together, so no frame sees a mix.
+class FloatingOriginManager {
+public:
+    OriginHandle Register(const Vector3_d& worldPosition);
+    void Unregister(OriginHandle handle);   // Ignores handles that aren't registered
+    void Clear();
+
+    bool IsRegistered(OriginHandle handle) const {
+        return handle < m_HandleToSlot.size() && m_HandleToSlot[handle] != FREE_SLOT;
+    }
+
+    // Unregistered handles are ignored by the setter and read back as zero
+    void SetWorldPosition(OriginHandle handle, const Vector3_d& worldPosition);
+    Vector3_d GetWorldPosition(OriginHandle handle) const;
+    Vector3_f GetLocalPosition(OriginHandle handle) const; // Relative to GetOrigin()
+
+    // Starts an amortized rebase; a request made mid-rebase restarts it toward the new origin
+    void RequestRebase(const Vector3_d& newOrigin);
+    // Rebases everything right now (map load, teleports)
+    void RebaseNow(const Vector3_d& newOrigin);
+    // Advances a pending rebase by up to the per-frame budget; call once per frame
+    void Update();
+
+    bool IsRebasing() const { return m_Rebasing; }
+    const Vector3_d& GetOrigin() const { return m_Origin; }
+    const Vector3_d& GetTargetOrigin() const { return m_Rebasing ? m_PendingOrigin : m_Origin; }
+
+    void SetRebaseBudget(size_t entitiesPerFrame) { m_RebaseBudget = entitiesPerFrame ? entitiesPerFrame : 1; }
+    size_t GetEntityCount() const { return m_World.Size(); }
+
+    // Bumped whenever the committed origin changes, so cached render data knows to refresh
+    unsigned int GetOriginRevision() const { return m_OriginRevision; }
+
+private:
+    static constexpr uint32_t FREE_SLOT = 0xFFFFFFFFu;  // m_HandleToSlot entry of a free handle
+
+    Vector3Batch_f& FrontLocal() { return m_Local[m_Front]; }
+    Vector3Batch_f& BackLocal() { return m_Local[m_Front ^ 1]; }
+    void CommitRebase();
+
+    Vector3Batch_d m_World;                 // Dense, indexed by slot
+    Vector3Batch_f m_Local[2];              // Front: relative to m_Origin, back: relative to m_PendingOrigin
+    int m_Front = 0;
+
+    std::vector<uint32_t> m_HandleToSlot;
+    std::vector<OriginHandle> m_SlotToHandle;
+    std::vector<OriginHandle> m_FreeHandles;
+
+    Vector3_d m_Origin;
+    Vector3_d m_PendingOrigin;
+    bool m_Rebasing = false;
+    size_t m_RebaseCursor = 0;
+    size_t m_RebaseBudget = 16384;          // ~100k entities rebase in 7 frames
+    unsigned int m_OriginRevision = 0;
+};
+
+FloatingOriginManager& GetFloatingOriginManager();
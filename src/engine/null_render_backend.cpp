@@ -0,0 +1,280 @@
+#include "null_render_backend.h"
+#include "engine_log.h"
+#include "mathlib/matrix4x4_f.h"
+
+#include <cstring>
+
+NullMesh::NullMesh(NullRenderBackend* backend, uint32_t id) : m_Backend(backend), m_Id(id) {}
+
+NullMesh::~NullMesh() {
+    m_Backend->OnMeshDestroyed(*this);
+}
+
+void NullMesh::Upload(const GPUMeshData& data) {
+    m_IndexCount = data.indexCount;
+    m_Ready = true;
+    m_Backend->OnMeshUploaded(*this, data);
+}
+
+NullRenderBackend::~NullRenderBackend() {
+    Shutdown();
+}
+
+bool NullRenderBackend::OpenCommandLog(const char* path) {
+    if (m_LogFile)
+        fclose(m_LogFile);
+    m_Log.clear();
+
+    m_LogFile = fopen(path, "wb");
+    if (!m_LogFile) {
+        ENGINE_LOG_ERROR(Render, "[NullRender] Failed to open command log %s", path);
+        return false;
+    }
+
+    const RenderCommandLogHeader header = { RENDER_COMMAND_LOG_MAGIC, RENDER_COMMAND_LOG_VERSION };
+    fwrite(&header, sizeof(header), 1, m_LogFile);
+    ENGINE_LOG_INFO(Render, "[NullRender] Recording commands to %s", path);
+    return true;
+}
+
+bool NullRenderBackend::Init(void* /*windowHandle*/, int width, int height) {
+    m_Stats = NullRenderStats();
+    m_FrameStart = NullRenderStats();
+    m_LastFrameStats = NullRenderStats();
+    ENGINE_LOG_INFO(Render, "[NullRender] Initialized (%dx%d, no GPU)", width, height);
+    return true;
+}
+
+void NullRenderBackend::Shutdown() {
+    if (!m_LogFile)
+        return;
+    FlushCommandLog();
+    fclose(m_LogFile);
+    m_LogFile = nullptr;
+}
+
+void NullRenderBackend::BeginFrame() {
+    m_FrameStart = m_Stats;
+    const uint32_t frame = static_cast<uint32_t>(m_Stats.frames);
+    Record(RenderCommandType::BeginFrame, &frame, sizeof(frame));
+}
+
+void NullRenderBackend::EndFrame() {
+    Record(RenderCommandType::EndFrame, nullptr, 0);
+    ++m_Stats.frames;
+
+    // Per-frame figures are the difference against the totals at BeginFrame
+    NullRenderStats& frame = m_LastFrameStats;
+    frame.frames = 1;
+    frame.meshesCreated = m_Stats.meshesCreated - m_FrameStart.meshesCreated;
+    frame.meshesDestroyed = m_Stats.meshesDestroyed - m_FrameStart.meshesDestroyed;
+    frame.meshUploads = m_Stats.meshUploads - m_FrameStart.meshUploads;
+    frame.uploadBytes = m_Stats.uploadBytes - m_FrameStart.uploadBytes;
+    frame.drawCalls = m_Stats.drawCalls - m_FrameStart.drawCalls;
+    frame.instances = m_Stats.instances - m_FrameStart.instances;
+    frame.triangles = m_Stats.triangles - m_FrameStart.triangles;
+    frame.skippedDraws = m_Stats.skippedDraws - m_FrameStart.skippedDraws;
+    frame.matrixChanges = m_Stats.matrixChanges - m_FrameStart.matrixChanges;
+    frame.stateChanges = m_Stats.stateChanges - m_FrameStart.stateChanges;
+    frame.starfieldDraws = m_Stats.starfieldDraws - m_FrameStart.starfieldDraws;
+    frame.passes = m_Stats.passes - m_FrameStart.passes;
+
+    FlushCommandLog();
+}
+
+void NullRenderBackend::PrepareFrame(int width, int height) {
+    const int32_t size[2] = { width, height };
+    Record(RenderCommandType::PrepareFrame, size, sizeof(size));
+}
+
+void NullRenderBackend::OnResize(int width, int height) {
+    const int32_t size[2] = { width, height };
+    Record(RenderCommandType::Resize, size, sizeof(size));
+}
+
+void NullRenderBackend::SetViewMatrix(const Matrix4x4_f& viewMatrix) {
+    ++m_Stats.matrixChanges;
+    RecordMatrix(RenderCommandType::SetViewMatrix, viewMatrix);
+}
+
+void NullRenderBackend::SetProjectionMatrix(const Matrix4x4_f& projMatrix) {
+    ++m_Stats.matrixChanges;
+    RecordMatrix(RenderCommandType::SetProjectionMatrix, projMatrix);
+}
+
+void NullRenderBackend::SetFrameTime(float elapsedTime) {
+    Record(RenderCommandType::SetFrameTime, &elapsedTime, sizeof(elapsedTime));
+}
+
+void NullRenderBackend::DrawMesh(const IGPUMesh& mesh, const Matrix4x4_f& modelMatrix) {
+    if (!mesh.IsReady()) {
+        ++m_Stats.skippedDraws;
+        return;
+    }
+    ++m_Stats.drawCalls;
+    ++m_Stats.instances;
+    m_Stats.triangles += mesh.GetIndexCount() / 3;
+
+    if (!m_LogFile)
+        return;
+    unsigned char payload[sizeof(uint32_t) + sizeof(Matrix4x4_f)];
+    const uint32_t id = static_cast<const NullMesh&>(mesh).GetId();
+    std::memcpy(payload, &id, sizeof(id));
+    std::memcpy(payload + sizeof(id), &modelMatrix, sizeof(Matrix4x4_f));
+    Record(RenderCommandType::DrawMesh, payload, sizeof(payload));
+}
+
+void NullRenderBackend::ExecuteCommands(const RenderCommand* commands, size_t count) {
+    if (count == 0)
+        return;
+
+    // Mirrors the GL backend: pass state on pass changes, one draw per run of equal meshes
+    RenderPass pass = RenderPass::Count;
+    size_t i = 0;
+    while (i < count) {
+        const RenderCommand& command = commands[i];
+        const RenderPass commandPass = GetRenderKeyPass(command.sortKey);
+        if (commandPass != pass) {
+            m_Stats.stateChanges += 2;  // Depth test and depth write
+            pass = commandPass;
+        }
+
+        if (command.kind == RenderCommandKind::DrawStarfield) {
+            ++m_Stats.starfieldDraws;
+            ++i;
+            continue;
+        }
+
+        size_t runEnd = i + 1;
+        while (runEnd < count && commands[runEnd].kind == RenderCommandKind::DrawMesh &&
+               commands[runEnd].mesh == command.mesh && GetRenderKeyPass(commands[runEnd].sortKey) == pass)
+            ++runEnd;
+
+        if (command.mesh->IsReady()) {
+            ++m_Stats.drawCalls;
+            m_Stats.instances += runEnd - i;
+            m_Stats.triangles += (command.mesh->GetIndexCount() / 3) * (runEnd - i);
+        } else {
+            m_Stats.skippedDraws += runEnd - i;
+        }
+        i = runEnd;
+    }
+
+    if (!m_LogFile)
+        return;
+    constexpr size_t ENTRY_SIZE = sizeof(uint64_t) + 3 * sizeof(uint32_t) + sizeof(Matrix4x4_f);
+    m_Scratch.assign(sizeof(uint32_t) + count * ENTRY_SIZE, 0);
+    const uint32_t count32 = static_cast<uint32_t>(count);
+    std::memcpy(m_Scratch.data(), &count32, sizeof(count32));
+    unsigned char* out = m_Scratch.data() + sizeof(count32);
+    for (size_t c = 0; c < count; ++c, out += ENTRY_SIZE) {
+        const RenderCommand& command = commands[c];
+        const uint32_t kind = static_cast<uint32_t>(command.kind);
+        const uint32_t id = command.mesh ? static_cast<const NullMesh*>(command.mesh)->GetId() : 0;
+        std::memcpy(out, &command.sortKey, sizeof(uint64_t));
+        std::memcpy(out + 8, &kind, sizeof(kind));
+        std::memcpy(out + 12, &id, sizeof(id));
+        std::memcpy(out + 16, &command.param, sizeof(float));
+        if (command.modelMatrix)
+            std::memcpy(out + 20, command.modelMatrix, sizeof(Matrix4x4_f));
+    }
+    Record(RenderCommandType::ExecuteCommands, m_Scratch.data(), m_Scratch.size());
+}
+
+IGPUMesh* NullRenderBackend::CreateMesh() {
+    const uint32_t id = m_NextMeshId++;
+    ++m_Stats.meshesCreated;
+    Record(RenderCommandType::CreateMesh, &id, sizeof(id));
+    return new NullMesh(this, id);
+}
+
+void NullRenderBackend::FlushUploads() {
+    Record(RenderCommandType::FlushUploads, nullptr, 0);
+}
+
+void NullRenderBackend::OnMeshUploaded(const NullMesh& mesh, const GPUMeshData& data) {
+    size_t bytes = data.GetIndexBytes();
+    for (uint32_t s = 0; s < data.layout.streamCount; ++s)
+        bytes += data.GetStreamBytes(s);
+
+    ++m_Stats.meshUploads;
+    m_Stats.uploadBytes += bytes;
+
+    const uint32_t payload[4] = {
+        mesh.GetId(),
+        static_cast<uint32_t>(data.vertexCount),
+        static_cast<uint32_t>(data.indexCount),
+        static_cast<uint32_t>(bytes)
+    };
+    Record(RenderCommandType::UploadMesh, payload, sizeof(payload));
+}
+
+void NullRenderBackend::OnMeshDestroyed(const NullMesh& mesh) {
+    ++m_Stats.meshesDestroyed;
+    const uint32_t id = mesh.GetId();
+    Record(RenderCommandType::DestroyMesh, &id, sizeof(id));
+}
+
+void NullRenderBackend::BeginPass(const char* name) {
+    ++m_Stats.passes;
+    Record(RenderCommandType::BeginPass, name, std::strlen(name));
+}
+
+void NullRenderBackend::EndPass() {
+    Record(RenderCommandType::EndPass, nullptr, 0);
+}
+
+size_t NullRenderBackend::GetPassTimings(const GPUPassTiming** out) const {
+    *out = nullptr;
+    return 0;
+}
+
+// Nothing is filtered here; every counted state change would have reached a driver
+GPUStateStats NullRenderBackend::GetStateStats() const {
+    GPUStateStats stats = {};
+    stats.issued = static_cast<uint32_t>(m_LastFrameStats.stateChanges);
+    return stats;
+}
+
+void NullRenderBackend::RenderStarfield(float elapsedTime) {
+    ++m_Stats.starfieldDraws;
+    Record(RenderCommandType::RenderStarfield, &elapsedTime, sizeof(elapsedTime));
+}
+
+void NullRenderBackend::SetDepthTestEnabled(bool enabled) {
+    ++m_Stats.stateChanges;
+    const uint32_t value = enabled ? 1 : 0;
+    Record(RenderCommandType::DepthTest, &value, sizeof(value));
+}
+
+void NullRenderBackend::SetDepthMaskEnabled(bool enabled) {
+    ++m_Stats.stateChanges;
+    const uint32_t value = enabled ? 1 : 0;
+    Record(RenderCommandType::DepthMask, &value, sizeof(value));
+}
+
+void NullRenderBackend::Record(RenderCommandType type, const void* payload, size_t size) {
+    if (!m_LogFile)
+        return;
+
+    RenderCommandRecord record = {};
+    record.type = static_cast<uint16_t>(type);
+    record.size = static_cast<uint32_t>(size);
+
+    const size_t offset = m_Log.size();
+    m_Log.resize(offset + sizeof(record) + size);
+    std::memcpy(m_Log.data() + offset, &record, sizeof(record));
+    if (size > 0)
+        std::memcpy(m_Log.data() + offset + sizeof(record), payload, size);
+}
+
+void NullRenderBackend::RecordMatrix(RenderCommandType type, const Matrix4x4_f& matrix) {
+    Record(type, &matrix, sizeof(Matrix4x4_f));
+}
+
+void NullRenderBackend::FlushCommandLog() {
+    if (!m_LogFile || m_Log.empty())
+        return;
+    fwrite(m_Log.data(), 1, m_Log.size(), m_LogFile);
+    m_Log.clear();
+}
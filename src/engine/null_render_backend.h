@@ -0,0 +1,175 @@
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Null render backend: an IGPURenderInterface that needs no window, no GL
+// context and no shaderapi.dll. Every call is counted (NullRenderStats) and,
+// with a command log open, appended to a binary file, so the whole frame loop
+// can be profiled and regression-tested headlessly (launcher -nullrender).
+//
+// Command log layout, little-endian:
+//
+//   RenderCommandLogHeader
+//   RenderCommandRecord + payload, repeated
+//
+// Payloads by type:
+//   BeginFrame                     uint32 frame index
+//   PrepareFrame, Resize           int32 width, int32 height
+//   SetViewMatrix, SetProjection   float[16] (column-major)
+//   DrawMesh                       uint32 mesh id, float[16] model matrix
+//   CreateMesh, DestroyMesh        uint32 mesh id
+//   UploadMesh                     uint32 mesh id, vertex count, index count, bytes
+//   DepthTest, DepthMask           uint32 enabled
+//   RenderStarfield, SetFrameTime  float elapsed time
+//   BeginPass                      pass name, not NUL-terminated
+//   EndFrame, EndPass, FlushUploads  nothing
+//   ExecuteCommands                uint32 count, then count x (uint64 sort key,
+//                                  uint32 kind, uint32 mesh id (0: none), float param,
+//                                  float[16] model matrix (zero: none))
+//
+// Version 2 added ExecuteCommands, version 3 SetFrameTime; version 4 dropped
+// DrawMeshList, renumbering the types after it.
+//-----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "shaderapi/gpu_render_interface.h"
+#include "shaderapi/igpu_mesh.h"
+
+constexpr uint32_t RENDER_COMMAND_LOG_MAGIC   = 0x474C4352; // "RCLG"
+constexpr uint32_t RENDER_COMMAND_LOG_VERSION = 4;
+
+enum class RenderCommandType : uint16_t {
+    BeginFrame,
+    PrepareFrame,
+    EndFrame,
+    Resize,
+    SetViewMatrix,
+    SetProjectionMatrix,
+    DrawMesh,
+    CreateMesh,
+    UploadMesh,
+    DestroyMesh,
+    DepthTest,
+    DepthMask,
+    RenderStarfield,
+    BeginPass,
+    EndPass,
+    FlushUploads,
+    ExecuteCommands,
+    SetFrameTime
+};
+
+struct RenderCommandLogHeader {
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct RenderCommandRecord {
+    uint16_t type;      // RenderCommandType
+    uint16_t reserved;
+    uint32_t size;      // Payload bytes that follow
+};
+
+struct NullRenderStats {
+    uint64_t frames = 0;
+    uint64_t meshesCreated = 0;
+    uint64_t meshesDestroyed = 0;
+    uint64_t meshUploads = 0;
+    uint64_t uploadBytes = 0;
+    uint64_t drawCalls = 0;         // DrawMesh calls plus one per instanced run of a command stream
+    uint64_t instances = 0;         // Meshes drawn, counting each instance
+    uint64_t triangles = 0;
+    uint64_t skippedDraws = 0;      // Draws of meshes with no upload yet
+    uint64_t matrixChanges = 0;     // View and projection
+    uint64_t stateChanges = 0;      // Depth test and depth write toggles
+    uint64_t starfieldDraws = 0;
+    uint64_t passes = 0;
+};
+
+class NullRenderBackend;
+
+class NullMesh : public IGPUMesh {
+public:
+    NullMesh(NullRenderBackend* backend, uint32_t id);
+    ~NullMesh() override;
+
+    void Upload(const GPUMeshData& data) override;
+    bool IsReady() const override { return m_Ready; }
+    void Bind() const override {}
+    void Unbind() const override {}
+    size_t GetIndexCount() const override { return m_IndexCount; }
+
+    uint32_t GetId() const { return m_Id; }
+
+private:
+    NullRenderBackend* m_Backend;
+    uint32_t m_Id;
+    size_t m_IndexCount = 0;
+    bool m_Ready = false;
+};
+
+class NullRenderBackend : public IGPURenderInterface {
+public:
+    ~NullRenderBackend() override;
+
+    // Starts recording to path (truncated); call before Init to capture mesh creation
+    bool OpenCommandLog(const char* path);
+
+    const NullRenderStats& GetStats() const { return m_Stats; }                   // Since Init
+    const NullRenderStats& GetLastFrameStats() const { return m_LastFrameStats; } // Last completed frame
+
+    void PrepareFrame(int width, int height) override;
+    void SetFileSystem(FSOpenMappedFn) override {}
+    bool Init(void* windowHandle, int width, int height) override;
+    void Shutdown() override;
+    void BeginFrame() override;
+    void EndFrame() override;
+    void OnResize(int width, int height) override;
+
+    void SetViewMatrix(const Matrix4x4_f& viewMatrix) override;
+    void SetProjectionMatrix(const Matrix4x4_f& projMatrix) override;
+    void SetFrameTime(float elapsedTime) override;
+
+    void DrawMesh(const IGPUMesh& mesh, const Matrix4x4_f& modelMatrix) override;
+    void ExecuteCommands(const RenderCommand* commands, size_t count) override;
+
+    // Uploads complete immediately, so there is never anything queued
+    IGPUMesh* CreateMesh() override;
+    void SetUploadBudget(size_t, double) override {}
+    void FlushUploads() override;
+    size_t GetPendingUploadCount() const override { return 0; }
+
+    // No GPU, so passes are counted but never produce timings
+    void BeginPass(const char* name) override;
+    void EndPass() override;
+    size_t GetPassTimings(const GPUPassTiming** out) const override;
+    GPUStateStats GetStateStats() const override;
+
+    bool LoadStarfieldShaders() override { return true; }
+    void RenderStarfield(float elapsedTime) override;
+    void ReleaseStarfield() override {}
+
+    void SetDepthTestEnabled(bool enabled) override;
+    void SetDepthMaskEnabled(bool enabled) override;
+
+private:
+    friend class NullMesh;
+    void OnMeshUploaded(const NullMesh& mesh, const GPUMeshData& data);
+    void OnMeshDestroyed(const NullMesh& mesh);
+
+    void Record(RenderCommandType type, const void* payload, size_t size);
+    void RecordMatrix(RenderCommandType type, const Matrix4x4_f& matrix);
+    void FlushCommandLog();
+
+    NullRenderStats m_Stats;
+    NullRenderStats m_FrameStart;       // m_Stats at BeginFrame
+    NullRenderStats m_LastFrameStats;
+    uint32_t m_NextMeshId = 1;
+
+    FILE* m_LogFile = nullptr;
+    std::vector<unsigned char> m_Log;   // This frame's records, written out at EndFrame
+    std::vector<unsigned char> m_Scratch;
+};
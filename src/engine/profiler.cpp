@@ -0,0 +1,292 @@
+#include "profiler.h"
+
+#ifdef INC_PROFILER_ENABLED
+
+#include "engine_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t endNs;
+};
+
+constexpr uint32_t RING_CAPACITY = 16384;          // Events per thread between two frame ends
+constexpr uint32_t RING_MASK = RING_CAPACITY - 1;
+constexpr uint32_t STATS_WINDOW = 256;             // Frames of history per scope
+constexpr size_t MAX_CAPTURE_EVENTS = 4u << 20;
+
+static_assert((RING_CAPACITY & RING_MASK) == 0, "ring capacity must be a power of two");
+
+// Written only by its owning thread (head) and the frame aggregator (tail).
+// Rings live until shutdown, even after their thread exits, so a late drain is safe.
+struct ThreadRing {
+    ProfileEvent events[RING_CAPACITY];
+    std::atomic<uint32_t> head{ 0 };
+    std::atomic<uint32_t> tail{ 0 };
+    std::atomic<uint32_t> dropped{ 0 };
+    std::atomic<const char*> name{ nullptr };
+    uint32_t id = 0;
+};
+
+struct ScopeHistory {
+    const char* name = nullptr;
+    float samples[STATS_WINDOW] = {};
+    uint32_t sampleCount = 0;
+    uint32_t nextSample = 0;
+    float lastMs = 0.0f;
+    uint32_t lastCalls = 0;
+
+    uint64_t frameNs = 0;       // Accumulating for the frame being drained
+    uint32_t frameCalls = 0;
+};
+
+struct CapturedEvent {
+    uint32_t threadId;
+    ProfileEvent event;
+};
+
+std::mutex s_RingsMutex;                            // Guards s_Rings (registration vs. drain)
+std::vector<std::unique_ptr<ThreadRing>> s_Rings;
+thread_local ThreadRing* t_Ring = nullptr;
+
+// Main thread only
+std::vector<ScopeHistory> s_Scopes;
+std::unordered_map<const char*, size_t> s_ScopeIndex;
+uint64_t s_FrameStart = 0;
+uint32_t s_CaptureFramesLeft = 0;
+std::vector<CapturedEvent> s_Capture;
+
+ThreadRing* s_GPURing = nullptr;                   // Pseudo-thread track for GPU pass timings
+
+ThreadRing* RegisterRing(const char* name) {
+    auto ring = std::make_unique<ThreadRing>();
+    ring->name.store(name, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(s_RingsMutex);
+    ring->id = static_cast<uint32_t>(s_Rings.size() + 1);
+    s_Rings.push_back(std::move(ring));
+    return s_Rings.back().get();
+}
+
+ThreadRing* GetThreadRing() {
+    if (!t_Ring)
+        t_Ring = RegisterRing(nullptr);
+    return t_Ring;
+}
+
+void PushEvent(ThreadRing* ring, const char* name, uint64_t startNs, uint64_t endNs) {
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed); // Aggregator fell behind; lose the event, not time
+        return;
+    }
+
+    ring->events[head & RING_MASK] = { name, startNs, endNs };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+ScopeHistory& GetScope(const char* name) {
+    auto it = s_ScopeIndex.find(name);
+    if (it != s_ScopeIndex.end())
+        return s_Scopes[it->second];
+
+    s_ScopeIndex.emplace(name, s_Scopes.size());
+    s_Scopes.emplace_back();
+    s_Scopes.back().name = name;
+    return s_Scopes.back();
+}
+
+void Consume(uint32_t threadId, const ProfileEvent& event) {
+    ScopeHistory& scope = GetScope(event.name);
+    scope.frameNs += event.endNs - event.startNs;
+    ++scope.frameCalls;
+
+    if (s_CaptureFramesLeft > 0 && s_Capture.size() < MAX_CAPTURE_EVENTS)
+        s_Capture.push_back({ threadId, event });
+}
+
+void WriteJSONString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', file);
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+void WriteCapture() {
+    if (s_Capture.empty())
+        return;
+
+    std::filesystem::create_directories("logs");
+
+    char path[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(path, sizeof(path), "logs/profile_%Y%m%d_%H%M%S.json", std::localtime(&now));
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        ENGINE_LOG_ERROR(Profiler, "[Profiler] Failed to write capture: %s", path);
+        return;
+    }
+
+    uint64_t origin = s_Capture.front().event.startNs;
+    for (const CapturedEvent& e : s_Capture)
+        origin = std::min(origin, e.event.startNs);
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(s_RingsMutex);
+        for (const auto& ring : s_Rings) {
+            const char* name = ring->name.load(std::memory_order_acquire);
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                    first ? "" : ",\n", ring->id);
+            if (name)
+                WriteJSONString(file, name);
+            else
+                fprintf(file, "\"Thread %u\"", ring->id);
+            fprintf(file, "}}");
+            first = false;
+        }
+    }
+
+    for (const CapturedEvent& e : s_Capture) {
+        fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+        WriteJSONString(file, e.event.name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                e.threadId, (e.event.startNs - origin) / 1000.0, (e.event.endNs - e.event.startNs) / 1000.0);
+        first = false;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    ENGINE_LOG_INFO(Profiler, "[Profiler] Wrote %zu events to %s", s_Capture.size(), path);
+}
+
+} // namespace
+
+uint64_t Profiler_Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler_Record(const char* name, uint64_t startNs, uint64_t endNs) {
+    PushEvent(GetThreadRing(), name, startNs, endNs);
+}
+
+void Profiler_RecordGPU(const char* name, uint64_t startNs, uint64_t durationNs) {
+    if (!s_GPURing)
+        s_GPURing = RegisterRing("GPU");
+    PushEvent(s_GPURing, name, startNs, startNs + durationNs);
+}
+
+void Profiler_SetThreadName(const char* name) {
+    GetThreadRing()->name.store(name, std::memory_order_release);
+}
+
+void Profiler_EndFrame() {
+    const uint64_t now = Profiler_Now();
+    if (s_FrameStart != 0)
+        Profiler_Record("Frame", s_FrameStart, now);
+    s_FrameStart = now;
+
+    uint32_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_RingsMutex);
+        for (const auto& ring : s_Rings) {
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            const uint32_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail)
+                Consume(ring->id, ring->events[tail & RING_MASK]);
+            ring->tail.store(tail, std::memory_order_release);
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    if (dropped > 0)
+        ENGINE_LOG_WARNING(Profiler, "[Profiler] Dropped %u events (ring full)", dropped);
+
+    // Scopes that didn't run this frame (e.g. occasional worker jobs) keep their history as is
+    for (ScopeHistory& scope : s_Scopes) {
+        scope.lastCalls = scope.frameCalls;
+        if (scope.frameCalls == 0)
+            continue;
+
+        scope.lastMs = static_cast<float>(scope.frameNs / 1e6);
+        scope.samples[scope.nextSample] = scope.lastMs;
+        scope.nextSample = (scope.nextSample + 1) % STATS_WINDOW;
+        scope.sampleCount = std::min(scope.sampleCount + 1, STATS_WINDOW);
+        scope.frameNs = 0;
+        scope.frameCalls = 0;
+    }
+
+    if (s_CaptureFramesLeft > 0 && --s_CaptureFramesLeft == 0) {
+        WriteCapture();
+        s_Capture.clear();
+        s_Capture.shrink_to_fit();
+        Profiler_LogStats();
+    }
+}
+
+void Profiler_Capture(uint32_t frameCount) {
+    if (s_CaptureFramesLeft > 0)
+        return; // One capture at a time
+    s_Capture.clear();
+    s_CaptureFramesLeft = frameCount;
+    ENGINE_LOG_INFO(Profiler, "[Profiler] Capturing %u frames", frameCount);
+}
+
+bool Profiler_IsCapturing() {
+    return s_CaptureFramesLeft > 0;
+}
+
+void Profiler_GetStats(std::vector<ProfileScopeStats>& out) {
+    out.clear();
+    out.reserve(s_Scopes.size());
+
+    float sorted[STATS_WINDOW];
+    for (const ScopeHistory& scope : s_Scopes) {
+        if (scope.sampleCount == 0)
+            continue;
+
+        const uint32_t n = scope.sampleCount;
+        std::copy(scope.samples, scope.samples + n, sorted);
+        std::sort(sorted, sorted + n);
+
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < n; ++i)
+            sum += sorted[i];
+
+        const uint32_t p99 = std::min(n - 1, (n * 99 + 99) / 100 - 1);
+        out.push_back({ scope.name, scope.lastMs, sorted[0], sum / n, sorted[p99], scope.lastCalls });
+    }
+
+    std::sort(out.begin(), out.end(), [](const ProfileScopeStats& a, const ProfileScopeStats& b) {
+        return a.avgMs > b.avgMs;
+    });
+}
+
+void Profiler_LogStats() {
+    std::vector<ProfileScopeStats> stats;
+    Profiler_GetStats(stats);
+
+    ENGINE_LOG_INFO(Profiler, "[Profiler] %-32s %8s %8s %8s %8s  (ms, last %u frames)", "scope", "last", "min", "avg", "p99", STATS_WINDOW);
+    for (const ProfileScopeStats& s : stats)
+        ENGINE_LOG_INFO(Profiler, "[Profiler] %-32s %8.3f %8.3f %8.3f %8.3f  x%u", s.name, s.lastMs, s.minMs, s.avgMs, s.p99Ms, s.calls);
+}
+
+#endif // INC_PROFILER_ENABLED
@@ -0,0 +1,90 @@
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Scoped CPU profiler.
+//
+//   PROFILE_SCOPE("Render");       // times the enclosing block
+//   PROFILE_THREAD_NAME("Worker"); // labels the calling thread in traces
+//   PROFILE_END_FRAME();           // once per frame, on the main thread
+//   PROFILE_CAPTURE(300);          // write the next 300 frames to logs/*.json
+//   Profiler_RecordGPU(...);       // feed GPU pass timings (see engine_renderer.cpp)
+//
+// Each thread records into its own fixed-size ring (single producer, single
+// consumer, no locks on the hot path). PROFILE_END_FRAME drains every ring,
+// sums each named scope for the frame and keeps a rolling window per scope for
+// min/avg/p99. Captures are written as Chrome trace JSON (chrome://tracing,
+// Perfetto).
+//
+// Built in Debug, or in any build with -DINC_ENABLE_PROFILER (PROFILE=1 in the
+// makefile). Otherwise every macro expands to nothing.
+//-----------------------------------------------------------------------------
+
+#if defined(DEBUG) || defined(INC_ENABLE_PROFILER)
+#define INC_PROFILER_ENABLED 1
+#endif
+
+#ifdef INC_PROFILER_ENABLED
+
+#include <cstdint>
+#include <vector>
+
+struct ProfileScopeStats {
+    const char* name;
+    float lastMs;       // Most recent frame
+    float minMs;        // Over the rolling window
+    float avgMs;
+    float p99Ms;
+    uint32_t calls;     // Most recent frame
+};
+
+uint64_t Profiler_Now();    // Nanoseconds, steady clock
+
+// Scope names must be string literals (or otherwise outlive the profiler); the
+// pointer is the scope's identity
+void Profiler_Record(const char* name, uint64_t startNs, uint64_t endNs);
+void Profiler_SetThreadName(const char* name);
+
+// GPU pass timings go on their own "GPU" track. Start is when the pass was
+// submitted on the CPU, so placement is approximate; the duration is GPU time.
+// Call from one thread only (the one that owns the render context).
+void Profiler_RecordGPU(const char* name, uint64_t startNs, uint64_t durationNs);
+
+void Profiler_EndFrame();
+void Profiler_Capture(uint32_t frameCount);
+bool Profiler_IsCapturing();
+
+// Stats as of the last Profiler_EndFrame; "Frame" is the whole frame
+void Profiler_GetStats(std::vector<ProfileScopeStats>& out);
+void Profiler_LogStats();   // One line per scope to the engine log
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_Name(name), m_Start(Profiler_Now()) {}
+    ~ProfileScope() { Profiler_Record(m_Name, m_Start, Profiler_Now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    uint64_t m_Start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name)         ProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name)   Profiler_SetThreadName(name)
+#define PROFILE_END_FRAME()         Profiler_EndFrame()
+#define PROFILE_CAPTURE(frames)     Profiler_Capture(frames)
+#define PROFILE_LOG_STATS()         Profiler_LogStats()
+
+#else
+
+#define PROFILE_SCOPE(name)         ((void)0)
+#define PROFILE_THREAD_NAME(name)   ((void)0)
+#define PROFILE_END_FRAME()         ((void)0)
+#define PROFILE_CAPTURE(frames)     ((void)0)
+#define PROFILE_LOG_STATS()         ((void)0)
+
+#endif
@@ -0,0 +1,67 @@
+#include "render_command_buffer.h"
+
+#include <algorithm>
+
+void RenderCommandBuffer::AddStarfield(RenderPass pass, float elapsedTime) {
+    RenderCommand command = {};
+    command.sortKey = MakeRenderSortKey(pass, RenderShader::Starfield, 0, 0, 0);
+    command.kind = RenderCommandKind::DrawStarfield;
+    command.param = elapsedTime;
+    m_Commands.push_back(command);
+}
+
+void RenderCommandBuffer::AddMesh(uint64_t sortKey, const IGPUMesh* mesh, const Matrix4x4_f* modelMatrix) {
+    RenderCommand command = {};
+    command.sortKey = sortKey;
+    command.mesh = mesh;
+    command.modelMatrix = modelMatrix;
+    command.kind = RenderCommandKind::DrawMesh;
+    m_Commands.push_back(command);
+}
+
+void RenderCommandBuffer::Sort() {
+    const size_t count = m_Commands.size();
+    if (count < 2)
+        return;
+
+    // All eight histograms in one sweep
+    uint32_t histograms[8][256] = {};
+    for (const RenderCommand& command : m_Commands) {
+        const uint64_t key = command.sortKey;
+        for (int byte = 0; byte < 8; ++byte)
+            ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+    }
+
+    m_Scratch.resize(count);
+    RenderCommand* src = m_Commands.data();
+    RenderCommand* dst = m_Scratch.data();
+    for (int byte = 0; byte < 8; ++byte) {
+        uint32_t* histogram = histograms[byte];
+        const uint32_t firstBucket = static_cast<uint32_t>((src[0].sortKey >> (byte * 8)) & 0xFF);
+        if (histogram[firstBucket] == count)
+            continue;   // Every key shares this byte, the order stands
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket) {
+            const uint32_t size = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += size;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+            dst[histogram[(src[i].sortKey >> (byte * 8)) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+
+    if (src != m_Commands.data())
+        m_Commands.swap(m_Scratch);
+}
+
+void RenderCommandBuffer::GetPassRange(RenderPass pass, size_t& first, size_t& count) const {
+    const auto begin = std::partition_point(m_Commands.begin(), m_Commands.end(),
+        [pass](const RenderCommand& command) { return GetRenderKeyPass(command.sortKey) < pass; });
+    const auto end = std::partition_point(begin, m_Commands.end(),
+        [pass](const RenderCommand& command) { return GetRenderKeyPass(command.sortKey) == pass; });
+    first = static_cast<size_t>(begin - m_Commands.begin());
+    count = static_cast<size_t>(end - begin);
+}
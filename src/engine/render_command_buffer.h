@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "shaderapi/render_command.h"
+
+// One frame's render commands. Scene traversal appends in whatever order it
+// walks the scene; Sort() then orders the whole buffer by key with an LSD radix
+// sort (8 bits a pass, passes where every key has the same byte are skipped, so
+// the mostly-constant pass/shader/material bits cost one histogram sweep each).
+// Storage is reused from frame to frame.
+class RenderCommandBuffer {
+public:
+    void Clear() { m_Commands.clear(); }
+    void Reserve(size_t count) { m_Commands.reserve(count); }
+
+    void AddStarfield(RenderPass pass, float elapsedTime);
+    void AddMesh(uint64_t sortKey, const IGPUMesh* mesh, const Matrix4x4_f* modelMatrix);
+
+    void Sort();
+
+    const RenderCommand* GetCommands() const { return m_Commands.data(); }
+    size_t GetCount() const { return m_Commands.size(); }
+
+    // Range of a pass in the sorted buffer
+    void GetPassRange(RenderPass pass, size_t& first, size_t& count) const;
+
+private:
+    std::vector<RenderCommand> m_Commands;
+    std::vector<RenderCommand> m_Scratch;
+};
@@ -0,0 +1,48 @@
+#include "render_snapshot.h"
+
+#include <utility>
+
+void RenderMailbox::Publish() {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Consumed.wait(lock, [this] { return !m_HasPending || m_Closed; });
+        std::swap(m_Write, m_Pending);
+        m_HasPending = true;
+    }
+    m_Published.notify_one();
+}
+
+const RenderSnapshot* RenderMailbox::Acquire() {
+    const RenderSnapshot* snapshot = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Published.wait(lock, [this] { return m_HasPending || m_Closed; });
+        if (m_Closed)
+            return nullptr;
+        std::swap(m_Read, m_Pending);
+        m_HasPending = false;
+        snapshot = &m_Slots[m_Read];
+    }
+    m_Consumed.notify_one();
+    return snapshot;
+}
+
+void RenderMailbox::Close() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Closed = true;
+    }
+    m_Published.notify_all();
+    m_Consumed.notify_all();
+}
+
+void RenderMailbox::Reset() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (RenderSnapshot& slot : m_Slots)
+        slot = RenderSnapshot();
+    m_Write = 0;
+    m_Pending = 1;
+    m_Read = 2;
+    m_HasPending = false;
+    m_Closed = false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "mathlib/matrix4x4_f.h"
+#include "shaderapi/igpu_mesh.h"
+
+// One frame as the renderer sees it, copied out of the world by the main thread
+// so the render thread can draw it while simulation moves on to the next frame.
+// Nothing in here points back into world state.
+struct RenderSnapshot {
+    uint64_t frame = 0;
+    Matrix4x4_f viewMatrix;
+    Matrix4x4_f projMatrix;
+    float time = 0.0f;
+    int width = 0;
+    int height = 0;
+    bool flushUploads = false;          // Renderer_FlushUploads() was called since the last snapshot
+
+    // Static instances in draw-list order: mesh id (index into meshes) and model matrix.
+    // Holding the meshes keeps them alive until the render thread is done with this
+    // frame, even if the world has dropped them since.
+    std::vector<std::shared_ptr<IGPUMesh>> meshes;
+    std::vector<uint32_t> instanceMeshIds;
+    std::vector<Matrix4x4_f> instanceMatrices;
+    unsigned int drawListRevision = ~0u;    // Static draw list meshes/instanceMeshIds were copied from
+};
+
+// Triple-buffered hand-off from the main thread (writer) to the render thread
+// (reader): one slot being filled, one published and waiting, one being drawn,
+// so the two threads never share a slot. Publish() blocks while the previous
+// snapshot is still waiting, which keeps simulation at most a frame ahead of
+// rendering and paces the main loop to the render thread.
+class RenderMailbox {
+public:
+    RenderSnapshot& GetWriteSlot() { return m_Slots[m_Write]; }
+
+    void Publish();                     // Writer: hand over the write slot
+    const RenderSnapshot* Acquire();    // Reader: newest published snapshot; nullptr once closed
+    void Close();                       // Wakes both sides; Acquire() returns nullptr from now on
+
+    // Neither thread using the mailbox: drop every slot's contents (and its mesh
+    // references) and reopen it
+    void Reset();
+
+private:
+    static constexpr int SLOT_COUNT = 3;
+
+    RenderSnapshot m_Slots[SLOT_COUNT];
+    int m_Write = 0;
+    int m_Pending = 1;
+    int m_Read = 2;
+    bool m_HasPending = false;
+    bool m_Closed = false;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Published;
+    std::condition_variable m_Consumed;
+};
@@ -0,0 +1,107 @@
+#include "world/compiled_map.h"
+#include "engine_log.h"
+
+// Section [offset, offset + count * stride) must be aligned and lie inside the file
+static bool SectionInBounds(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize) {
+    return (offset % 4) == 0 && offset + count * stride <= fileSize;
+}
+
+bool CompiledMap::Open(FSFileViewPtr file, const std::string& name) {
+    Close();
+
+    if (!file) {
+        ENGINE_LOG_ERROR(World, "[CompiledMap] Failed to open '%s'.", name.c_str());
+        return false;
+    }
+    m_File = std::move(file);
+
+    if (m_File->size < sizeof(CompiledMapHeader)) {
+        ENGINE_LOG_ERROR(World, "[CompiledMap] '%s' is too small to be a compiled map.", name.c_str());
+        Close();
+        return false;
+    }
+
+    const unsigned char* base = m_File->data;
+    m_Header = reinterpret_cast<const CompiledMapHeader*>(base);
+
+    if (m_Header->magic != COMPILED_MAP_MAGIC || m_Header->version != COMPILED_MAP_VERSION) {
+        ENGINE_LOG_ERROR(World, "[CompiledMap] '%s' has bad magic or version %u (expected %u).",
+                  name.c_str(), m_Header->version, COMPILED_MAP_VERSION);
+        Close();
+        return false;
+    }
+
+    m_Entities   = reinterpret_cast<const CompiledMapEntity*>(base + m_Header->entityOffset);
+    m_Geometry   = reinterpret_cast<const CompiledMapGeometry*>(base + m_Header->geometryOffset);
+    m_VertexPool = reinterpret_cast<const float*>(base + m_Header->vertexOffset);
+    m_IndexPool  = reinterpret_cast<const unsigned int*>(base + m_Header->indexOffset);
+    m_Strings    = reinterpret_cast<const char*>(base + m_Header->stringTableOffset);
+
+    if (!Validate()) {
+        ENGINE_LOG_ERROR(World, "[CompiledMap] '%s' failed validation, file is truncated or corrupt.", name.c_str());
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CompiledMap::Close() {
+    m_File.reset();
+    m_Header = nullptr;
+    m_Entities = nullptr;
+    m_Geometry = nullptr;
+    m_VertexPool = nullptr;
+    m_IndexPool = nullptr;
+    m_Strings = nullptr;
+}
+
+const char* CompiledMap::GetString(uint32_t offset) const {
+    if (!m_Header || offset >= m_Header->stringTableSize)
+        return "";
+    return m_Strings + offset;
+}
+
+// Checks every range once so the loader can index the pools without bounds checks
+bool CompiledMap::Validate() const {
+    const CompiledMapHeader& h = *m_Header;
+    const uint64_t fileSize = m_File->size;
+
+    if (h.fileSize != fileSize)
+        return false;
+
+    if (!SectionInBounds(h.entityOffset, h.entityCount, sizeof(CompiledMapEntity), fileSize) ||
+        !SectionInBounds(h.geometryOffset, h.geometryCount, sizeof(CompiledMapGeometry), fileSize) ||
+        !SectionInBounds(h.vertexOffset, h.vertexFloatCount, sizeof(float), fileSize) ||
+        !SectionInBounds(h.indexOffset, h.indexCount, sizeof(uint32_t), fileSize) ||
+        !SectionInBounds(h.stringTableOffset, h.stringTableSize, 1, fileSize))
+        return false;
+
+    // The string table must end in a terminator so GetString can never run off the end
+    if (h.stringTableSize == 0 || m_Strings[h.stringTableSize - 1] != '\0')
+        return false;
+
+    for (uint32_t i = 0; i < h.geometryCount; ++i) {
+        const CompiledMapGeometry& geo = m_Geometry[i];
+        if (uint64_t(geo.firstVertexFloat) + geo.vertexFloatCount > h.vertexFloatCount ||
+            uint64_t(geo.firstIndex) + geo.indexCount > h.indexCount)
+            return false;
+
+        const uint32_t vertexCount = geo.vertexFloatCount / 3;
+        const unsigned int* indices = m_IndexPool + geo.firstIndex;
+        for (uint32_t j = 0; j < geo.indexCount; ++j) {
+            if (indices[j] >= vertexCount)
+                return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < h.entityCount; ++i) {
+        const CompiledMapEntity& ent = m_Entities[i];
+        if (ent.classnameOffset >= h.stringTableSize || ent.modelOffset >= h.stringTableSize)
+            return false;
+        if (ent.geometryIndex >= 0 && uint32_t(ent.geometryIndex) >= h.geometryCount)
+            return false;
+    }
+
+    return true;
+}
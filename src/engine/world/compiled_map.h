@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include "filesystem/file_view.h"
+#include "world/map_format.h"
+
+// Read-only view of a compiled .imapc map.
+// Open() validates a filesystem view of the file once (see FS_OpenMapped) and
+// holds on to it; after that every accessor reads the records in place without
+// allocating. name is only used in log messages.
+class CompiledMap {
+public:
+    bool Open(FSFileViewPtr file, const std::string& name);
+    void Close();
+
+    uint32_t GetEntityCount() const { return m_Header ? m_Header->entityCount : 0; }
+    uint32_t GetGeometryCount() const { return m_Header ? m_Header->geometryCount : 0; }
+
+    const CompiledMapEntity& GetEntity(uint32_t index) const { return m_Entities[index]; }
+    const CompiledMapGeometry& GetGeometry(uint32_t index) const { return m_Geometry[index]; }
+
+    const float* GetVertices(const CompiledMapGeometry& geo) const { return m_VertexPool + geo.firstVertexFloat; }
+    const unsigned int* GetIndices(const CompiledMapGeometry& geo) const { return m_IndexPool + geo.firstIndex; }
+
+    // Strings are NUL-terminated inside the table; out of range offsets yield ""
+    const char* GetString(uint32_t offset) const;
+
+private:
+    bool Validate() const;
+
+    FSFileViewPtr m_File;
+    const CompiledMapHeader* m_Header = nullptr;
+    const CompiledMapEntity* m_Entities = nullptr;
+    const CompiledMapGeometry* m_Geometry = nullptr;
+    const float* m_VertexPool = nullptr;
+    const unsigned int* m_IndexPool = nullptr;
+    const char* m_Strings = nullptr;
+};
@@ -0,0 +1,91 @@
+#include "engine_globals.h"
+#include "world/mesh_cache.h"
+#include "world/mesh_primitives.h"
+#include "engine_log.h"
+
+#include <cstring>
+#include <vector>
+
+static MeshCache g_MeshCache;
+
+MeshCache& GetMeshCache() {
+    return g_MeshCache;
+}
+
+// FNV-1a over the key bytes
+size_t PrimitiveMeshKeyHash::operator()(const PrimitiveMeshKey& key) const {
+    uint32_t words[5];
+    words[0] = static_cast<uint32_t>(key.type);
+    std::memcpy(&words[1], key.params, sizeof(key.params));
+
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(words);
+    for (size_t i = 0; i < sizeof(words); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+}
+
+std::shared_ptr<IGPUMesh> MeshCache::GetPrimitive(const PrimitiveMeshKey& key) {
+    auto it = m_Meshes.find(key);
+    if (it != m_Meshes.end())
+        return it->second;
+
+    std::vector<float> verts;
+    std::vector<unsigned int> indices;
+    geometry::MeshOptimizeReport report;
+
+    if (!geometry::CreateUnitPrimitiveMesh(key.type, key.params, verts, indices, &report)) {
+        ENGINE_LOG_ERROR(Render, "[MeshCache] Unknown primitive type %u (param %.0f).", static_cast<uint32_t>(key.type), key.params[0]);
+        return nullptr;
+    }
+    ENGINE_LOG_DEBUG(Render, "[MeshCache] Primitive type %u optimized: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f.",
+              static_cast<uint32_t>(key.type), report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+
+    return Upload(key, verts.data(), verts.size(), indices.data(), indices.size());
+}
+
+std::shared_ptr<IGPUMesh> MeshCache::GetPrimitive(const PrimitiveMeshKey& key,
+                                                  const float* vertices, size_t vertexFloatCount,
+                                                  const unsigned int* indices, size_t indexCount) {
+    auto it = m_Meshes.find(key);
+    if (it != m_Meshes.end())
+        return it->second;
+
+    return Upload(key, vertices, vertexFloatCount, indices, indexCount);
+}
+
+std::shared_ptr<IGPUMesh> MeshCache::Upload(const PrimitiveMeshKey& key,
+                                            const float* vertices, size_t vertexFloatCount,
+                                            const unsigned int* indices, size_t indexCount) {
+    std::shared_ptr<IGPUMesh> mesh(GetRenderInterface()->CreateMesh());
+
+    try {
+        mesh->Upload(vertices, vertexFloatCount, indices, indexCount);
+    } catch (const std::exception& e) {
+        ENGINE_LOG_ERROR(Render, "[MeshCache] Exception during mesh upload: %s", e.what());
+        return nullptr;
+    } catch (...) {
+        ENGINE_LOG_ERROR(Render, "[MeshCache] Unknown exception during mesh upload.");
+        return nullptr;
+    }
+
+    m_Meshes.emplace(key, mesh);
+    ENGINE_LOG_DEBUG(Render, "[MeshCache] Queued primitive type %u (%zu verts, %zu indices) for upload. Cached meshes: %zu",
+              static_cast<uint32_t>(key.type), vertexFloatCount / 3, indexCount, m_Meshes.size());
+    return mesh;
+}
+
+void MeshCache::ReleaseUnused() {
+    for (auto it = m_Meshes.begin(); it != m_Meshes.end();) {
+        if (it->second.use_count() == 1)
+            it = m_Meshes.erase(it);
+        else
+            ++it;
+    }
+}
+
+void MeshCache::Clear() {
+    m_Meshes.clear();
+}
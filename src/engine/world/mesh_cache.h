@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "shaderapi/igpu_mesh.h"
+#include "world/primitive_mesh_key.h"
+
+// Hands out one shared GPU mesh per distinct primitive, so maps full of
+// identical props upload (and store in VRAM) each shape only once. With unit
+// primitives that means one cube, one plane and one sphere per LOD in total.
+class MeshCache {
+public:
+    // Returns the shared mesh for key, generating it and queueing its upload on first use
+    // (the mesh draws once IGPUMesh::IsReady(), usually a frame or two later)
+    std::shared_ptr<IGPUMesh> GetPrimitive(const PrimitiveMeshKey& key);
+
+    // Same, but the geometry is already baked (e.g. a compiled map's vertex/index pools)
+    std::shared_ptr<IGPUMesh> GetPrimitive(const PrimitiveMeshKey& key,
+                                           const float* vertices, size_t vertexFloatCount,
+                                           const unsigned int* indices, size_t indexCount);
+
+    // Drops meshes no instance references any more (call after a map change)
+    void ReleaseUnused();
+
+    // Drops everything; must run while the render backend is still alive
+    void Clear();
+
+    size_t GetMeshCount() const { return m_Meshes.size(); }
+
+private:
+    std::shared_ptr<IGPUMesh> Upload(const PrimitiveMeshKey& key,
+                                     const float* vertices, size_t vertexFloatCount,
+                                     const unsigned int* indices, size_t indexCount);
+
+    std::unordered_map<PrimitiveMeshKey, std::shared_ptr<IGPUMesh>, PrimitiveMeshKeyHash> m_Meshes;
+};
+
+MeshCache& GetMeshCache();
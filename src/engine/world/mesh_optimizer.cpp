@@ -0,0 +1,347 @@
+#include "world/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace geometry {
+
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize) {
+    VertexCacheStats stats;
+    if (indexCount < 3 || vertexCount == 0)
+        return stats;
+
+    // A vertex is cached while fewer than cacheSize misses happened since its own;
+    // stamps start far enough back that every vertex misses the first time
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    std::vector<char> referenced(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0, unique = 0;
+
+    for (size_t i = 0; i < indexCount; ++i) {
+        const unsigned int v = indices[i];
+        if (time - stamps[v] > cacheSize) {
+            stamps[v] = time++;
+            ++misses;
+        }
+        if (!referenced[v]) {
+            referenced[v] = 1;
+            ++unique;
+        }
+    }
+
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+    return stats;
+}
+
+//-----------------------------------------------------------------------------
+// Forsyth: greedily emit the highest scoring triangle. Vertices score for being
+// recently used (LRU position) and for having few triangles left, so fans get
+// finished instead of leaving stragglers that must be fetched again later.
+//-----------------------------------------------------------------------------
+static constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+
+static float ForsythVertexScore(int32_t cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0)
+        return -1.0f;   // Nothing left to draw with it
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3)
+            score = 0.75f;  // Used by the last triangle; flat so its three vertices rank alike
+        else
+            score = std::pow(1.0f - (cachePosition - 3) * (1.0f / (FORSYTH_CACHE_SIZE - 3)), 1.5f);
+    }
+    return score + 2.0f / std::sqrt(static_cast<float>(liveTriangles));
+}
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2 || vertexCount == 0)
+        return;
+
+    // Vertex -> triangles using it; the first liveTris[v] entries are the ones not emitted yet
+    std::vector<uint32_t> liveTris(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        ++liveTris[indices[i]];
+
+    std::vector<uint32_t> adjOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjOffset[v + 1] = adjOffset[v] + liveTris[v];
+
+    std::vector<uint32_t> adjacency(triCount * 3);
+    std::vector<uint32_t> fill(adjOffset.begin(), adjOffset.end() - 1);
+    for (size_t t = 0; t < triCount; ++t) {
+        for (int k = 0; k < 3; ++k)
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = ForsythVertexScore(-1, liveTris[v]);
+
+    auto triangleScore = [&](size_t t) {
+        return vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    };
+
+    std::vector<char> emitted(triCount, 0);
+    int64_t best = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triCount; ++t) {
+        const float score = triangleScore(t);
+        if (score > bestScore) {
+            bestScore = score;
+            best = static_cast<int64_t>(t);
+        }
+    }
+
+    std::vector<unsigned int> out;
+    out.reserve(triCount * 3);
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t scan = 0;
+
+    while (out.size() < triCount * 3) {
+        // Nothing in the cache has triangles left: restart from the next unemitted triangle
+        if (best < 0) {
+            while (emitted[scan])
+                ++scan;
+            best = static_cast<int64_t>(scan);
+        }
+
+        const size_t t = static_cast<size_t>(best);
+        const unsigned int* tri = indices + t * 3;
+        emitted[t] = 1;
+        out.insert(out.end(), tri, tri + 3);
+
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int v = tri[k];
+            uint32_t* adj = adjacency.data() + adjOffset[v];
+            for (uint32_t j = 0; j < liveTris[v]; ++j) {
+                if (adj[j] == t) {
+                    adj[j] = adj[--liveTris[v]];
+                    break;
+                }
+            }
+        }
+
+        // The triangle's vertices move to the front of the LRU cache
+        size_t newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(newCache, newCache + newCount, tri[k]) == newCache + newCount)
+                newCache[newCount++] = tri[k];
+        }
+        for (size_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2])
+                newCache[newCount++] = v;
+        }
+
+        cacheCount = std::min<size_t>(newCount, FORSYTH_CACHE_SIZE);
+        for (size_t i = 0; i < newCount; ++i) {
+            const uint32_t v = newCache[i];
+            cachePosition[v] = i < cacheCount ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = ForsythVertexScore(cachePosition[v], liveTris[v]);
+            if (i < cacheCount)
+                cache[i] = v;
+        }
+
+        // Only triangles touching the cache changed score; the best of them goes next
+        best = -1;
+        bestScore = -1.0f;
+        for (size_t i = 0; i < cacheCount; ++i) {
+            const uint32_t v = cache[i];
+            const uint32_t* adj = adjacency.data() + adjOffset[v];
+            for (uint32_t j = 0; j < liveTris[v]; ++j) {
+                const float score = triangleScore(adj[j]);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = adj[j];
+                }
+            }
+        }
+    }
+
+    std::memcpy(indices, out.data(), out.size() * sizeof(unsigned int));
+}
+
+//-----------------------------------------------------------------------------
+// Overdraw: split the cache-ordered triangles into clusters that each keep good
+// cache locality, then draw clusters facing away from the mesh centre first, as
+// they are the ones that occlude the rest (Sander et al., "Fast Triangle
+// Reordering for Vertex Locality and Reduced Overdraw").
+//-----------------------------------------------------------------------------
+bool OptimizeOverdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride,
+                      size_t vertexCount, float threshold) {
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2 || vertexCount == 0)
+        return false;
+
+    // Hard boundaries: cache restarts. Soft boundaries: inside a hard cluster, cut
+    // wherever the part so far is already within threshold of the cluster's own ACMR,
+    // so splitting there costs next to nothing. Every cluster is simulated from a
+    // cold cache; bumping time past every stamp flushes it.
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    uint32_t time = VERTEX_CACHE_SIZE + 1;
+    auto countMisses = [&](size_t t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            const unsigned int v = indices[t * 3 + k];
+            if (time - stamps[v] > VERTEX_CACHE_SIZE) {
+                stamps[v] = time++;
+                ++misses;
+            }
+        }
+        return misses;
+    };
+    auto flushCache = [&]() { time += VERTEX_CACHE_SIZE + 1; };
+
+    std::vector<size_t> hardStart;
+    for (size_t t = 0; t < triCount; ++t) {
+        if (countMisses(t) == 3 || t == 0)
+            hardStart.push_back(t);
+    }
+    hardStart.push_back(triCount);
+
+    std::vector<size_t> clusterStart;
+    for (size_t h = 0; h + 1 < hardStart.size(); ++h) {
+        const size_t first = hardStart[h], end = hardStart[h + 1];
+
+        flushCache();
+        size_t misses = 0;
+        for (size_t t = first; t < end; ++t)
+            misses += countMisses(t);
+        const double cutRatio = threshold * static_cast<double>(misses) / static_cast<double>(end - first);
+
+        flushCache();
+        clusterStart.push_back(first);
+        size_t start = first;
+        misses = 0;
+        for (size_t t = first; t < end; ++t) {
+            misses += countMisses(t);
+            if (t + 1 < end && static_cast<double>(misses) <= cutRatio * static_cast<double>(t + 1 - start)) {
+                clusterStart.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                flushCache();
+            }
+        }
+    }
+    if (clusterStart.size() < 2)
+        return false;
+    clusterStart.push_back(triCount);
+
+    auto position = [&](unsigned int v, int c) { return positions[v * positionStride + c]; };
+
+    double meshCentroid[3] = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < triCount * 3; ++i) {
+        for (int c = 0; c < 3; ++c)
+            meshCentroid[c] += position(indices[i], c);
+    }
+    for (int c = 0; c < 3; ++c)
+        meshCentroid[c] /= static_cast<double>(triCount * 3);
+
+    struct Cluster {
+        size_t first, count;
+        double sortKey;
+    };
+    std::vector<Cluster> clusters;
+    clusters.reserve(clusterStart.size() - 1);
+
+    for (size_t ci = 0; ci + 1 < clusterStart.size(); ++ci) {
+        double normal[3] = { 0.0, 0.0, 0.0 }, centroid[3] = { 0.0, 0.0, 0.0 }, area = 0.0;
+        for (size_t t = clusterStart[ci]; t < clusterStart[ci + 1]; ++t) {
+            const unsigned int* tri = indices + t * 3;
+            double e1[3], e2[3], n[3];
+            for (int c = 0; c < 3; ++c) {
+                e1[c] = position(tri[1], c) - position(tri[0], c);
+                e2[c] = position(tri[2], c) - position(tri[0], c);
+            }
+            n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+            n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+            n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+            const double triArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            for (int c = 0; c < 3; ++c) {
+                normal[c] += n[c];
+                centroid[c] += triArea * (position(tri[0], c) + position(tri[1], c) + position(tri[2], c)) / 3.0;
+            }
+            area += triArea;
+        }
+
+        double key = 0.0;
+        const double normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (area > 0.0 && normalLength > 0.0) {
+            for (int c = 0; c < 3; ++c)
+                key += (centroid[c] / area - meshCentroid[c]) * normal[c];
+            key /= normalLength;
+        }
+        clusters.push_back({ clusterStart[ci], clusterStart[ci + 1] - clusterStart[ci], key });
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<unsigned int> reordered;
+    reordered.reserve(triCount * 3);
+    for (const Cluster& cluster : clusters)
+        reordered.insert(reordered.end(), indices + cluster.first * 3, indices + (cluster.first + cluster.count) * 3);
+
+    // Cluster seams cost cache hits; give up the reorder if that costs too much
+    const float before = AnalyzeVertexCache(indices, triCount * 3, vertexCount).acmr;
+    const float after = AnalyzeVertexCache(reordered.data(), reordered.size(), vertexCount).acmr;
+    if (after > before * threshold)
+        return false;
+
+    std::memcpy(indices, reordered.data(), reordered.size() * sizeof(unsigned int));
+    return true;
+}
+
+size_t OptimizeVertexFetch(float* vertices, size_t vertexStride, unsigned int* indices, size_t indexCount,
+                           size_t vertexCount) {
+    constexpr uint32_t UNUSED = 0xFFFFFFFFu;
+    std::vector<uint32_t> remap(vertexCount, UNUSED);
+    uint32_t next = 0;
+
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t& slot = remap[indices[i]];
+        if (slot == UNUSED)
+            slot = next++;
+        indices[i] = slot;
+    }
+
+    std::vector<float> reordered(static_cast<size_t>(next) * vertexStride);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] != UNUSED)
+            std::memcpy(&reordered[remap[v] * vertexStride], vertices + v * vertexStride, vertexStride * sizeof(float));
+    }
+    if (!reordered.empty())
+        std::memcpy(vertices, reordered.data(), reordered.size() * sizeof(float));
+    return next;
+}
+
+MeshOptimizeReport OptimizeMesh(std::vector<float>& verts, size_t vertexStride, std::vector<unsigned int>& indices,
+                                const MeshOptimizeOptions& options) {
+    MeshOptimizeReport report;
+    const size_t vertexCount = verts.size() / vertexStride;
+
+    report.before = AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+
+    OptimizeVertexCache(indices.data(), indices.size(), vertexCount);
+    if (options.overdraw)
+        report.overdrawReordered = OptimizeOverdraw(indices.data(), indices.size(), verts.data(), vertexStride,
+                                                    vertexCount, options.overdrawThreshold);
+
+    const size_t usedCount = OptimizeVertexFetch(verts.data(), vertexStride, indices.data(), indices.size(), vertexCount);
+    verts.resize(usedCount * vertexStride);
+
+    report.after = AnalyzeVertexCache(indices.data(), indices.size(), usedCount);
+    return report;
+}
+
+} // namespace geometry
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Triangle and vertex reordering for indexed triangle lists. None of it changes
+// what is drawn, only the order: fewer vertex shader runs (post-transform cache
+// hits), sequential vertex fetches and, optionally, front-to-back-ish triangle
+// order within the mesh to cut overdraw. Runs offline (mapcompiler) and at load
+// (unit primitives, model cooking); close to linear in the triangle count for
+// meshes of bounded vertex valence (see OptimizeVertexCache).
+namespace geometry {
+
+// FIFO post-transform cache the statistics are measured against; roughly what
+// current GPUs behave like for small vertex outputs
+constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats {
+    float acmr = 0.0f;      // Average cache miss ratio: vertex shader runs per triangle (0.5 ideal, 3 worst)
+    float atvr = 0.0f;      // Average transform to vertex ratio: runs per referenced vertex (1 ideal)
+};
+
+// Simulates a FIFO cache of cacheSize entries over the index list
+VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                    uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// Tom Forsyth's vertex cache optimization, in place. Every emitted triangle
+// rescores the remaining triangles of the vertices in its cache, so the cost is
+// triangles x cache size x valence: near-linear for ordinary meshes, but
+// quadratic in the valence of high-valence hubs such as fan centres and poles.
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+// Reorders triangle clusters (runs the cache order already keeps together) so
+// outward-facing ones come first. Kept only if the ACMR stays within threshold
+// times its previous value; returns whether the order changed.
+bool OptimizeOverdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride,
+                      size_t vertexCount, float threshold = 1.05f);
+
+// Renumbers vertices in order of first use and moves them to match, so the
+// index stream walks the vertex buffer forward. vertexStride is in floats.
+// Unreferenced vertices are dropped; returns the new vertex count.
+size_t OptimizeVertexFetch(float* vertices, size_t vertexStride, unsigned int* indices, size_t indexCount,
+                           size_t vertexCount);
+
+struct MeshOptimizeOptions {
+    bool overdraw = true;
+    float overdrawThreshold = 1.05f;
+};
+
+struct MeshOptimizeReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+    bool overdrawReordered = false;
+};
+
+// All of the above in the right order: cache, overdraw, fetch. Positions are the
+// first 3 floats of every vertexStride-float vertex; verts may shrink.
+MeshOptimizeReport OptimizeMesh(std::vector<float>& verts, size_t vertexStride, std::vector<unsigned int>& indices,
+                                const MeshOptimizeOptions& options = MeshOptimizeOptions());
+
+} // namespace geometry
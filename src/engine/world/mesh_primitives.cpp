@@ -50,6 +50,16 @@ void CreatePlaneMesh(std::vector<float>& verts, std::vector<unsigned int>& indic
 void CreateSphereMesh(std::vector<float>& verts, std::vector<unsigned int>& indices, float radius, int slices, int stacks) {
     verts.clear();
     indices.clear();
+    verts.reserve((size_t)(stacks + 1) * (slices + 1) * 3);
+    indices.reserve((size_t)stacks * slices * 6);
+
+    // Ring directions are the same for every stack, so evaluate them once
+    std::vector<float> ringCos(slices + 1), ringSin(slices + 1);
+    for (int slice = 0; slice <= slices; ++slice) {
+        float theta = (float)slice / slices * 2.0f * math::PI;
+        ringCos[slice] = cosf(theta);
+        ringSin[slice] = sinf(theta);
+    }
 
     for (int stack = 0; stack <= stacks; ++stack) {
         float phi = (float)stack / stacks * math::PI;
@@ -57,12 +67,9 @@ void CreateSphereMesh(std::vector<float>& verts, std::vector<unsigned int>& indi
         float r = radius * sinf(phi);
 
         for (int slice = 0; slice <= slices; ++slice) {
-            float theta = (float)slice / slices * 2.0f * math::PI;
-            float x = r * cosf(theta);
-            float z = r * sinf(theta);
-            verts.push_back(x);
+            verts.push_back(r * ringCos[slice]);
             verts.push_back(y);
-            verts.push_back(z);
+            verts.push_back(r * ringSin[slice]);
         }
     }
 
@@ -82,4 +89,60 @@ void CreateSphereMesh(std::vector<float>& verts, std::vector<unsigned int>& indi
     }
 }
 
+int SelectSphereLOD(int slices, int stacks) {
+    for (int lod = 0; lod < SPHERE_LOD_COUNT; ++lod) {
+        if (SPHERE_LODS[lod].slices >= slices && SPHERE_LODS[lod].stacks >= stacks)
+            return lod;
+    }
+    return SPHERE_LOD_COUNT - 1;
+}
+
+void MakeUnitPrimitive(CompiledGeometryType type, const float params[4], float unitParams[4], Vector3_f& scale) {
+    unitParams[0] = unitParams[1] = unitParams[2] = unitParams[3] = 0.0f;
+    scale = Vector3_f(1.0f, 1.0f, 1.0f);
+
+    switch (type) {
+        case CompiledGeometryType::Cube:
+            scale = Vector3_f(params[0], params[1], params[2]);
+            break;
+        case CompiledGeometryType::Plane:
+            scale = Vector3_f(params[0], 1.0f, params[2]);
+            break;
+        case CompiledGeometryType::Sphere:
+            scale = Vector3_f(params[0], params[0], params[0]);
+            unitParams[0] = (float)SelectSphereLOD((int)params[1], (int)params[2]);
+            break;
+        default:
+            break;
+    }
+}
+
+bool CreateUnitPrimitiveMesh(CompiledGeometryType type, const float unitParams[4],
+                             std::vector<float>& verts, std::vector<unsigned int>& indices,
+                             MeshOptimizeReport* report) {
+    switch (type) {
+        case CompiledGeometryType::Cube:
+            CreateCubeMesh(verts, indices, Vector3_f(1.0f, 1.0f, 1.0f));
+            break;
+        case CompiledGeometryType::Plane:
+            CreatePlaneMesh(verts, indices, Vector3_f(1.0f, 0.0f, 1.0f));
+            break;
+        case CompiledGeometryType::Sphere: {
+            int lod = (int)unitParams[0];
+            if (lod < 0 || lod >= SPHERE_LOD_COUNT)
+                return false;
+            CreateSphereMesh(verts, indices, 1.0f, SPHERE_LODS[lod].slices, SPHERE_LODS[lod].stacks);
+            break;
+        }
+        default:
+            return false;
+    }
+
+    // Generated stack/slice order thrashes the vertex cache; every primitive goes out reordered
+    MeshOptimizeReport optimized = OptimizeMesh(verts, 3, indices);
+    if (report)
+        *report = optimized;
+    return true;
+}
+
 } // namespace geometry
\ No newline at end of file
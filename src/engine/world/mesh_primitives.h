@@ -2,9 +2,40 @@
 
 #include <vector>
 #include "mathlib/vector3_f.h"
+#include "world/map_format.h"
+#include "world/mesh_optimizer.h"
 
 namespace geometry {
 
+// Canonical sphere tessellations. Spheres are generated once per LOD at unit
+// radius; the actual radius is carried as scale in the instance transform.
+struct SphereLOD {
+    int slices;
+    int stacks;
+};
+
+constexpr SphereLOD SPHERE_LODS[] = {
+    { 16,  8 },
+    { 32, 16 },
+    { 48, 24 },
+    { 64, 32 }
+};
+constexpr int SPHERE_LOD_COUNT = sizeof(SPHERE_LODS) / sizeof(SPHERE_LODS[0]);
+
+// Lowest LOD at least as fine as the requested tessellation (highest LOD if none is)
+int SelectSphereLOD(int slices, int stacks);
+
+// Maps authored primitive parameters (cube/plane size xyz, sphere radius/slices/stacks)
+// to the canonical unit primitive plus the scale that restores the authored size.
+// unitParams follow the PrimitiveMeshKey layout: sphere stores its LOD in [0], cube/plane store nothing.
+void MakeUnitPrimitive(CompiledGeometryType type, const float params[4], float unitParams[4], Vector3_f& scale);
+
+// Generates the canonical unit mesh for a MakeUnitPrimitive() result, in optimized
+// triangle/vertex order (see OptimizeMesh); report, if given, receives the cache statistics
+bool CreateUnitPrimitiveMesh(CompiledGeometryType type, const float unitParams[4],
+                             std::vector<float>& verts, std::vector<unsigned int>& indices,
+                             MeshOptimizeReport* report = nullptr);
+
 // Fills verts and indices with cube mesh data (centered at origin)
 void CreateCubeMesh(std::vector<float>& verts, std::vector<unsigned int>& indices, const Vector3_f& size);
 
@@ -0,0 +1,307 @@
+#include "engine_globals.h"
+#include "world/model_cache.h"
+#include "world/model_format.h"
+#include "world/mesh_optimizer.h"
+#include "world/model_source.h"
+#include "engine_log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static ModelCache g_ModelCache;
+
+ModelCache& GetModelCache() {
+    return g_ModelCache;
+}
+
+// FNV-1a, enough to notice an edited source
+static uint64_t HashBytes(const unsigned char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Maps may spell a model path with any case and either slash; every spelling shares one entry
+static std::string NormalizeModelPath(const std::string& path) {
+    std::string key = path;
+    for (char& c : key)
+        c = (c == '\\') ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return key;
+}
+
+// A model cooked in memory, viewed the same way as one read back from disk
+struct CookedModelBuffer : FSFileView {
+    std::vector<unsigned char> bytes;
+};
+
+// Section [offset, offset + count * stride) must be aligned and lie inside the file
+static bool SectionInBounds(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize) {
+    return (offset % 4) == 0 && offset + count * stride <= fileSize;
+}
+
+// Checks every range once so the loader can read the sections without bounds checks;
+// nullptr if the file is truncated, corrupt or from another version
+static const ModelHeader* ReadCookedHeader(const FSFileView& file) {
+    if (file.size < sizeof(ModelHeader))
+        return nullptr;
+
+    const ModelHeader* h = reinterpret_cast<const ModelHeader*>(file.data);
+    if (h->magic != MODEL_MAGIC || h->version != MODEL_VERSION || h->fileSize != file.size)
+        return nullptr;
+
+    if ((h->indexSize != 2 && h->indexSize != 4) || h->indexCount % 3 != 0 ||
+        !SectionInBounds(h->vertexOffset, h->vertexCount, sizeof(ModelVertex), file.size) ||
+        !SectionInBounds(h->indexOffset, h->indexCount, h->indexSize, file.size) ||
+        h->materialOffset >= file.size || file.data[file.size - 1] != '\0')
+        return nullptr;
+
+    const unsigned char* indices = file.data + h->indexOffset;
+    for (uint32_t i = 0; i < h->indexCount; ++i) {
+        uint32_t index;
+        if (h->indexSize == 2) {
+            uint16_t index16;
+            std::memcpy(&index16, indices + i * 2, sizeof(index16));
+            index = index16;
+        } else {
+            std::memcpy(&index, indices + i * 4, sizeof(index));
+        }
+        if (index >= h->vertexCount)
+            return nullptr;
+    }
+
+    return h;
+}
+
+void ModelCache::Init(FSOpenMappedFn openFile, const std::string& cacheRoot) {
+    m_OpenFile = openFile;
+    m_CacheRoot = cacheRoot;
+}
+
+std::shared_ptr<const Model> ModelCache::Load(const std::string& path) {
+    const std::string key = NormalizeModelPath(path);
+
+    auto it = m_Models.find(key);
+    if (it != m_Models.end())
+        return it->second;
+
+    std::shared_ptr<Model> model = LoadUncached(key);
+    m_Models.emplace(key, model);
+    return model;
+}
+
+std::shared_ptr<Model> ModelCache::LoadUncached(const std::string& path) {
+    if (!m_OpenFile) {
+        ENGINE_LOG_ERROR(World, "[ModelCache] Load of '%s' before Init.", path.c_str());
+        return nullptr;
+    }
+
+    const std::string cookedRelative = "cache/models/" + path + "c";
+    FSFileViewPtr source = m_OpenFile("models/" + path);
+    FSFileViewPtr cooked = m_OpenFile(cookedRelative);
+
+    // With no source around (e.g. a release that ships only the cache), the cooked file is taken as is
+    const uint64_t sourceHash = source ? HashBytes(source->data, source->size) : 0;
+    const ModelHeader* header = cooked ? ReadCookedHeader(*cooked) : nullptr;
+    if (cooked && !header)
+        ENGINE_LOG_WARNING(World, "[ModelCache] Cooked '%s' is corrupt or outdated, cooking again.", cookedRelative.c_str());
+
+    if (header && source && (header->sourceHash != sourceHash || header->sourceSize != source->size)) {
+        ENGINE_LOG_DEBUG(World, "[ModelCache] '%s' changed since it was cooked.", path.c_str());
+        header = nullptr;
+    }
+
+    if (!header) {
+        if (!source) {
+            ENGINE_LOG_WARNING(World, "[ModelCache] Model not found: models/%s", path.c_str());
+            return nullptr;
+        }
+
+        cooked = Cook(path, *source, sourceHash);
+        if (!cooked)
+            return nullptr;
+
+        WriteCooked(cookedRelative, *cooked);
+        header = ReadCookedHeader(*cooked);
+        if (!header)
+            return nullptr;
+    }
+
+    auto model = std::make_shared<Model>();
+    model->path = path;
+    model->material = reinterpret_cast<const char*>(cooked->data + header->materialOffset);
+    model->boundsMin = Vector3_f(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    model->boundsMax = Vector3_f(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    model->boundsRadius = header->boundsRadius;
+    model->vertexCount = header->vertexCount;
+    model->indexCount = header->indexCount;
+
+    // The cooked float vertices go up packed: half positions, 10:10:10:2 normals, 16-bit UVs
+    const ModelVertex* vertices = reinterpret_cast<const ModelVertex*>(cooked->data + header->vertexOffset);
+    vertexpack::MeshSource src;
+    src.positions = vertices->position;
+    src.positionStride = sizeof(ModelVertex) / sizeof(float);
+    src.normals = vertices->normal;
+    src.normalStride = src.positionStride;
+    src.uvs = vertices->uv;
+    src.uvStride = src.positionStride;
+    src.vertexCount = header->vertexCount;
+    src.indices = cooked->data + header->indexOffset;
+    src.indexFormat = header->indexSize == 2 ? IndexFormat::UInt16 : IndexFormat::UInt32;
+    src.indexCount = header->indexCount;
+
+    vertexpack::PackedMesh packed;
+    vertexpack::PackMesh(src, packed);
+
+    model->mesh.reset(GetRenderInterface()->CreateMesh());
+    try {
+        model->mesh->Upload(packed.GetData());
+    } catch (const std::exception& e) {
+        ENGINE_LOG_ERROR(Render, "[ModelCache] Exception during upload of '%s': %s", path.c_str(), e.what());
+        return nullptr;
+    } catch (...) {
+        ENGINE_LOG_ERROR(Render, "[ModelCache] Unknown exception during upload of '%s'.", path.c_str());
+        return nullptr;
+    }
+
+    ENGINE_LOG_DEBUG(World, "[ModelCache] Loaded '%s' (%u verts, %u indices, %u-bit). Cached models: %zu",
+              path.c_str(), model->vertexCount, model->indexCount, header->indexSize * 8, m_Models.size() + 1);
+    return model;
+}
+
+// Source parsing is shared with meshstats (see model_source.h)
+FSFileViewPtr ModelCache::Cook(const std::string& path, const FSFileView& source, uint64_t sourceHash) {
+    ModelSource model;
+    std::string error;
+    if (!ParseModelSource(source.data, source.size, model, error)) {
+        ENGINE_LOG_ERROR(World, "[ModelCache] models/%s %s.", path.c_str(), error.c_str());
+        return nullptr;
+    }
+
+    constexpr size_t VERTEX_FLOATS = sizeof(ModelVertex) / sizeof(float);
+    std::vector<float>& vertexFloats = model.vertexFloats;
+    std::vector<unsigned int>& indices = model.indices;
+
+    // Authored order is whatever the exporter wrote; cook it into cache-friendly order once
+    const geometry::MeshOptimizeReport report = geometry::OptimizeMesh(vertexFloats, VERTEX_FLOATS, indices);
+    std::vector<ModelVertex> vertices(vertexFloats.size() / VERTEX_FLOATS);
+    std::memcpy(vertices.data(), vertexFloats.data(), vertices.size() * sizeof(ModelVertex));
+
+    const std::string& material = model.material;
+
+    ModelHeader header = {};
+    header.magic = MODEL_MAGIC;
+    header.version = MODEL_VERSION;
+    header.sourceHash = sourceHash;
+    header.sourceSize = static_cast<uint32_t>(source.size);
+    header.vertexCount = static_cast<uint32_t>(vertices.size());
+    header.indexCount = static_cast<uint32_t>(indices.size());
+    header.indexSize = vertices.size() <= 0x10000 ? 2 : 4;
+
+    for (int c = 0; c < 3; ++c) {
+        header.boundsMin[c] = vertices[0].position[c];
+        header.boundsMax[c] = vertices[0].position[c];
+    }
+    for (const ModelVertex& v : vertices) {
+        for (int c = 0; c < 3; ++c) {
+            header.boundsMin[c] = std::min(header.boundsMin[c], v.position[c]);
+            header.boundsMax[c] = std::max(header.boundsMax[c], v.position[c]);
+        }
+    }
+
+    float radiusSq = 0.0f;
+    for (const ModelVertex& v : vertices) {
+        float distSq = 0.0f;
+        for (int c = 0; c < 3; ++c) {
+            const float d = v.position[c] - 0.5f * (header.boundsMin[c] + header.boundsMax[c]);
+            distSq += d * d;
+        }
+        radiusSq = std::max(radiusSq, distSq);
+    }
+    header.boundsRadius = std::sqrt(radiusSq);
+
+    uint32_t offset = sizeof(ModelHeader);
+    auto place = [&offset](size_t bytes) {
+        uint32_t start = offset;
+        offset += static_cast<uint32_t>((bytes + 3) & ~size_t(3)); // Keep every section 4-byte aligned
+        return start;
+    };
+
+    header.vertexOffset = place(vertices.size() * sizeof(ModelVertex));
+    header.indexOffset = place(indices.size() * header.indexSize);
+    header.materialOffset = place(material.size() + 1);
+    header.fileSize = offset;
+
+    auto cooked = std::make_shared<CookedModelBuffer>();
+    cooked->bytes.assign(header.fileSize, 0);
+    unsigned char* out = cooked->bytes.data();
+
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + header.vertexOffset, vertices.data(), vertices.size() * sizeof(ModelVertex));
+    if (header.indexSize == 2) {
+        for (size_t i = 0; i < indices.size(); ++i) {
+            const uint16_t index16 = static_cast<uint16_t>(indices[i]);
+            std::memcpy(out + header.indexOffset + i * 2, &index16, sizeof(index16));
+        }
+    } else {
+        std::memcpy(out + header.indexOffset, indices.data(), indices.size() * sizeof(uint32_t));
+    }
+    std::memcpy(out + header.materialOffset, material.c_str(), material.size() + 1);
+
+    cooked->data = cooked->bytes.data();
+    cooked->size = cooked->bytes.size();
+
+    ENGINE_LOG_INFO(World, "[ModelCache] Cooked models/%s (%zu verts, %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f).",
+              path.c_str(), vertices.size(), indices.size() / 3,
+              report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+    return cooked;
+}
+
+// Written to a temp file and renamed, so a crash never leaves a half-written cache behind.
+// Failing to write only costs a cook on the next run.
+void ModelCache::WriteCooked(const std::string& cookedRelative, const FSFileView& cooked) const {
+    namespace fs = std::filesystem;
+
+    const fs::path target = fs::path(m_CacheRoot) / cookedRelative;
+    const fs::path temp = fs::path(target).concat(".tmp");
+
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (out.is_open())
+            out.write(reinterpret_cast<const char*>(cooked.data), static_cast<std::streamsize>(cooked.size));
+        if (!out.is_open() || !out.good()) {
+            ENGINE_LOG_WARNING(World, "[ModelCache] Failed to write %s", temp.string().c_str());
+            return;
+        }
+    }
+
+    fs::rename(temp, target, ec);
+    if (ec) {
+        ENGINE_LOG_WARNING(World, "[ModelCache] Failed to move %s into place: %s", target.string().c_str(), ec.message().c_str());
+        fs::remove(temp, ec);
+    }
+}
+
+void ModelCache::ReleaseUnused() {
+    for (auto it = m_Models.begin(); it != m_Models.end();) {
+        // Failed loads go too, so the next map gets to retry them
+        if (!it->second || (it->second.use_count() == 1 && it->second->mesh.use_count() == 1))
+            it = m_Models.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ModelCache::Clear() {
+    m_Models.clear();
+}
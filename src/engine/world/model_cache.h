@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "filesystem/file_view.h"
+#include "mathlib/vector3_f.h"
+#include "shaderapi/igpu_mesh.h"
+
+// A loaded .imdl model. Every prop_static that names the same path shares one.
+struct Model {
+    std::string path;                   // Relative to models/, as normalized by ModelCache
+    std::string material;
+    std::shared_ptr<IGPUMesh> mesh;
+
+    Vector3_f boundsMin;
+    Vector3_f boundsMax;
+    float boundsRadius = 0.0f;
+
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+};
+
+// Loads models by path and keeps one copy of each. A model is cooked from its
+// JSON source into cache/models/<path>c (see world/model_format.h) the first
+// time it loads; later loads read the cooked file and skip JSON entirely.
+class ModelCache {
+public:
+    // cacheRoot is the game directory; cooked files are written below it
+    void Init(FSOpenMappedFn openFile, const std::string& cacheRoot);
+
+    // path is relative to models/, e.g. "dev/testcube.imdl". Returns the shared
+    // model, or nullptr if it can't be loaded (failures are remembered too, so a
+    // broken model logs once rather than once per instance).
+    std::shared_ptr<const Model> Load(const std::string& path);
+
+    // Drops models no instance references any more (call after a map change)
+    void ReleaseUnused();
+
+    // Drops everything; must run while the render backend is still alive
+    void Clear();
+
+    size_t GetModelCount() const { return m_Models.size(); }
+
+private:
+    std::shared_ptr<Model> LoadUncached(const std::string& path);
+    FSFileViewPtr Cook(const std::string& path, const FSFileView& source, uint64_t sourceHash);
+    void WriteCooked(const std::string& cookedRelative, const FSFileView& cooked) const;
+
+    FSOpenMappedFn m_OpenFile = nullptr;
+    std::string m_CacheRoot;
+    std::unordered_map<std::string, std::shared_ptr<Model>> m_Models;
+};
+
+ModelCache& GetModelCache();
@@ -0,0 +1,66 @@
+#include "world/model_source.h"
+#include "world/model_format.h"
+
+#include <cstdint>
+#include <exception>
+#include <nlohmann/json.hpp>
+
+bool ParseModelSource(const void* data, size_t size, ModelSource& out, std::string& error) {
+    out = ModelSource();
+
+    nlohmann::json json;
+    try {
+        const char* text = static_cast<const char*>(data);
+        json = nlohmann::json::parse(text, text + size);
+    } catch (const std::exception& e) {
+        error = std::string("is not valid JSON: ") + e.what();
+        return false;
+    }
+
+    if (!json.contains("vertices") || !json["vertices"].is_array() ||
+        !json.contains("triangles") || !json["triangles"].is_array()) {
+        error = "needs 'vertices' and 'triangles' arrays";
+        return false;
+    }
+
+    constexpr size_t VERTEX_FLOATS = sizeof(ModelVertex) / sizeof(float);
+    try {
+        for (const auto& v : json["vertices"]) {
+            if (!v.is_array() || v.size() < 3) {
+                error = "has a vertex with fewer than 3 components";
+                return false;
+            }
+            float vertex[VERTEX_FLOATS] = {};
+            for (size_t c = 0; c < VERTEX_FLOATS && c < v.size(); ++c)
+                vertex[c] = v[c].get<float>();
+            out.vertexFloats.insert(out.vertexFloats.end(), vertex, vertex + VERTEX_FLOATS);
+        }
+
+        const int64_t vertexCount = static_cast<int64_t>(out.vertexFloats.size() / VERTEX_FLOATS);
+        for (const auto& tri : json["triangles"]) {
+            if (!tri.is_array() || tri.size() != 3) {
+                error = "has a triangle without 3 indices";
+                return false;
+            }
+            for (const auto& index : tri) {
+                const int64_t value = index.get<int64_t>();
+                if (value < 0 || value >= vertexCount) {
+                    error = "has index " + std::to_string(value) + " out of range";
+                    return false;
+                }
+                out.indices.push_back(static_cast<uint32_t>(value));
+            }
+        }
+
+        out.material = json.value("material", "");
+    } catch (const std::exception& e) {
+        error = std::string("has a bad value: ") + e.what();
+        return false;
+    }
+
+    if (out.vertexFloats.empty() || out.indices.empty()) {
+        error = "has no geometry";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// .imdl source model as read by ModelCache::Cook and meshstats, so the tool
+// measures exactly what the engine cooks.
+//
+// .imdl JSON: "vertices" is a list of [px, py, pz, nx, ny, nz, u, v] (normal and uv
+// optional), "triangles" a list of [a, b, c] vertex indices, "material" a name
+struct ModelSource {
+    std::vector<float> vertexFloats;    // ModelVertex after ModelVertex, the form OptimizeMesh takes
+    std::vector<unsigned int> indices;
+    std::string material;
+};
+
+// Parses and validates size bytes of .imdl JSON. On failure returns false with a
+// message (no file name) in error.
+bool ParseModelSource(const void* data, size_t size, ModelSource& out, std::string& error);
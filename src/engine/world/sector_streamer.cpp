@@ -0,0 +1,398 @@
+#include "world/sector_streamer.h"
+#include "world/compiled_map.h"
+#include "world/mesh_cache.h"
+#include "world/mesh_primitives.h"
+#include "engine_log.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+static SectorStreamer g_SectorStreamer;
+
+SectorStreamer& GetSectorStreamer() {
+    return g_SectorStreamer;
+}
+
+static int SectorDistance(const SectorCoord& a, const SectorCoord& b) {
+    return std::max({ std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z) });
+}
+
+SectorStreamer::~SectorStreamer() {
+    Shutdown();
+}
+
+SectorCoord SectorStreamer::WorldToSector(const Vector3_d& position, double sectorSize) {
+    SectorCoord coord;
+    coord.x = static_cast<int32_t>(std::floor(position.x / sectorSize));
+    coord.y = static_cast<int32_t>(std::floor(position.y / sectorSize));
+    coord.z = static_cast<int32_t>(std::floor(position.z / sectorSize));
+    return coord;
+}
+
+// space_sector_-01_00_00.imap: two digits per axis, minus sign only when negative
+std::string SectorStreamer::SectorFileName(const std::string& prefix, const SectorCoord& coord) {
+    auto axis = [](int32_t v) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%s%02d", v < 0 ? "-" : "", std::abs(v));
+        return std::string(buf);
+    };
+    return prefix + "_" + axis(coord.x) + "_" + axis(coord.y) + "_" + axis(coord.z) + ".imap";
+}
+
+//-----------------------------------------------------------------------------
+// Lifetime
+//-----------------------------------------------------------------------------
+void SectorStreamer::Init(FSOpenMappedFn openFile, FSReadAsyncFn readAsync, FSCancelAsyncFn cancelAsync,
+                          const Settings& settings) {
+    Shutdown();
+
+    m_OpenFile = openFile;
+    m_ReadAsync = readAsync;
+    m_CancelAsync = cancelAsync;
+    m_Settings = settings;
+    m_Settings.unloadRadius = std::max(m_Settings.unloadRadius, m_Settings.loadRadius);
+    m_HasCameraSector = false;
+    m_Quit = false;
+    m_Worker = std::thread(&SectorStreamer::WorkerMain, this);
+
+    ENGINE_LOG_INFO(Streaming, "[SectorStreamer] Started: sector size %.0f, load radius %d, unload radius %d.",
+              m_Settings.sectorSize, m_Settings.loadRadius, m_Settings.unloadRadius);
+}
+
+void SectorStreamer::Shutdown() {
+    if (m_Worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+            m_Requests.clear();
+        }
+        m_Wake.notify_all();
+        m_Worker.join();
+    }
+
+    for (auto& entry : m_Sectors)
+        UnloadSector(entry.first, entry.second);
+    m_Sectors.clear();
+    m_Completed.clear();
+
+    if (m_CancelAsync) {
+        for (const auto& entry : m_Prefetches)
+            m_CancelAsync(entry.second);
+    }
+    m_Prefetches.clear();
+
+    m_OpenFile = nullptr;
+    m_ReadAsync = nullptr;
+    m_CancelAsync = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Main thread
+//-----------------------------------------------------------------------------
+void SectorStreamer::Update(const Vector3_d& cameraWorldPosition) {
+    if (!m_OpenFile)
+        return;
+
+    const SectorCoord cameraSector = WorldToSector(cameraWorldPosition, m_Settings.sectorSize);
+    if (!m_HasCameraSector || cameraSector != m_CameraSector) {
+        m_CameraSector = cameraSector;
+        m_HasCameraSector = true;
+
+        for (auto it = m_Sectors.begin(); it != m_Sectors.end();) {
+            if (SectorDistance(it->first, cameraSector) > m_Settings.unloadRadius) {
+                UnloadSector(it->first, it->second);
+                it = m_Sectors.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        const int r = m_Settings.loadRadius;
+        for (int dz = -r; dz <= r; ++dz)
+            for (int dy = -r; dy <= r; ++dy)
+                for (int dx = -r; dx <= r; ++dx) {
+                    SectorCoord coord{ cameraSector.x + dx, cameraSector.y + dy, cameraSector.z + dz };
+                    if (m_Sectors.find(coord) == m_Sectors.end())
+                        RequestSector(coord);
+                }
+
+        SortRequestsByDistance();
+        m_Wake.notify_one();
+
+        UpdatePrefetches();
+    }
+
+    CollectCompleted();
+    ActivateStaged();
+}
+
+void SectorStreamer::RequestSector(const SectorCoord& coord) {
+    Sector& sector = m_Sectors[coord];
+    sector.state = SectorState::Loading;
+    sector.requestId = m_NextRequestId++;
+    sector.group = m_NextGroup++;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Requests.push_back({ coord, sector.requestId });
+}
+
+void SectorStreamer::UnloadSector(const SectorCoord& coord, Sector& sector) {
+    if (sector.state == SectorState::Loading) {
+        // Still queued: drop the request. Already on the worker: the result is discarded on arrival.
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.erase(std::remove_if(m_Requests.begin(), m_Requests.end(),
+            [&](const LoadRequest& r) { return r.requestId == sector.requestId; }), m_Requests.end());
+        return;
+    }
+
+    sector.staged.reset();
+    ReleaseStaticGeometryInstances(sector.activated);   // Activation cut short
+    if (sector.instanceCount == 0)
+        return; // Empty sectors are the common case; nothing was registered
+
+    RemoveStaticGeometryGroup(sector.group);
+    ENGINE_LOG_DEBUG(Streaming, "[SectorStreamer] Unloaded sector (%d, %d, %d).", coord.x, coord.y, coord.z);
+}
+
+// Reads the files of the ring just outside the load radius into memory on the FS
+// I/O threads; the views are dropped right away but the pages stay cached, so
+// the worker's later open and parse doesn't block on disk.
+void SectorStreamer::UpdatePrefetches() {
+    if (!m_ReadAsync)
+        return;
+
+    const SectorCoord center = m_CameraSector;
+    for (auto it = m_Prefetches.begin(); it != m_Prefetches.end();) {
+        const int distance = SectorDistance(it->first, center);
+        if (distance <= m_Settings.loadRadius || distance > m_Settings.prefetchRadius) {
+            if (m_CancelAsync)
+                m_CancelAsync(it->second); // No-op if it already ran
+            it = m_Prefetches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const int r = m_Settings.prefetchRadius;
+    for (int dz = -r; dz <= r; ++dz)
+        for (int dy = -r; dy <= r; ++dy)
+            for (int dx = -r; dx <= r; ++dx) {
+                SectorCoord coord{ center.x + dx, center.y + dy, center.z + dz };
+                if (SectorDistance(coord, center) <= m_Settings.loadRadius ||
+                    m_Sectors.count(coord) || m_Prefetches.count(coord))
+                    continue;
+
+                const FSAsyncHandle handle = m_ReadAsync(SectorFileName(m_Settings.filePrefix, coord),
+                                                         FSReadPriority::Prefetch, nullptr);
+                if (handle)
+                    m_Prefetches.emplace(coord, handle);
+            }
+}
+
+// Nearest sectors first, so the one the camera is in never waits behind the ring
+void SectorStreamer::SortRequestsByDistance() {
+    const SectorCoord center = m_CameraSector;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::stable_sort(m_Requests.begin(), m_Requests.end(), [&](const LoadRequest& a, const LoadRequest& b) {
+        return SectorDistance(a.coord, center) < SectorDistance(b.coord, center);
+    });
+}
+
+void SectorStreamer::CollectCompleted() {
+    std::vector<std::unique_ptr<StagedSector>> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        completed.swap(m_Completed);
+    }
+
+    for (auto& staged : completed) {
+        auto it = m_Sectors.find(staged->coord);
+        if (it == m_Sectors.end() || it->second.state != SectorState::Loading ||
+            it->second.requestId != staged->requestId)
+            continue; // Unloaded (or re-requested) while the worker was busy
+
+        Sector& sector = it->second;
+        if (staged->instances.empty()) {
+            sector.state = SectorState::Resident;
+            continue;
+        }
+
+        sector.state = SectorState::Activating;
+        sector.staged = std::move(staged);
+        sector.activateCursor = 0;
+    }
+}
+
+// The mesh cache and the instance list are main-thread state, so registration happens
+// here, a slice per frame, instead of on the worker. GPU uploads are queued again behind
+// the render backend's own per-frame budget.
+void SectorStreamer::ActivateStaged() {
+    PROFILE_SCOPE("SectorStreamer::Activate");
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() +
+        std::chrono::microseconds(static_cast<long long>(m_Settings.activateBudgetMs * 1000.0));
+
+    // Nearest first, so a far sector never holds up the one the camera is in
+    std::vector<std::pair<int, SectorCoord>> order;
+    for (const auto& entry : m_Sectors) {
+        if (entry.second.state == SectorState::Activating)
+            order.emplace_back(SectorDistance(entry.first, m_CameraSector), entry.first);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<int, SectorCoord>& a, const std::pair<int, SectorCoord>& b) {
+        return a.first < b.first;
+    });
+
+    for (const auto& entry : order) {
+        const SectorCoord& coord = entry.second;
+        Sector& sector = m_Sectors[coord];
+        StagedSector& staged = *sector.staged;
+        while (sector.activateCursor < staged.instances.size()) {
+            const size_t i = sector.activateCursor++;
+            const StagedPrimitive& prim = staged.primitives[staged.instancePrimitive[i]];
+
+            std::shared_ptr<IGPUMesh> mesh = GetMeshCache().GetPrimitive(prim.key,
+                prim.vertices.data(), prim.vertices.size(), prim.indices.data(), prim.indices.size());
+            if (mesh)
+                sector.activated.push_back(MakeStaticGeometryInstance(staged.instances[i], std::move(mesh), sector.group));
+
+            if (Clock::now() >= deadline)
+                return;
+        }
+
+        // One change to the static list per sector, so the draw list rebuilds once
+        sector.instanceCount = sector.activated.size();
+        AddStaticGeometryInstances(std::move(sector.activated));
+        ENGINE_LOG_DEBUG(Streaming, "[SectorStreamer] Sector (%d, %d, %d) resident: %zu instances.",
+                  coord.x, coord.y, coord.z, sector.instanceCount);
+        sector.state = SectorState::Resident;
+        sector.staged.reset();
+    }
+}
+
+size_t SectorStreamer::GetResidentSectorCount() const {
+    size_t count = 0;
+    for (const auto& entry : m_Sectors)
+        count += entry.second.state == SectorState::Resident;
+    return count;
+}
+
+size_t SectorStreamer::GetPendingSectorCount() const {
+    return m_Sectors.size() - GetResidentSectorCount();
+}
+
+//-----------------------------------------------------------------------------
+// Worker thread
+//-----------------------------------------------------------------------------
+void SectorStreamer::WorkerMain() {
+    PROFILE_THREAD_NAME("SectorStreamer");
+    for (;;) {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this] { return m_Quit || !m_Requests.empty(); });
+            if (m_Quit)
+                return;
+            request = m_Requests.front();
+            m_Requests.pop_front();
+        }
+
+        std::unique_ptr<StagedSector> staged = LoadSector(request);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Completed.push_back(std::move(staged));
+    }
+}
+
+static uint32_t FindOrAddPrimitive(std::vector<PrimitiveMeshKey>& keys, const PrimitiveMeshKey& key, bool& added) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (keys[i] == key) {
+            added = false;
+            return static_cast<uint32_t>(i);
+        }
+    }
+    keys.push_back(key);
+    added = true;
+    return static_cast<uint32_t>(keys.size() - 1);
+}
+
+std::unique_ptr<SectorStreamer::StagedSector> SectorStreamer::LoadSector(const LoadRequest& request) const {
+    PROFILE_SCOPE("SectorStreamer::LoadSector");
+    auto staged = std::make_unique<StagedSector>();
+    staged->coord = request.coord;
+    staged->requestId = request.requestId;
+
+    const std::string path = SectorFileName(m_Settings.filePrefix, request.coord);
+    FSFileViewPtr file = m_OpenFile(path);
+    if (!file || file->size < sizeof(uint32_t))
+        return staged; // Missing or empty file: empty sector
+
+    const Vector3_d sectorOrigin(request.coord.x * m_Settings.sectorSize,
+                                 request.coord.y * m_Settings.sectorSize,
+                                 request.coord.z * m_Settings.sectorSize);
+
+    uint32_t magic = 0;
+    std::memcpy(&magic, file->data, sizeof(magic));
+
+    std::vector<PrimitiveMeshKey> keys;
+    auto addInstance = [&](StaticInstanceDesc& desc, bool& newPrimitive) {
+        desc.position += sectorOrigin;
+        const uint32_t prim = FindOrAddPrimitive(keys, desc.key, newPrimitive);
+        if (newPrimitive)
+            staged->primitives.push_back({ desc.key, {}, {} });
+        staged->instances.push_back(desc);
+        staged->instancePrimitive.push_back(prim);
+        return prim;
+    };
+
+    if (magic == COMPILED_MAP_MAGIC) {
+        CompiledMap map;
+        if (!map.Open(std::move(file), path)) {
+            ENGINE_LOG_WARNING(Streaming, "[SectorStreamer] Bad compiled sector: %s", path.c_str());
+            return staged;
+        }
+        for (uint32_t i = 0; i < map.GetEntityCount(); ++i) {
+            StaticInstanceDesc desc;
+            if (!DescribeStaticGeometry(map, i, desc))
+                continue;
+            bool newPrimitive;
+            const uint32_t prim = addInstance(desc, newPrimitive);
+            if (newPrimitive) {
+                const CompiledMapGeometry& geo = map.GetGeometry(static_cast<uint32_t>(map.GetEntity(i).geometryIndex));
+                const float* v = map.GetVertices(geo);
+                const unsigned int* idx = map.GetIndices(geo);
+                staged->primitives[prim].vertices.assign(v, v + geo.vertexFloatCount);
+                staged->primitives[prim].indices.assign(idx, idx + geo.indexCount);
+            }
+        }
+    } else {
+        nlohmann::json sectorData = nlohmann::json::parse(file->data, file->data + file->size, nullptr, false);
+        if (sectorData.is_discarded() || !sectorData.contains("entities")) {
+            ENGINE_LOG_WARNING(Streaming, "[SectorStreamer] Unreadable sector: %s", path.c_str());
+            return staged;
+        }
+        for (const auto& ent : sectorData["entities"]) {
+            if (ent.value("classname", "") != "static_geometry")
+                continue;
+            StaticInstanceDesc desc;
+            if (!DescribeStaticGeometry(ent, desc))
+                continue;
+            bool newPrimitive;
+            const uint32_t prim = addInstance(desc, newPrimitive);
+            if (newPrimitive) {
+                StagedPrimitive& p = staged->primitives[prim];
+                geometry::CreateUnitPrimitiveMesh(p.key.type, p.key.params, p.vertices, p.indices);
+            }
+        }
+    }
+
+    ENGINE_LOG_DEBUG(Streaming, "[SectorStreamer] Staged sector (%d, %d, %d): %zu instances, %zu primitives.",
+              request.coord.x, request.coord.y, request.coord.z,
+              staged->instances.size(), staged->primitives.size());
+    return staged;
+}
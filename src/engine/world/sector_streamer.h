@@ -0,0 +1,145 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "filesystem/async_read.h"
+#include "filesystem/file_view.h"
+#include "mathlib/vector3_d.h"
+#include "world/static_mesh_loader.h"
+
+// Integer coordinates of a cubic sector in the universe grid
+struct SectorCoord {
+    int32_t x = 0, y = 0, z = 0;
+
+    bool operator==(const SectorCoord& other) const { return x == other.x && y == other.y && z == other.z; }
+    bool operator!=(const SectorCoord& other) const { return !(*this == other); }
+};
+
+struct SectorCoordHash {
+    size_t operator()(const SectorCoord& c) const {
+        return (static_cast<size_t>(static_cast<uint32_t>(c.x)) * 73856093u) ^
+               (static_cast<size_t>(static_cast<uint32_t>(c.y)) * 19349663u) ^
+               (static_cast<size_t>(static_cast<uint32_t>(c.z)) * 83492791u);
+    }
+};
+
+struct SectorStreamerSettings {
+    std::string filePrefix = "maps/space_sector";
+    double sectorSize = 10000.0;    // meters per sector edge
+    int loadRadius = 1;             // Sectors (Chebyshev distance) kept loaded around the camera
+    int unloadRadius = 2;           // Sectors beyond this are dropped; > loadRadius gives hysteresis
+    int prefetchRadius = 2;         // Files of sectors out to here are read ahead, so loading them won't wait on disk
+    double activateBudgetMs = 2.0;  // Main-thread time per frame for uploads/registration
+};
+
+// Streams maps/<prefix>_XX_YY_ZZ.imap sectors around the camera.
+//
+//  main thread   Update(): works out the wanted sectors, queues loads nearest first,
+//                unloads sectors past the hysteresis radius and activates staged
+//                sectors nearest first (mesh cache + instance registration) within a
+//                time budget; a sector's instances appear together once it is done
+//  worker thread opens sector files through the filesystem (mapped, loose or
+//                packed), parses them in place (JSON or compiled .imapc content) and
+//                bakes any primitive geometry they need, touching no GPU or
+//                engine-global state
+//
+// Entity origins inside a sector file are relative to the sector's minimum corner.
+// A missing or empty file is an empty sector, which is a normal, cheap result.
+class SectorStreamer {
+public:
+    using Settings = SectorStreamerSettings;
+
+    SectorStreamer() = default;
+    ~SectorStreamer();
+    SectorStreamer(const SectorStreamer&) = delete;
+    SectorStreamer& operator=(const SectorStreamer&) = delete;
+
+    // readAsync/cancelAsync are optional; without them nothing is prefetched
+    void Init(FSOpenMappedFn openFile, FSReadAsyncFn readAsync, FSCancelAsyncFn cancelAsync,
+              const Settings& settings = Settings());
+    void Shutdown();                    // Joins the worker and drops every streamed sector
+
+    void Update(const Vector3_d& cameraWorldPosition);
+
+    static SectorCoord WorldToSector(const Vector3_d& position, double sectorSize);
+    static std::string SectorFileName(const std::string& prefix, const SectorCoord& coord);
+
+    size_t GetResidentSectorCount() const;
+    size_t GetPendingSectorCount() const;
+
+private:
+    struct StagedPrimitive {
+        PrimitiveMeshKey key;
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    struct StagedSector {
+        SectorCoord coord;
+        uint32_t requestId = 0;
+        std::vector<StagedPrimitive> primitives;
+        std::vector<StaticInstanceDesc> instances;
+        std::vector<uint32_t> instancePrimitive;    // Index into primitives, per instance
+    };
+
+    enum class SectorState {
+        Loading,        // Queued for, or being parsed by, the worker
+        Activating,     // Staged; instances are being registered a budget at a time
+        Resident
+    };
+
+    struct Sector {
+        SectorState state = SectorState::Loading;
+        uint32_t requestId = 0;
+        uint32_t group = 0;
+        std::unique_ptr<StagedSector> staged;
+        size_t activateCursor = 0;
+        std::vector<StaticMeshInstance> activated;  // Built so far; published together when the sector is done
+        size_t instanceCount = 0;   // Instances published under group
+    };
+
+    struct LoadRequest {
+        SectorCoord coord;
+        uint32_t requestId;
+    };
+
+    void WorkerMain();
+    std::unique_ptr<StagedSector> LoadSector(const LoadRequest& request) const;
+
+    void RequestSector(const SectorCoord& coord);
+    void UnloadSector(const SectorCoord& coord, Sector& sector);
+    void SortRequestsByDistance();
+    void UpdatePrefetches();
+    void CollectCompleted();
+    void ActivateStaged();
+
+    Settings m_Settings;
+    FSOpenMappedFn m_OpenFile = nullptr;
+    FSReadAsyncFn m_ReadAsync = nullptr;
+    FSCancelAsyncFn m_CancelAsync = nullptr;
+
+    // Main thread only
+    std::unordered_map<SectorCoord, Sector, SectorCoordHash> m_Sectors;
+    SectorCoord m_CameraSector;
+    bool m_HasCameraSector = false;
+    uint32_t m_NextRequestId = 1;
+    uint32_t m_NextGroup = STATIC_GEOMETRY_MAP_GROUP + 1;
+    std::unordered_map<SectorCoord, FSAsyncHandle, SectorCoordHash> m_Prefetches;  // Ring outside loadRadius
+
+    // Shared with the worker
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::deque<LoadRequest> m_Requests;
+    std::vector<std::unique_ptr<StagedSector>> m_Completed;
+    bool m_Quit = false;
+    std::thread m_Worker;
+};
+
+SectorStreamer& GetSectorStreamer();
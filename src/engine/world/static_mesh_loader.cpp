@@ -6,90 +6,257 @@
 #include "mathlib/vector3_f.h"
 #include "mathlib/matrix4x4_f.h"
 #include "world/static_mesh_loader.h"
+#include "floating_origin_manager.h"
 #include "world/mesh_primitives.h"
+#include "world/compiled_map.h"
+#include "world/mesh_cache.h"
+#include "world/model_cache.h"
 #include "mathlib/math_constants.h"
 #include <nlohmann/json.hpp>
 #include "engine_log.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 
 
 static std::vector<StaticMeshInstance> g_StaticMeshes;
+static unsigned int g_StaticMeshesRevision = 0;
 
 void ClearStaticGeometry() {
+    FloatingOriginManager& origin = GetFloatingOriginManager();
+    for (const auto& instance : g_StaticMeshes)
+        origin.Unregister(instance.originHandle);
+
     g_StaticMeshes.clear();
+    ++g_StaticMeshesRevision;
+}
+
+bool DescribeStaticGeometry(const nlohmann::json& ent, StaticInstanceDesc& out) {
+    auto origin = ent.value("origin", std::vector<float>{0, 0, 0});
+    Vector3_f position(origin[0], origin[1], origin[2]);
+
+    if (!ent.contains("geometry")) {
+        ENGINE_LOG_WARNING(World, "[LoadStaticGeometryFromMap] Entity at position (%.2f, %.2f, %.2f) missing 'geometry' key.", position.x, position.y, position.z);
+        return false;
+    }
+
+    const auto& geo = ent["geometry"];
+    std::string type = geo.value("type", "");
+
+    CompiledGeometryType geoType;
+    float params[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    if (type == "cube") {
+        auto size = geo.value("size", std::vector<float>{1, 1, 1});
+        ENGINE_LOG_DEBUG(World, "[LoadStaticGeometryFromMap] Creating cube at (%.2f, %.2f, %.2f) with size (%.2f, %.2f, %.2f).",
+                  position.x, position.y, position.z, size[0], size[1], size[2]);
+        geoType = CompiledGeometryType::Cube;
+        params[0] = size[0];
+        params[1] = size[1];
+        params[2] = size[2];
+    } else if (type == "plane") {
+        auto size = geo.value("size", std::vector<float>{1, 1});
+        ENGINE_LOG_DEBUG(World, "[LoadStaticGeometryFromMap] Creating plane at (%.2f, %.2f, %.2f) with size (%.2f, %.2f).",
+                  position.x, position.y, position.z, size[0], size[1]);
+        geoType = CompiledGeometryType::Plane;
+        params[0] = size[0];
+        params[2] = size[1];
+    } else if (type == "sphere") {
+        float radius = geo.value("radius", 1.0f);
+        int slices = geo.value("slices", 32);
+        int stacks = geo.value("stacks", 16);
+        ENGINE_LOG_DEBUG(World, "[LoadStaticGeometryFromMap] Creating sphere at (%.2f, %.2f, %.2f) with radius %.2f, slices %d, stacks %d.",
+                  position.x, position.y, position.z, radius, slices, stacks);
+        geoType = CompiledGeometryType::Sphere;
+        params[0] = radius;
+        params[1] = static_cast<float>(slices);
+        params[2] = static_cast<float>(stacks);
+    } else {
+        ENGINE_LOG_WARNING(World, "[LoadStaticGeometryFromMap] Unknown geometry type: '%s' at position (%.2f, %.2f, %.2f).",
+                  type.c_str(), position.x, position.y, position.z);
+        return false;
+    }
+
+    // Every primitive is a shared unit mesh; the authored size becomes instance scale
+    out.key = PrimitiveMeshKey();
+    out.key.type = geoType;
+    geometry::MakeUnitPrimitive(geoType, params, out.key.params, out.scale);
+    out.position = Vector3_d(position.x, position.y, position.z);
+    return true;
+}
+
+bool DescribeStaticProp(const nlohmann::json& ent, StaticInstanceDesc& out) {
+    auto origin = ent.value("origin", std::vector<float>{0, 0, 0});
+    auto angles = ent.value("angles", std::vector<float>{0, 0, 0});
+
+    out.model = ent.value("model", "");
+    if (out.model.empty()) {
+        ENGINE_LOG_WARNING(World, "[LoadStaticGeometryFromMap] prop_static at (%.2f, %.2f, %.2f) has no 'model'.",
+                  origin[0], origin[1], origin[2]);
+        return false;
+    }
+
+    out.position = Vector3_d(origin[0], origin[1], origin[2]);
+    out.angles = Vector3_f(angles[0], angles[1], angles[2]);
+    return true;
+}
+
+// Mesh for a described entity: a shared unit primitive or a shared model
+static std::shared_ptr<IGPUMesh> GetInstanceMesh(const StaticInstanceDesc& desc) {
+    if (desc.model.empty())
+        return GetMeshCache().GetPrimitive(desc.key);
+
+    std::shared_ptr<const Model> model = GetModelCache().Load(desc.model);
+    return model ? model->mesh : nullptr;
+}
+
+StaticMeshInstance MakeStaticGeometryInstance(const StaticInstanceDesc& desc, std::shared_ptr<IGPUMesh> mesh, uint32_t group) {
+    StaticMeshInstance instance;
+    instance.mesh = std::move(mesh);
+    instance.transform = Matrix4x4_f::Rotation(desc.angles) * Matrix4x4_f::Scale(desc.scale);
+    instance.originHandle = GetFloatingOriginManager().Register(desc.position);
+    instance.group = group;
+    return instance;
+}
+
+void AddStaticGeometryInstance(const StaticInstanceDesc& desc, std::shared_ptr<IGPUMesh> mesh, uint32_t group) {
+    g_StaticMeshes.push_back(MakeStaticGeometryInstance(desc, std::move(mesh), group));
+    ++g_StaticMeshesRevision;
+}
+
+void AddStaticGeometryInstances(std::vector<StaticMeshInstance>&& instances) {
+    if (instances.empty())
+        return;
+
+    g_StaticMeshes.insert(g_StaticMeshes.end(),
+                          std::make_move_iterator(instances.begin()), std::make_move_iterator(instances.end()));
+    instances.clear();
+    ++g_StaticMeshesRevision;
+}
+
+void ReleaseStaticGeometryInstances(std::vector<StaticMeshInstance>& instances) {
+    FloatingOriginManager& origin = GetFloatingOriginManager();
+    for (const auto& instance : instances)
+        origin.Unregister(instance.originHandle);
+    instances.clear();
+}
+
+void RemoveStaticGeometryGroup(uint32_t group) {
+    FloatingOriginManager& origin = GetFloatingOriginManager();
+    for (const auto& instance : g_StaticMeshes) {
+        if (instance.group == group)
+            origin.Unregister(instance.originHandle);
+    }
+
+    auto removed = std::remove_if(g_StaticMeshes.begin(), g_StaticMeshes.end(),
+        [group](const StaticMeshInstance& instance) { return instance.group == group; });
+
+    if (removed != g_StaticMeshes.end()) {
+        g_StaticMeshes.erase(removed, g_StaticMeshes.end());
+        ++g_StaticMeshesRevision;
+    }
 }
 
 void LoadStaticGeometryFromMap(const nlohmann::json& mapData) {
-    EngineLog("[LoadStaticGeometryFromMap] Clearing previous static geometry.");
+    ENGINE_LOG_DEBUG(World, "[LoadStaticGeometryFromMap] Clearing previous static geometry.");
     ClearStaticGeometry();
 
     if (!mapData.contains("entities")) {
-        EngineLog("[LoadStaticGeometryFromMap] No 'entities' found in map data.");
+        ENGINE_LOG_WARNING(World, "[LoadStaticGeometryFromMap] No 'entities' found in map data.");
         return;
     }
 
-    using namespace geometry;  // For Create*Mesh calls
-
     for (const auto& ent : mapData["entities"]) {
-        if (ent.value("classname", "") != "static_geometry")
-            continue;
-
-        auto origin = ent.value("origin", std::vector<float>{0, 0, 0});
-        Vector3_f position(origin[0], origin[1], origin[2]);
+        const std::string classname = ent.value("classname", "");
 
-        if (!ent.contains("geometry")) {
-            EngineLog("[LoadStaticGeometryFromMap] Entity at position (%.2f, %.2f, %.2f) missing 'geometry' key.", position.x, position.y, position.z);
+        StaticInstanceDesc desc;
+        if (classname == "static_geometry") {
+            if (!DescribeStaticGeometry(ent, desc))
+                continue;
+        } else if (classname == "prop_static") {
+            if (!DescribeStaticProp(ent, desc))
+                continue;
+        } else {
             continue;
         }
 
-        const auto& geo = ent["geometry"];
-        std::string type = geo.value("type", "");
-
-        std::vector<float> verts;
-        std::vector<unsigned int> indices;
-
-        if (type == "cube") {
-            auto size = geo.value("size", std::vector<float>{1, 1, 1});
-            EngineLog("[LoadStaticGeometryFromMap] Creating cube at (%.2f, %.2f, %.2f) with size (%.2f, %.2f, %.2f).",
-                      position.x, position.y, position.z, size[0], size[1], size[2]);
-            CreateCubeMesh(verts, indices, Vector3_f(size[0], size[1], size[2]));
-        } else if (type == "plane") {
-            auto size = geo.value("size", std::vector<float>{1, 1});
-            EngineLog("[LoadStaticGeometryFromMap] Creating plane at (%.2f, %.2f, %.2f) with size (%.2f, %.2f).",
-                      position.x, position.y, position.z, size[0], size[1]);
-            CreatePlaneMesh(verts, indices, Vector3_f(size[0], 0.0f, size[1]));
-        } else if (type == "sphere") {
-            float radius = geo.value("radius", 1.0f);
-            int slices = geo.value("slices", 32);
-            int stacks = geo.value("stacks", 16);
-            EngineLog("[LoadStaticGeometryFromMap] Creating sphere at (%.2f, %.2f, %.2f) with radius %.2f, slices %d, stacks %d.",
-                      position.x, position.y, position.z, radius, slices, stacks);
-            CreateSphereMesh(verts, indices, radius, slices, stacks);
-        } else {
-            EngineLog("[LoadStaticGeometryFromMap] Unknown geometry type: '%s' at position (%.2f, %.2f, %.2f).",
-                      type.c_str(), position.x, position.y, position.z);
+        std::shared_ptr<IGPUMesh> mesh = GetInstanceMesh(desc);
+        if (!mesh)
             continue;
-        }
 
-        StaticMeshInstance instance;
-		instance.mesh.reset(GetRenderInterface()->CreateMesh());
+        AddStaticGeometryInstance(desc, std::move(mesh), STATIC_GEOMETRY_MAP_GROUP);
+        ENGINE_LOG_DEBUG(World, "[LoadStaticGeometryFromMap] Mesh added. Total static meshes: %zu", g_StaticMeshes.size());
+    }
 
-        try {
-            instance.mesh->Upload(verts, indices);
-        } catch (const std::exception& e) {
-            EngineLog("[LoadStaticGeometryFromMap] Exception during mesh upload: %s", e.what());
-            continue;
-        } catch (...) {
-            EngineLog("[LoadStaticGeometryFromMap] Unknown exception during mesh upload.");
-            continue;
-        }
+    GetMeshCache().ReleaseUnused(); // Drop primitives and models only the previous map used
+    GetModelCache().ReleaseUnused();
+}
+
+bool DescribeStaticGeometry(const CompiledMap& map, uint32_t entityIndex, StaticInstanceDesc& out) {
+    const CompiledMapEntity& ent = map.GetEntity(entityIndex);
+    if (ent.geometryIndex < 0)
+        return false;
 
-        instance.transform = Matrix4x4_f::Translation(position);
+    const CompiledMapGeometry& geo = map.GetGeometry(static_cast<uint32_t>(ent.geometryIndex));
+    out.key = PrimitiveMeshKey();
+    out.key.type = static_cast<CompiledGeometryType>(geo.type);
+    for (int p = 0; p < 4; ++p)
+        out.key.params[p] = geo.params[p];
 
-        g_StaticMeshes.push_back(std::move(instance));
-        EngineLog("[LoadStaticGeometryFromMap] Mesh added. Total static meshes: %zu", g_StaticMeshes.size());
+    out.position = Vector3_d(ent.origin[0], ent.origin[1], ent.origin[2]);
+    out.scale = Vector3_f(ent.scale[0], ent.scale[1], ent.scale[2]);
+    out.angles = Vector3_f(ent.angles[0], ent.angles[1], ent.angles[2]);
+    return true;
+}
+
+bool DescribeStaticProp(const CompiledMap& map, uint32_t entityIndex, StaticInstanceDesc& out) {
+    const CompiledMapEntity& ent = map.GetEntity(entityIndex);
+    out.model = map.GetString(ent.modelOffset);
+    if (out.model.empty() || std::strcmp(map.GetString(ent.classnameOffset), "prop_static") != 0)
+        return false;
+
+    out.position = Vector3_d(ent.origin[0], ent.origin[1], ent.origin[2]);
+    out.scale = Vector3_f(ent.scale[0], ent.scale[1], ent.scale[2]);
+    out.angles = Vector3_f(ent.angles[0], ent.angles[1], ent.angles[2]);
+    return true;
+}
+
+// Compiled maps carry baked vertex/index pools, so meshes upload straight from the
+// mapped file with no JSON walk and no per-entity CPU-side geometry buffers.
+// Geometry already cached from an earlier map is not uploaded again.
+void LoadStaticGeometryFromCompiledMap(const CompiledMap& map) {
+    ClearStaticGeometry();
+
+    const uint32_t entityCount = map.GetEntityCount();
+    g_StaticMeshes.reserve(entityCount);
+
+    for (uint32_t i = 0; i < entityCount; ++i) {
+        StaticInstanceDesc desc;
+        std::shared_ptr<IGPUMesh> mesh;
+        if (DescribeStaticGeometry(map, i, desc)) {
+            const CompiledMapGeometry& geo = map.GetGeometry(static_cast<uint32_t>(map.GetEntity(i).geometryIndex));
+            mesh = GetMeshCache().GetPrimitive(desc.key, map.GetVertices(geo), geo.vertexFloatCount,
+                                               map.GetIndices(geo), geo.indexCount);
+        } else if (DescribeStaticProp(map, i, desc)) {
+            mesh = GetInstanceMesh(desc);
+        }
+        if (!mesh)
+            continue;
+
+        AddStaticGeometryInstance(desc, std::move(mesh), STATIC_GEOMETRY_MAP_GROUP);
     }
+
+    GetMeshCache().ReleaseUnused();
+    GetModelCache().ReleaseUnused();
+
+    ENGINE_LOG_INFO(World, "[LoadStaticGeometryFromCompiledMap] Loaded %zu static meshes from %u entities (%zu unique meshes, %zu models).",
+              g_StaticMeshes.size(), entityCount, GetMeshCache().GetMeshCount(), GetModelCache().GetModelCount());
 }
 
 const std::vector<StaticMeshInstance>& GetStaticGeometry() {
     return g_StaticMeshes;
+}
+
+unsigned int GetStaticGeometryRevision() {
+    return g_StaticMeshesRevision;
 }
\ No newline at end of file
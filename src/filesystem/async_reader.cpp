@@ -0,0 +1,93 @@
+#include "async_reader.h"
+
+static constexpr size_t TOUCH_STRIDE = 4096;
+
+AsyncReader::~AsyncReader() {
+    Stop();
+}
+
+void AsyncReader::Start(FSOpenMappedFn openFile, uint32_t threadCount) {
+    Stop();
+
+    m_OpenFile = openFile;
+    m_Quit = false;
+    for (uint32_t i = 0; i < threadCount; ++i)
+        m_Workers.emplace_back(&AsyncReader::WorkerMain, this);
+}
+
+void AsyncReader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+        m_Queue.clear();
+        m_QueuedPriority.clear();
+    }
+    m_Wake.notify_all();
+
+    for (std::thread& worker : m_Workers)
+        worker.join();
+    m_Workers.clear();
+}
+
+FSAsyncHandle AsyncReader::Submit(const std::string& path, FSReadPriority priority, FSReadCallback callback) {
+    const int key = -static_cast<int>(priority);
+
+    FSAsyncHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Quit || m_Workers.empty())
+            return 0;
+
+        handle = m_NextHandle++;
+        m_Queue.emplace(QueueKey(key, handle), Job{ path, std::move(callback) });
+        m_QueuedPriority.emplace(handle, key);
+    }
+    m_Wake.notify_one();
+    return handle;
+}
+
+bool AsyncReader::Cancel(FSAsyncHandle handle) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_QueuedPriority.find(handle);
+    if (it == m_QueuedPriority.end())
+        return false;
+
+    m_Queue.erase(QueueKey(it->second, handle));
+    m_QueuedPriority.erase(it);
+    return true;
+}
+
+size_t AsyncReader::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Queue.size();
+}
+
+void AsyncReader::WorkerMain() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [this] { return m_Quit || !m_Queue.empty(); });
+            if (m_Quit)
+                return;
+
+            auto it = m_Queue.begin();
+            m_QueuedPriority.erase(it->first.second);
+            job = std::move(it->second);
+            m_Queue.erase(it);
+        }
+
+        FSFileViewPtr file = m_OpenFile(job.path);
+
+        // Fault every page in here rather than on the consumer's first touch
+        if (file) {
+            volatile unsigned char sink = 0;
+            for (size_t offset = 0; offset < file->size; offset += TOUCH_STRIDE)
+                sink = sink + file->data[offset];
+            (void)sink;
+        }
+
+        if (job.callback)
+            job.callback(std::move(file));
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "filesystem/async_read.h"
+
+// I/O thread pool behind FS_ReadAsync: a priority queue of read jobs drained by
+// a few worker threads. Each job opens its file through openFile and faults its
+// pages in before the callback runs.
+class AsyncReader {
+public:
+    AsyncReader() = default;
+    ~AsyncReader();
+
+    AsyncReader(const AsyncReader&) = delete;
+    AsyncReader& operator=(const AsyncReader&) = delete;
+
+    void Start(FSOpenMappedFn openFile, uint32_t threadCount);
+    void Stop();    // Cancels everything still queued and joins the workers
+
+    // 0 if the reader isn't running
+    FSAsyncHandle Submit(const std::string& path, FSReadPriority priority, FSReadCallback callback);
+
+    // True if the job was still queued; false once it has started, finished or was never submitted
+    bool Cancel(FSAsyncHandle handle);
+
+    size_t GetPendingCount() const;
+
+private:
+    struct Job {
+        std::string path;
+        FSReadCallback callback;
+    };
+
+    // Highest priority first, then oldest first (handles only grow)
+    using QueueKey = std::pair<int, FSAsyncHandle>;
+
+    void WorkerMain();
+
+    FSOpenMappedFn m_OpenFile = nullptr;
+    std::vector<std::thread> m_Workers;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::map<QueueKey, Job> m_Queue;
+    std::unordered_map<FSAsyncHandle, int> m_QueuedPriority;    // Handle -> key priority, for Cancel
+    FSAsyncHandle m_NextHandle = 1;
+    bool m_Quit = false;
+};
@@ -1,25 +1,291 @@
 // filesystem_stdio.cpp - updated for Source-style directory structure
 #include "filesystem_stdio.h"
+#include "async_reader.h"
+#include "file_mapping.h"
+#include "pack_file.h"
 
 #include <vector> // added because contains vector stuff
 #include <fstream>
-#include <sstream>
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 
 namespace fs = std::filesystem;
 
 static std::string g_gameDir;
 static std::vector<std::string> g_searchPaths;
 
+// Search paths naming a .ipak file, mounted at FS_Init in search order. Shared so
+// that views into a pack keep it mapped after FS_Shutdown unmounts it.
+static std::vector<std::shared_ptr<const PackFile>> g_packs;
+
+// Where a resolved file lives: a loose path on disk, or an entry in a mounted pack
+struct IndexEntry {
+    std::string loosePath;
+    std::shared_ptr<const PackFile> pack;
+    uint32_t packEntry = 0;
+};
+
+// FS_OpenMapped views. Each owns whatever keeps its bytes alive.
+struct LooseFileView : FSFileView {
+    FileMapping mapping;
+};
+
+struct PackedFileView : FSFileView {
+    std::shared_ptr<const PackFile> pack;
+};
+
+struct DecompressedFileView : FSFileView {
+    std::unique_ptr<unsigned char[]> buffer;
+};
+
+// Resolve index: normalized relative path -> the highest-priority copy of the file.
+// Loose files win over packed ones, then search order decides. Built at FS_Init and
+// on FS_RefreshIndex. The mount watcher patches single keys as files come and go;
+// only when it loses track (notification overflow) is the whole index rebuilt, on
+// the next lookup.
+static std::unordered_map<std::string, IndexEntry> g_resolveIndex;
+static std::unordered_map<std::string, IndexEntry> g_packIndex;    // Packed files only; packs don't change while mounted
+static std::shared_mutex g_indexMutex;
+static std::atomic<bool> g_indexDirty{ false };
+
+// I/O threads behind FS_ReadAsync; a few are enough to keep the disk queue busy
+static constexpr uint32_t MAX_IO_THREADS = 4;
+static AsyncReader g_asyncReader;
+
 static std::string Trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\n\r");
     size_t last = str.find_last_not_of(" \t\n\r");
     return (first == std::string::npos) ? "" : str.substr(first, last - first + 1);
 }
 
+// Lookups are case-insensitive with '/' separators, matching how Windows resolves
+// the same relative path; "./" segments and duplicate slashes are dropped
+static std::string NormalizeKey(const std::string& path) {
+    std::string key = fs::path(path).lexically_normal().generic_string();
+    if (key.size() >= 2 && key[0] == '.' && key[1] == '/')
+        key.erase(0, 2);
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return key;
+}
+
+static bool IsPackPath(const std::string& path) {
+    return NormalizeKey(fs::path(path).extension().string()) == ".ipak";
+}
+
+static void MountPacks() {
+    for (const auto& base : g_searchPaths) {
+        if (!IsPackPath(base))
+            continue;
+
+        const std::string full = (fs::path(g_gameDir) / base).string();
+        auto pack = std::make_shared<PackFile>();
+        if (!pack->Open(full)) {
+            std::cerr << "[FS] Failed to mount pack: " << full << std::endl;
+            continue;
+        }
+        std::cout << "[FS] Mount Pack: " << full << " (" << pack->GetEntryCount() << " files)" << std::endl;
+        g_packs.push_back(std::move(pack));
+    }
+}
+
+static bool FindEntry(const std::string& relative_path, IndexEntry& out) {
+    if (g_indexDirty.exchange(false, std::memory_order_acq_rel))
+        FS_RefreshIndex();
+
+    const std::string key = NormalizeKey(relative_path);
+
+    std::shared_lock<std::shared_mutex> lock(g_indexMutex);
+    auto it = g_resolveIndex.find(key);
+    if (it == g_resolveIndex.end())
+        return false;
+    out = it->second;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Mount watcher: applies file and directory adds/removes/renames under the loose
+// search paths to the index as they happen.
+// Change notifications are Windows-only; elsewhere call FS_RefreshIndex.
+//-----------------------------------------------------------------------------
+#ifdef _WIN32
+// Works out which copy of key wins now, from what is on disk. Idempotent, so the
+// order notifications arrive in doesn't matter. Caller holds g_indexMutex exclusively.
+static void ResolveKeyLocked(const std::string& key) {
+    std::error_code ec;
+    for (const auto& base : g_searchPaths) {
+        if (IsPackPath(base))
+            continue;
+        const fs::path path = fs::path(g_gameDir) / base / fs::u8path(key);
+        if (fs::is_regular_file(path, ec)) {
+            g_resolveIndex[key] = IndexEntry{ path.string(), nullptr, 0 };
+            return;
+        }
+    }
+
+    auto packed = g_packIndex.find(key);
+    if (packed != g_packIndex.end())
+        g_resolveIndex[key] = packed->second;
+    else
+        g_resolveIndex.erase(key);
+}
+
+// A name under a mount appeared or disappeared. Directories come and go as a whole
+// (a move or rename reports only the directory), so every key below one is redone.
+static void ApplyChangeLocked(const fs::path& root, const fs::path& relative) {
+    const std::string key = NormalizeKey(relative.generic_string());
+    if (key.empty() || key == ".")
+        return;
+
+    std::error_code ec;
+    const fs::path full = root / relative;
+    if (fs::is_directory(full, ec)) {
+        for (fs::recursive_directory_iterator it(full, fs::directory_options::skip_permission_denied, ec), end;
+             it != end; it.increment(ec)) {
+            if (ec)
+                break;
+            if (it->is_regular_file(ec))
+                ResolveKeyLocked(NormalizeKey(it->path().lexically_relative(root).generic_string()));
+        }
+        return;
+    }
+
+    const bool wasFile = g_resolveIndex.count(key) != 0;
+    ResolveKeyLocked(key);
+
+    // Gone, and not a file we knew: it was a directory, so redo whatever was indexed below it
+    if (!wasFile && !fs::exists(full, ec)) {
+        const std::string prefix = key + "/";
+        std::vector<std::string> below;
+        for (const auto& entry : g_resolveIndex) {
+            if (entry.first.compare(0, prefix.size(), prefix) == 0)
+                below.push_back(entry.first);
+        }
+        for (const auto& child : below)
+            ResolveKeyLocked(child);
+    }
+}
+
+static std::thread g_watchThread;
+static HANDLE g_watchStop = nullptr;
+
+struct MountWatch {
+    fs::path root;
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    OVERLAPPED overlapped = {};
+    alignas(DWORD) unsigned char buffer[64 * 1024];
+};
+
+static bool IssueWatch(MountWatch& watch) {
+    ResetEvent(watch.overlapped.hEvent);
+    return ReadDirectoryChangesW(watch.directory, watch.buffer, sizeof(watch.buffer), TRUE,
+                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME,
+                                 nullptr, &watch.overlapped, nullptr) != FALSE;
+}
+
+static void ApplyNotifications(MountWatch& watch, DWORD bytes) {
+    std::unique_lock<std::shared_mutex> lock(g_indexMutex);
+    const unsigned char* record = watch.buffer;
+    for (;;) {
+        const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+        if (info->Action != FILE_ACTION_MODIFIED) {
+            const std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            ApplyChangeLocked(watch.root, fs::path(name));
+        }
+        if (info->NextEntryOffset == 0 || record + info->NextEntryOffset >= watch.buffer + bytes)
+            break;
+        record += info->NextEntryOffset;
+    }
+}
+
+static void WatchMain(std::vector<std::unique_ptr<MountWatch>> watches) {
+    std::vector<HANDLE> handles;
+    handles.push_back(g_watchStop);
+    for (auto& watch : watches)
+        handles.push_back(watch->overlapped.hEvent);
+
+    for (;;) {
+        DWORD result = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+        if (result <= WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + handles.size())
+            break; // Stop event (index 0), or an error
+
+        MountWatch& watch = *watches[result - WAIT_OBJECT_0 - 1];
+        DWORD bytes = 0;
+        if (GetOverlappedResult(watch.directory, &watch.overlapped, &bytes, FALSE) && bytes > 0)
+            ApplyNotifications(watch, bytes);
+        else
+            g_indexDirty.store(true, std::memory_order_release); // Buffer overflowed: changes were lost
+
+        if (!IssueWatch(watch))
+            g_indexDirty.store(true, std::memory_order_release);
+    }
+
+    for (auto& watch : watches) {
+        CancelIoEx(watch->directory, &watch->overlapped);
+        DWORD bytes = 0;
+        GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, TRUE);
+        CloseHandle(watch->directory);
+        CloseHandle(watch->overlapped.hEvent);
+    }
+}
+
+static void StartMountWatcher() {
+    if (g_watchThread.joinable())
+        return;
+
+    std::vector<std::unique_ptr<MountWatch>> watches;
+    g_watchStop = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    for (const auto& base : g_searchPaths) {
+        if (IsPackPath(base))
+            continue; // Packs are immutable while mounted
+
+        auto watch = std::make_unique<MountWatch>();
+        watch->root = fs::path(g_gameDir) / base;
+        watch->directory = CreateFileW(watch->root.wstring().c_str(), FILE_LIST_DIRECTORY,
+                                       FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                       OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (watch->directory == INVALID_HANDLE_VALUE)
+            continue;
+        watch->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        if (!IssueWatch(*watch)) {
+            CloseHandle(watch->directory);
+            CloseHandle(watch->overlapped.hEvent);
+            continue;
+        }
+        watches.push_back(std::move(watch));
+    }
+
+    g_watchThread = std::thread(WatchMain, std::move(watches));
+}
+
+static void StopMountWatcher() {
+    if (!g_watchThread.joinable())
+        return;
+
+    SetEvent(g_watchStop);
+    g_watchThread.join();
+    CloseHandle(g_watchStop);
+    g_watchStop = nullptr;
+}
+#else
+static void StartMountWatcher() {}
+static void StopMountWatcher() {}
+#endif
+
 DLL_EXPORT bool FS_Init(const std::string& gameinfo_path) {
     g_gameDir = fs::absolute(fs::path(gameinfo_path)).parent_path().string();
 
@@ -59,13 +325,32 @@ DLL_EXPORT bool FS_Init(const std::string& gameinfo_path) {
 
     std::cout << "[FS] Game Directory: " << g_gameDir << std::endl;
     for (const auto& path : g_searchPaths) {
+        if (IsPackPath(path))
+            continue;
         fs::path full = fs::path(g_gameDir) / path;
         std::cout << "[FS] Mount Path: " << full.string() << std::endl;
     }
 
+    MountPacks();
+    FS_RefreshIndex();
+    StartMountWatcher();
+
+    const uint32_t ioThreads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_IO_THREADS);
+    g_asyncReader.Start(FS_OpenMapped, ioThreads);
+
     return true;
 }
 
+DLL_EXPORT void FS_Shutdown() {
+    g_asyncReader.Stop();
+    StopMountWatcher();
+
+    std::unique_lock<std::shared_mutex> lock(g_indexMutex);
+    g_resolveIndex.clear();
+    g_packIndex.clear();
+    g_packs.clear();
+}
+
 const std::string& FS_GetGameDir() {
     return g_gameDir;
 }
@@ -75,15 +360,114 @@ const std::vector<std::string>& FS_GetSearchPaths() {
 }
 
 std::string FS_ResolvePath(const std::string& relative_path) {
-    std::cout << "[FS] Resolving: " << relative_path << "\n";
+    IndexEntry entry;
+    if (!FindEntry(relative_path, entry))
+        return std::string();
+    return entry.loosePath; // Empty for packed files: they have no path on disk
+}
+
+DLL_EXPORT FSFileViewPtr FS_OpenMapped(const std::string& relative_path) {
+    IndexEntry entry;
+    if (!FindEntry(relative_path, entry))
+        return nullptr;
+
+    if (entry.pack) {
+        const PackFile& pack = *entry.pack;
+        const uint32_t size = pack.GetEntry(entry.packEntry).size;
+
+        if (!pack.IsCompressed(entry.packEntry)) {
+            auto view = std::make_shared<PackedFileView>();
+            view->data = pack.GetStoredData(entry.packEntry);
+            view->size = size;
+            view->pack = std::move(entry.pack);
+            return view;
+        }
+
+        auto view = std::make_shared<DecompressedFileView>();
+        view->buffer.reset(new unsigned char[size > 0 ? size : 1]);
+        if (!pack.Decompress(entry.packEntry, view->buffer.get()))
+            return nullptr;
+        view->data = view->buffer.get();
+        view->size = size;
+        return view;
+    }
+
+    auto view = std::make_shared<LooseFileView>();
+    if (view->mapping.Open(entry.loosePath)) {
+        view->data = view->mapping.Data();
+        view->size = view->mapping.Size();
+        return view;
+    }
+
+    // Empty files can't be mapped but are still valid (size 0)
+    std::error_code ec;
+    if (fs::is_regular_file(entry.loosePath, ec) && fs::file_size(entry.loosePath, ec) == 0 && !ec)
+        return std::make_shared<FSFileView>();
+
+    std::cerr << "[FS] Failed to map " << entry.loosePath << std::endl;
+    return nullptr;
+}
+
+DLL_EXPORT FSAsyncHandle FS_ReadAsync(const std::string& relative_path, FSReadPriority priority,
+                                      FSReadCallback callback) {
+    return g_asyncReader.Submit(relative_path, priority, std::move(callback));
+}
+
+DLL_EXPORT bool FS_CancelAsync(FSAsyncHandle handle) {
+    return g_asyncReader.Cancel(handle);
+}
+
+DLL_EXPORT bool FS_ReadFile(const std::string& relative_path, std::vector<char>& out) {
+    out.clear();
+
+    FSFileViewPtr view = FS_OpenMapped(relative_path);
+    if (!view)
+        return false;
+
+    out.assign(view->data, view->data + view->size);
+    return true;
+}
+
+DLL_EXPORT void FS_RefreshIndex() {
+    std::unordered_map<std::string, IndexEntry> index;
+
+    // Loose directories first, in priority order: the first mount that has a file owns its key
     for (const auto& base : g_searchPaths) {
-        fs::path full = fs::path(g_gameDir) / base / relative_path;
-        std::cout << "[FS] Checking: " << full << "\n";
-        if (fs::exists(full)) {
-            std::cout << "[FS] Found: " << full << "\n";
-            return full.string();
+        if (IsPackPath(base))
+            continue;
+        const fs::path root = fs::path(g_gameDir) / base;
+        std::error_code ec;
+        if (!fs::is_directory(root, ec))
+            continue;
+
+        for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+             it != end; it.increment(ec)) {
+            if (ec)
+                break;
+            if (!it->is_regular_file(ec))
+                continue;
+
+            const std::string relative = it->path().lexically_relative(root).generic_string();
+            index.emplace(NormalizeKey(relative), IndexEntry{ it->path().string(), nullptr, 0 });
         }
     }
-    std::cout << "[FS] Failed to resolve: " << relative_path << "\n";
-    return "";
-}
\ No newline at end of file
+
+    // Then packs, in search order, for whatever no loose file already provides
+    std::unordered_map<std::string, IndexEntry> packIndex;
+    for (const auto& pack : g_packs) {
+        for (uint32_t i = 0; i < pack->GetEntryCount(); ++i)
+            packIndex.emplace(NormalizeKey(pack->GetEntryPath(i)), IndexEntry{ std::string(), pack, i });
+    }
+    size_t packed = 0;
+    for (const auto& entry : packIndex)
+        packed += index.emplace(entry.first, entry.second).second;
+
+    const size_t count = index.size();
+    {
+        std::unique_lock<std::shared_mutex> lock(g_indexMutex);
+        g_resolveIndex.swap(index);
+        g_packIndex.swap(packIndex);
+    }
+    std::cout << "[FS] Indexed " << count << " files (" << packed << " packed) across "
+              << g_searchPaths.size() << " search paths\n";
+}
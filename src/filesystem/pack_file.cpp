@@ -0,0 +1,109 @@
+#include "pack_file.h"
+#include "filesystem/lz4_block.h"
+
+#include <algorithm>
+#include <iostream>
+
+PackFile::~PackFile() {
+    Close();
+}
+
+static bool SectionFits(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize) {
+    return offset <= fileSize && count <= (fileSize - offset) / stride;
+}
+
+bool PackFile::Open(const std::string& path) {
+    Close();
+
+    if (!m_Mapping.Open(path))
+        return false;
+
+    m_Data = m_Mapping.Data();
+    m_Size = m_Mapping.Size();
+    m_Path = path;
+
+    const auto fail = [&](const char* reason) {
+        std::cerr << "[FS] Invalid pack " << path << ": " << reason << std::endl;
+        Close();
+        return false;
+    };
+
+    if (m_Size < sizeof(PackHeader))
+        return fail("truncated header");
+
+    m_Header = reinterpret_cast<const PackHeader*>(m_Data);
+    if (m_Header->magic != PACK_MAGIC)
+        return fail("bad magic");
+    if (m_Header->version != PACK_VERSION)
+        return fail("unsupported version");
+    if (m_Header->fileSize != m_Size)
+        return fail("size mismatch");
+
+    if (!SectionFits(m_Header->directoryOffset, m_Header->directoryCount, sizeof(PackDirectory), m_Size) ||
+        !SectionFits(m_Header->entryOffset, m_Header->entryCount, sizeof(PackEntry), m_Size) ||
+        !SectionFits(m_Header->stringTableOffset, m_Header->stringTableSize, 1, m_Size))
+        return fail("table out of range");
+
+    m_Directories = reinterpret_cast<const PackDirectory*>(m_Data + m_Header->directoryOffset);
+    m_Entries = reinterpret_cast<const PackEntry*>(m_Data + m_Header->entryOffset);
+    m_Strings = reinterpret_cast<const char*>(m_Data + m_Header->stringTableOffset);
+
+    const uint32_t stringsSize = m_Header->stringTableSize;
+    if (stringsSize == 0 || m_Strings[stringsSize - 1] != '\0')
+        return fail("unterminated string table");
+
+    // Validate once here so reads can trust the tables
+    m_EntryDirectory.assign(m_Header->entryCount, UINT32_MAX);
+    for (uint32_t d = 0; d < m_Header->directoryCount; ++d) {
+        const PackDirectory& dir = m_Directories[d];
+        if (dir.pathOffset >= stringsSize || dir.firstEntry > m_Header->entryCount ||
+            dir.entryCount > m_Header->entryCount - dir.firstEntry)
+            return fail("bad directory record");
+        for (uint32_t e = dir.firstEntry; e < dir.firstEntry + dir.entryCount; ++e)
+            m_EntryDirectory[e] = d;
+    }
+
+    for (uint32_t e = 0; e < m_Header->entryCount; ++e) {
+        const PackEntry& entry = m_Entries[e];
+        if (m_EntryDirectory[e] == UINT32_MAX || entry.nameOffset >= stringsSize ||
+            !SectionFits(entry.dataOffset, entry.storedSize, 1, m_Size))
+            return fail("bad entry record");
+        if (entry.compression == static_cast<uint32_t>(PackCompression::None) && entry.storedSize != entry.size)
+            return fail("bad entry size");
+        if (entry.compression > static_cast<uint32_t>(PackCompression::LZ4))
+            return fail("unknown compression");
+    }
+
+    return true;
+}
+
+void PackFile::Close() {
+    m_Mapping.Close();
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Header = nullptr;
+    m_Directories = nullptr;
+    m_Entries = nullptr;
+    m_Strings = nullptr;
+    m_EntryDirectory.clear();
+}
+
+std::string PackFile::GetEntryPath(uint32_t index) const {
+    const std::string directory = GetString(m_Directories[m_EntryDirectory[index]].pathOffset);
+    const char* name = GetString(m_Entries[index].nameOffset);
+    return directory.empty() ? std::string(name) : directory + '/' + name;
+}
+
+bool PackFile::Decompress(uint32_t index, unsigned char* out) const {
+    const PackEntry& entry = m_Entries[index];
+    if (entry.compression == static_cast<uint32_t>(PackCompression::None)) {
+        std::copy(m_Data + entry.dataOffset, m_Data + entry.dataOffset + entry.size, out);
+        return true;
+    }
+
+    if (!lz4::DecompressBlock(m_Data + entry.dataOffset, entry.storedSize, out, entry.size)) {
+        std::cerr << "[FS] Corrupt entry '" << GetEntryPath(index) << "' in " << m_Path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "file_mapping.h"
+#include "filesystem/pack_format.h"
+
+// A mounted .ipak: the whole file is mapped read-only once at Open and every read
+// is served from that mapping (one open per pack instead of one per file).
+class PackFile {
+public:
+    PackFile() = default;
+    ~PackFile();
+
+    PackFile(const PackFile&) = delete;
+    PackFile& operator=(const PackFile&) = delete;
+
+    // Maps the pack and validates its header and tables
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    const std::string& GetPath() const { return m_Path; }
+
+    uint32_t GetEntryCount() const { return m_Header ? m_Header->entryCount : 0; }
+    const PackEntry& GetEntry(uint32_t index) const { return m_Entries[index]; }
+
+    // Full "<directory>/<name>" path of an entry, as stored (lowercase, '/')
+    std::string GetEntryPath(uint32_t index) const;
+
+    bool IsCompressed(uint32_t index) const {
+        return m_Entries[index].compression != static_cast<uint32_t>(PackCompression::None);
+    }
+
+    // Stored entries only: the entry's bytes inside the mapping
+    const unsigned char* GetStoredData(uint32_t index) const { return m_Data + m_Entries[index].dataOffset; }
+
+    // Decompresses (or copies) the entry's GetEntry(index).size bytes into out; false if corrupt
+    bool Decompress(uint32_t index, unsigned char* out) const;
+
+private:
+    const char* GetString(uint32_t offset) const { return m_Strings + offset; }
+
+    FileMapping m_Mapping;
+    const unsigned char* m_Data = nullptr;
+    size_t m_Size = 0;
+    std::string m_Path;
+
+    const PackHeader* m_Header = nullptr;
+    const PackDirectory* m_Directories = nullptr;
+    const PackEntry* m_Entries = nullptr;
+    const char* m_Strings = nullptr;
+    std::vector<uint32_t> m_EntryDirectory;   // Entry index -> directory index
+};
@@ -5,7 +5,7 @@
 // - Reads engine_path.txt for DLL paths (optional fallback to defaults)
 // - Loads filesystem_stdio dynamic library
 // - Loads engine DLL / shared lib
-// - Calls Engine_Run()
+// - Forwards the command line (Engine_SetCommandLine), then calls Engine_Run()
 // No rendering or ShaderAPI logic here.
 
 #include <iostream>
@@ -33,7 +33,9 @@
 
 // Function pointer types
 using EngineRunFn = void(*)();
+using EngineSetCommandLineFn = void(*)(int, char**);
 using FSInitFn = bool(*)(const std::string&);
+using FSShutdownFn = void(*)();
 
 // Helper: Get executable directory cross-platform
 static std::optional<std::filesystem::path> GetExecutableDir() {
@@ -216,11 +218,19 @@ int main(int argc, char* argv[]) {
         return -7;
     }
 
+    // Engine switches such as -nullrender / -benchframes (see engine_api.h)
+    if (auto Engine_SetCommandLine = reinterpret_cast<EngineSetCommandLineFn>(GetLibProc(engineLib, "Engine_SetCommandLine")))
+        Engine_SetCommandLine(argc, argv);
+
     // Run the engine (blocks until engine exits)
     Engine_Run();
 
     // Cleanup
     CloseLib(engineLib);
+
+    // Stops the filesystem's mount watcher thread before its code is unmapped
+    if (auto FS_Shutdown = reinterpret_cast<FSShutdownFn>(GetLibProc(fsLib, "FS_Shutdown")))
+        FS_Shutdown();
     CloseLib(fsLib);
 
     return 0;
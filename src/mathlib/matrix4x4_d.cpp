@@ -74,20 +74,6 @@ Matrix4x4_d Matrix4x4_d::Orthographic(double left, double right, double bottom,
     return result;
 }
 
-Matrix4x4_d operator*(const Matrix4x4_d& a, const Matrix4x4_d& b) {
-    Matrix4x4_d result;
-    for (int col = 0; col < 4; ++col) {
-        for (int row = 0; row < 4; ++row) {
-            double sum = 0.0;
-            for (int i = 0; i < 4; ++i) {
-                sum += a[i][row] * b[col][i];
-            }
-            result[col][row] = sum;
-        }
-    }
-    return result;
-}
-
 Matrix4x4_d Matrix4x4_d::Translate(const Vector3_d& offset) {
     Matrix4x4_d mat = Matrix4x4_d::Identity();
     mat[3][0] = offset.x;
@@ -19,7 +19,14 @@ Matrix4x4_f Matrix4x4_f::Translation(const Vector3_f& t) {
 
 Matrix4x4_f Matrix4x4_f::LookAt(const Vector3_f& eye, const Vector3_f& center, const Vector3_f& up)
 {
-    Vector3_f f = (center - eye).Normalize(); 	// forward
+    return LookTo(eye, center - eye, up);
+}
+
+// Same as LookAt but takes the view direction, so a camera at the render origin
+// (camera-relative rendering) never has to form eye + forward in world space.
+Matrix4x4_f Matrix4x4_f::LookTo(const Vector3_f& eye, const Vector3_f& forward, const Vector3_f& up)
+{
+    Vector3_f f = forward.Normalize(); 		// forward
     Vector3_f s = f.Cross(up).Normalize();    	// right
     Vector3_f u = s.Cross(f);                 	// up
 
@@ -77,6 +84,15 @@ Matrix4x4_f Matrix4x4_f::Orthographic(float left, float right, float bottom, flo
     return result;
 }
 
+Matrix4x4_f Matrix4x4_f::Scale(const Vector3_f& scale) {
+    Matrix4x4_f result = {};
+    result[0][0] = scale.x;
+    result[1][1] = scale.y;
+    result[2][2] = scale.z;
+    result[3][3] = 1.0f;
+    return result;
+}
+
 Matrix4x4_f Matrix4x4_f::Translate(const Vector3_f& offset) {
     Matrix4x4_f mat = Matrix4x4_f::Identity();
     mat[3][0] = offset.x;
@@ -84,3 +100,27 @@ Matrix4x4_f Matrix4x4_f::Translate(const Vector3_f& offset) {
     mat[3][2] = offset.z;
     return mat;
 }
+
+Matrix4x4_f Matrix4x4_f::Rotation(const Vector3_f& anglesDeg) {
+    const float toRad = 3.14159265358979323846f / 180.0f;
+    const float cp = cosf(anglesDeg.x * toRad), sp = sinf(anglesDeg.x * toRad);
+    const float cy = cosf(anglesDeg.y * toRad), sy = sinf(anglesDeg.y * toRad);
+    const float cr = cosf(anglesDeg.z * toRad), sr = sinf(anglesDeg.z * toRad);
+
+    // Ry(yaw) * Rx(pitch) * Rz(roll), written out column by column
+    Matrix4x4_f result = {};
+    result[0][0] = cy * cr + sy * sp * sr;
+    result[0][1] = cp * sr;
+    result[0][2] = -sy * cr + cy * sp * sr;
+
+    result[1][0] = -cy * sr + sy * sp * cr;
+    result[1][1] = cp * cr;
+    result[1][2] = sy * sr + cy * sp * cr;
+
+    result[2][0] = sy * cp;
+    result[2][1] = -sp;
+    result[2][2] = cy * cp;
+
+    result[3][3] = 1.0f;
+    return result;
+}
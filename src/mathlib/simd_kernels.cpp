@@ -0,0 +1,224 @@
+#include "mathlib/simd_kernels.h"
+#include <cmath>
+
+namespace simd {
+
+//-----------------------------------------------------------------------------
+// Scalar reference
+//-----------------------------------------------------------------------------
+namespace scalar {
+
+template <typename T>
+static void MulBatch(const T* a, const T* b, T* out, size_t count) {
+    for (size_t i = 0; i < count; ++i)
+        Mat4Mul(a, b + i * 16, out + i * 16);
+}
+
+// Cofactor expansion (the classic gluInvertMatrix layout)
+template <typename T>
+static bool Inverse(const T* m, T* out) {
+    T inv[16];
+
+    inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+    inv[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+    inv[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+    inv[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+    inv[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+    inv[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+    inv[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+    T det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == T(0) || !std::isfinite(det))
+        return false;
+
+    const T invDet = T(1) / det;
+    for (int i = 0; i < 16; ++i)
+        out[i] = inv[i] * invDet;
+    return true;
+}
+
+void Mat4MulBatch(const float* a, const float* b, float* out, size_t count)    { MulBatch(a, b, out, count); }
+void Mat4MulBatch(const double* a, const double* b, double* out, size_t count) { MulBatch(a, b, out, count); }
+bool Mat4Inverse(const float* m, float* out)   { return Inverse(m, out); }
+bool Mat4Inverse(const double* m, double* out) { return Inverse(m, out); }
+
+} // namespace scalar
+
+//-----------------------------------------------------------------------------
+// Batched multiply
+//-----------------------------------------------------------------------------
+void Mat4MulBatch(const float* a, const float* b, float* out, size_t count) {
+#if defined(MATHLIB_SIMD_AVX)
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+
+    // Matrices are contiguous, so 16 * count floats form 2 * count column pairs
+    const size_t pairs = count * 2;
+    for (size_t p = 0; p < pairs; ++p) {
+        const __m256 bc = _mm256_loadu_ps(b + p * 8);
+        __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bc, bc, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bc, bc, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bc, bc, 0xFF)));
+        _mm256_storeu_ps(out + p * 8, r);
+    }
+#elif defined(MATHLIB_SIMD_SSE)
+    const __m128 a0 = _mm_loadu_ps(a + 0);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+
+    const size_t columns = count * 4;
+    for (size_t c = 0; c < columns; ++c) {
+        const float* bc = b + c * 4;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_storeu_ps(out + c * 4, r);
+    }
+#else
+    scalar::Mat4MulBatch(a, b, out, count);
+#endif
+}
+
+void Mat4MulBatch(const double* a, const double* b, double* out, size_t count) {
+#if defined(MATHLIB_SIMD_AVX)
+    const __m256d a0 = _mm256_loadu_pd(a + 0);
+    const __m256d a1 = _mm256_loadu_pd(a + 4);
+    const __m256d a2 = _mm256_loadu_pd(a + 8);
+    const __m256d a3 = _mm256_loadu_pd(a + 12);
+
+    const size_t columns = count * 4;
+    for (size_t c = 0; c < columns; ++c) {
+        const double* bc = b + c * 4;
+        __m256d r = _mm256_mul_pd(a0, _mm256_broadcast_sd(bc + 0));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a1, _mm256_broadcast_sd(bc + 1)));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a2, _mm256_broadcast_sd(bc + 2)));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a3, _mm256_broadcast_sd(bc + 3)));
+        _mm256_storeu_pd(out + c * 4, r);
+    }
+#else
+    for (size_t i = 0; i < count; ++i)
+        Mat4Mul(a, b + i * 16, out + i * 16);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Inverse
+//-----------------------------------------------------------------------------
+#if defined(MATHLIB_SIMD_SSE)
+
+#define SIMD_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define SIMD_SWIZZLE(v, x, y, z, w)   _mm_shuffle_ps(v, v, SIMD_SHUFFLE_MASK(x, y, z, w))
+#define SIMD_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, SIMD_SHUFFLE_MASK(x, y, z, w))
+
+// 2x2 blocks are packed as (m00, m01, m10, m11)
+
+// A * B
+static inline __m128 Mat2Mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, SIMD_SWIZZLE(b, 0, 3, 0, 3)),
+                      _mm_mul_ps(SIMD_SWIZZLE(a, 1, 0, 3, 2), SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(SIMD_SWIZZLE(a, 3, 3, 0, 0), b),
+                      _mm_mul_ps(SIMD_SWIZZLE(a, 1, 1, 2, 2), SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, SIMD_SWIZZLE(b, 3, 0, 3, 0)),
+                      _mm_mul_ps(SIMD_SWIZZLE(a, 1, 0, 3, 2), SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+#endif
+
+// Block-wise inverse over four 2x2 sub-matrices. Inverting the transpose yields the
+// transposed inverse, so the same code serves column-major storage unchanged.
+bool Mat4Inverse(const float* m, float* out) {
+#if defined(MATHLIB_SIMD_SSE)
+    const __m128 c0 = _mm_loadu_ps(m + 0);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+
+    const __m128 A = _mm_movelh_ps(c0, c1);
+    const __m128 B = _mm_movehl_ps(c1, c0);
+    const __m128 C = _mm_movelh_ps(c2, c3);
+    const __m128 D = _mm_movehl_ps(c3, c2);
+
+    // (|A| |B| |C| |D|)
+    const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(SIMD_SHUFFLE(c0, c2, 0, 2, 0, 2), SIMD_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+        _mm_mul_ps(SIMD_SHUFFLE(c0, c2, 1, 3, 1, 3), SIMD_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+    const __m128 detA = SIMD_SWIZZLE(detSub, 0, 0, 0, 0);
+    const __m128 detB = SIMD_SWIZZLE(detSub, 1, 1, 1, 1);
+    const __m128 detC = SIMD_SWIZZLE(detSub, 2, 2, 2, 2);
+    const __m128 detD = SIMD_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    const __m128 D_C = Mat2AdjMul(D, C);
+    const __m128 A_B = Mat2AdjMul(A, B);
+
+    __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+    __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+    __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+    __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 tr = _mm_mul_ps(A_B, SIMD_SWIZZLE(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, SIMD_SWIZZLE(tr, 1, 0, 3, 2));
+    tr = _mm_add_ps(tr, SIMD_SWIZZLE(tr, 2, 3, 0, 1));
+
+    __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    detM = _mm_sub_ps(detM, tr);
+
+    const float det = _mm_cvtss_f32(detM);
+    if (det == 0.0f || !std::isfinite(det))
+        return false;
+
+    const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rDetM);
+    Y_ = _mm_mul_ps(Y_, rDetM);
+    Z_ = _mm_mul_ps(Z_, rDetM);
+    W_ = _mm_mul_ps(W_, rDetM);
+
+    _mm_storeu_ps(out + 0,  SIMD_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 4,  SIMD_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+    _mm_storeu_ps(out + 8,  SIMD_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+    _mm_storeu_ps(out + 12, SIMD_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+    return true;
+#else
+    return scalar::Mat4Inverse(m, out);
+#endif
+}
+
+// Double inverses are rare (camera setup, not per-instance), so they stay on
+// the cofactor path where the precision is easiest to reason about.
+bool Mat4Inverse(const double* m, double* out) {
+    return scalar::Mat4Inverse(m, out);
+}
+
+const char* GetISAName() {
+#if defined(MATHLIB_SIMD_AVX)
+    return "AVX";
+#elif defined(MATHLIB_SIMD_SSE)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+} // namespace simd
@@ -0,0 +1,284 @@
+#include "mathlib/vector3_batch.h"
+#include "mathlib/simd_kernels.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//-----------------------------------------------------------------------------
+// Lane wrappers: one SIMD register's worth of floats or doubles. Every kernel
+// below runs full-width packs first and finishes the remainder with Width = 1.
+//-----------------------------------------------------------------------------
+template <typename T>
+struct ScalarPack {
+    using V = T;
+    static constexpr size_t Width = 1;
+    static V Load(const T* p) { return *p; }
+    static void Store(T* p, V v) { *p = v; }
+    static V Set1(T s) { return s; }
+    static V Add(V a, V b) { return a + b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Max(V a, V b) { return a > b ? a : b; }
+    static V Sqrt(V a) { return std::sqrt(a); }
+};
+
+#if defined(MATHLIB_SIMD_AVX)
+struct FloatPack {
+    using V = __m256;
+    static constexpr size_t Width = 8;
+    static V Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V Set1(float s) { return _mm256_set1_ps(s); }
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V Sqrt(V a) { return _mm256_sqrt_ps(a); }
+};
+struct DoublePack {
+    using V = __m256d;
+    static constexpr size_t Width = 4;
+    static V Load(const double* p) { return _mm256_loadu_pd(p); }
+    static void Store(double* p, V v) { _mm256_storeu_pd(p, v); }
+    static V Set1(double s) { return _mm256_set1_pd(s); }
+    static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V Div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V Max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V Sqrt(V a) { return _mm256_sqrt_pd(a); }
+};
+#elif defined(MATHLIB_SIMD_SSE)
+struct FloatPack {
+    using V = __m128;
+    static constexpr size_t Width = 4;
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Set1(float s) { return _mm_set1_ps(s); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Max(V a, V b) { return _mm_max_ps(a, b); }
+    static V Sqrt(V a) { return _mm_sqrt_ps(a); }
+};
+struct DoublePack {
+    using V = __m128d;
+    static constexpr size_t Width = 2;
+    static V Load(const double* p) { return _mm_loadu_pd(p); }
+    static void Store(double* p, V v) { _mm_storeu_pd(p, v); }
+    static V Set1(double s) { return _mm_set1_pd(s); }
+    static V Add(V a, V b) { return _mm_add_pd(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V Div(V a, V b) { return _mm_div_pd(a, b); }
+    static V Max(V a, V b) { return _mm_max_pd(a, b); }
+    static V Sqrt(V a) { return _mm_sqrt_pd(a); }
+};
+#else
+using FloatPack = ScalarPack<float>;
+using DoublePack = ScalarPack<double>;
+#endif
+
+//-----------------------------------------------------------------------------
+// Kernels. Each processes elements [begin, end) and returns where it stopped,
+// so the wide pass leaves a tail for the scalar pass.
+//-----------------------------------------------------------------------------
+template <typename P, typename T>
+static size_t AddBatch(T* x, T* y, T* z, const T* ox, const T* oy, const T* oz, size_t i, size_t n) {
+    for (; i + P::Width <= n; i += P::Width) {
+        P::Store(x + i, P::Add(P::Load(x + i), P::Load(ox + i)));
+        P::Store(y + i, P::Add(P::Load(y + i), P::Load(oy + i)));
+        P::Store(z + i, P::Add(P::Load(z + i), P::Load(oz + i)));
+    }
+    return i;
+}
+
+template <typename P, typename T>
+static size_t AddOffset(T* x, T* y, T* z, T ox, T oy, T oz, size_t i, size_t n) {
+    const auto vx = P::Set1(ox), vy = P::Set1(oy), vz = P::Set1(oz);
+    for (; i + P::Width <= n; i += P::Width) {
+        P::Store(x + i, P::Add(P::Load(x + i), vx));
+        P::Store(y + i, P::Add(P::Load(y + i), vy));
+        P::Store(z + i, P::Add(P::Load(z + i), vz));
+    }
+    return i;
+}
+
+template <typename P, typename T>
+static size_t ScaleBatch(T* x, T* y, T* z, T s, size_t i, size_t n) {
+    const auto vs = P::Set1(s);
+    for (; i + P::Width <= n; i += P::Width) {
+        P::Store(x + i, P::Mul(P::Load(x + i), vs));
+        P::Store(y + i, P::Mul(P::Load(y + i), vs));
+        P::Store(z + i, P::Mul(P::Load(z + i), vs));
+    }
+    return i;
+}
+
+// A zero vector has zero components, so dividing by a clamped length keeps it at zero
+// where Vector3::Normalize special-cases it.
+template <typename P, typename T>
+static size_t NormalizeBatch(T* x, T* y, T* z, T minLength, size_t i, size_t n) {
+    const auto vmin = P::Set1(minLength);
+    for (; i + P::Width <= n; i += P::Width) {
+        auto vx = P::Load(x + i), vy = P::Load(y + i), vz = P::Load(z + i);
+        auto len = P::Sqrt(P::Add(P::Add(P::Mul(vx, vx), P::Mul(vy, vy)), P::Mul(vz, vz)));
+        len = P::Max(len, vmin);
+        P::Store(x + i, P::Div(vx, len));
+        P::Store(y + i, P::Div(vy, len));
+        P::Store(z + i, P::Div(vz, len));
+    }
+    return i;
+}
+
+template <typename P, typename T>
+static size_t DotBatch(const T* x, const T* y, const T* z, const T* ox, const T* oy, const T* oz,
+                       T* out, size_t i, size_t n) {
+    for (; i + P::Width <= n; i += P::Width) {
+        auto d = P::Add(P::Add(P::Mul(P::Load(x + i), P::Load(ox + i)),
+                               P::Mul(P::Load(y + i), P::Load(oy + i))),
+                        P::Mul(P::Load(z + i), P::Load(oz + i)));
+        P::Store(out + i, d);
+    }
+    return i;
+}
+
+template <typename P, typename T>
+static size_t LengthBatch(const T* x, const T* y, const T* z, T* out, size_t i, size_t n) {
+    for (; i + P::Width <= n; i += P::Width) {
+        auto vx = P::Load(x + i), vy = P::Load(y + i), vz = P::Load(z + i);
+        P::Store(out + i, P::Sqrt(P::Add(P::Add(P::Mul(vx, vx), P::Mul(vy, vy)), P::Mul(vz, vz))));
+    }
+    return i;
+}
+
+// m is column-major: x' = m[0][0]x + m[1][0]y + m[2][0]z + m[3][0]
+template <typename P, typename T>
+static size_t TransformBatch(const T (*m)[4], const T* x, const T* y, const T* z,
+                             T* ox, T* oy, T* oz, size_t i, size_t n) {
+    const auto m00 = P::Set1(m[0][0]), m10 = P::Set1(m[1][0]), m20 = P::Set1(m[2][0]), m30 = P::Set1(m[3][0]);
+    const auto m01 = P::Set1(m[0][1]), m11 = P::Set1(m[1][1]), m21 = P::Set1(m[2][1]), m31 = P::Set1(m[3][1]);
+    const auto m02 = P::Set1(m[0][2]), m12 = P::Set1(m[1][2]), m22 = P::Set1(m[2][2]), m32 = P::Set1(m[3][2]);
+    for (; i + P::Width <= n; i += P::Width) {
+        auto vx = P::Load(x + i), vy = P::Load(y + i), vz = P::Load(z + i);
+        P::Store(ox + i, P::Add(P::Add(P::Mul(m00, vx), P::Mul(m10, vy)), P::Add(P::Mul(m20, vz), m30)));
+        P::Store(oy + i, P::Add(P::Add(P::Mul(m01, vx), P::Mul(m11, vy)), P::Add(P::Mul(m21, vz), m31)));
+        P::Store(oz + i, P::Add(P::Add(P::Mul(m02, vx), P::Mul(m12, vy)), P::Add(P::Mul(m22, vz), m32)));
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+// Vector3Batch_f
+//-----------------------------------------------------------------------------
+void Vector3Batch_f::Add(const Vector3Batch_f& other) {
+    const size_t n = std::min(Size(), other.Size());
+    size_t i = AddBatch<FloatPack>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), 0, n);
+    AddBatch<ScalarPack<float>>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), i, n);
+}
+
+void Vector3Batch_f::Add(const Vector3_f& offset) {
+    const size_t n = Size();
+    size_t i = AddOffset<FloatPack>(X(), Y(), Z(), offset.x, offset.y, offset.z, 0, n);
+    AddOffset<ScalarPack<float>>(X(), Y(), Z(), offset.x, offset.y, offset.z, i, n);
+}
+
+void Vector3Batch_f::Scale(float s) {
+    const size_t n = Size();
+    size_t i = ScaleBatch<FloatPack>(X(), Y(), Z(), s, 0, n);
+    ScaleBatch<ScalarPack<float>>(X(), Y(), Z(), s, i, n);
+}
+
+void Vector3Batch_f::Normalize() {
+    const size_t n = Size();
+    size_t i = NormalizeBatch<FloatPack>(X(), Y(), Z(), FLT_MIN, 0, n);
+    NormalizeBatch<ScalarPack<float>>(X(), Y(), Z(), FLT_MIN, i, n);
+}
+
+void Vector3Batch_f::Dot(const Vector3Batch_f& other, float* out) const {
+    const size_t n = std::min(Size(), other.Size());
+    size_t i = DotBatch<FloatPack>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), out, 0, n);
+    DotBatch<ScalarPack<float>>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), out, i, n);
+}
+
+void Vector3Batch_f::Length(float* out) const {
+    const size_t n = Size();
+    size_t i = LengthBatch<FloatPack>(X(), Y(), Z(), out, 0, n);
+    LengthBatch<ScalarPack<float>>(X(), Y(), Z(), out, i, n);
+}
+
+void Vector3Batch_f::TransformPoints(const Matrix4x4_f& m, Vector3Batch_f& out) const {
+    const size_t n = Size();
+    out.Resize(n);
+    size_t i = TransformBatch<FloatPack>(m.m, X(), Y(), Z(), out.X(), out.Y(), out.Z(), 0, n);
+    TransformBatch<ScalarPack<float>>(m.m, X(), Y(), Z(), out.X(), out.Y(), out.Z(), i, n);
+}
+
+//-----------------------------------------------------------------------------
+// Vector3Batch_d
+//-----------------------------------------------------------------------------
+void Vector3Batch_d::Add(const Vector3Batch_d& other) {
+    const size_t n = std::min(Size(), other.Size());
+    size_t i = AddBatch<DoublePack>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), 0, n);
+    AddBatch<ScalarPack<double>>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), i, n);
+}
+
+void Vector3Batch_d::Add(const Vector3_d& offset) {
+    const size_t n = Size();
+    size_t i = AddOffset<DoublePack>(X(), Y(), Z(), offset.x, offset.y, offset.z, 0, n);
+    AddOffset<ScalarPack<double>>(X(), Y(), Z(), offset.x, offset.y, offset.z, i, n);
+}
+
+void Vector3Batch_d::Scale(double s) {
+    const size_t n = Size();
+    size_t i = ScaleBatch<DoublePack>(X(), Y(), Z(), s, 0, n);
+    ScaleBatch<ScalarPack<double>>(X(), Y(), Z(), s, i, n);
+}
+
+void Vector3Batch_d::Normalize() {
+    const size_t n = Size();
+    size_t i = NormalizeBatch<DoublePack>(X(), Y(), Z(), DBL_MIN, 0, n);
+    NormalizeBatch<ScalarPack<double>>(X(), Y(), Z(), DBL_MIN, i, n);
+}
+
+void Vector3Batch_d::Dot(const Vector3Batch_d& other, double* out) const {
+    const size_t n = std::min(Size(), other.Size());
+    size_t i = DotBatch<DoublePack>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), out, 0, n);
+    DotBatch<ScalarPack<double>>(X(), Y(), Z(), other.X(), other.Y(), other.Z(), out, i, n);
+}
+
+void Vector3Batch_d::Length(double* out) const {
+    const size_t n = Size();
+    size_t i = LengthBatch<DoublePack>(X(), Y(), Z(), out, 0, n);
+    LengthBatch<ScalarPack<double>>(X(), Y(), Z(), out, i, n);
+}
+
+void Vector3Batch_d::TransformPoints(const Matrix4x4_d& m, Vector3Batch_d& out) const {
+    const size_t n = Size();
+    out.Resize(n);
+    size_t i = TransformBatch<DoublePack>(m.m, X(), Y(), Z(), out.X(), out.Y(), out.Z(), 0, n);
+    TransformBatch<ScalarPack<double>>(m.m, X(), Y(), Z(), out.X(), out.Y(), out.Z(), i, n);
+}
+
+// Subtract in double, then narrow: the difference is small, so the float keeps full precision
+void Vector3Batch_d::ToLocal(const Vector3_d& origin, Vector3Batch_f& out, size_t first, size_t count) const {
+    const size_t end = std::min(first + count, std::min(Size(), out.Size()));
+    const double* src[3] = { X(), Y(), Z() };
+    float* dst[3] = { out.X(), out.Y(), out.Z() };
+    const double o[3] = { origin.x, origin.y, origin.z };
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const double* in = src[axis];
+        float* result = dst[axis];
+        size_t i = first;
+#if defined(MATHLIB_SIMD_AVX)
+        const __m256d vo = _mm256_set1_pd(o[axis]);
+        for (; i + 4 <= end; i += 4)
+            _mm_storeu_ps(result + i, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(in + i), vo)));
+#elif defined(MATHLIB_SIMD_SSE)
+        const __m128d vo = _mm_set1_pd(o[axis]);
+        for (; i + 2 <= end; i += 2)
+            _mm_storel_pi(reinterpret_cast<__m64*>(result + i), _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(in + i), vo)));
+#endif
+        for (; i < end; ++i)
+            result[i] = static_cast<float>(in[i] - o[axis]);
+    }
+}
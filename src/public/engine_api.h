@@ -8,6 +8,16 @@
 #define STDCALL
 #endif
 
+// Launcher arguments, read before Engine_Run (optional):
+//   -nullrender             no window or GPU; draws go to the null render backend
+//                           on the main thread (implies -norenderthread)
+//   -rendercmdlog <file>    with -nullrender, record every render call to file
+//   -benchframes <n>        run n frames at a fixed 1/60 s step, log timings and exit
+//   -norenderthread         draw on the main thread instead of a dedicated render thread
+//   -uploadbudget <KB>      mesh upload bytes per frame (default 4096)
+//   -uploadms <ms>          mesh upload time per frame (default 2)
+DLL_EXPORT void STDCALL Engine_SetCommandLine(int argc, char** argv);
+
 DLL_EXPORT void STDCALL Engine_Run();
 DLL_EXPORT void STDCALL Engine_Shutdown();
 
@@ -1,6 +1,76 @@
 #pragma once
+#include <atomic>
 #include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------
+// Engine log: callers format into a slot of a lock-free MPSC ring and return;
+// a writer thread drains the ring and writes in batches (one fflush per batch,
+// not per line). If the ring is full, producers wait for the writer rather than
+// lose lines. The ring is drained on shutdown, on EngineLog_Flush, and from the
+// crash handlers (unhandled exception, std::terminate, fatal signals).
+//
+//   EngineLog("[Tag] %d", x);                     // General / Info, as before
+//   ENGINE_LOG_DEBUG(World, "[Loader] %s", name);  // filtered per category
+//
+// The ENGINE_LOG_* macros test the category's level before evaluating any
+// argument, so a filtered-out line costs one relaxed load. Debug lines are
+// compiled out entirely in Release (NDEBUG) builds.
+//-----------------------------------------------------------------------------
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+enum class LogCategory : uint8_t {
+    General,
+    Engine,
+    World,
+    Streaming,
+    Render,
+    Profiler,
+    Count
+};
 
 void EngineLog_Init(const char* filename = "logs/engine.log");
-void EngineLog_Shutdown();
-void EngineLog(const char* fmt, ...);
\ No newline at end of file
+void EngineLog_Shutdown();  // Drains everything, joins the writer, closes the file
+void EngineLog_Flush();     // Returns once every line logged so far is on disk
+
+void EngineLog(const char* fmt, ...);
+void EngineLog_Write(LogCategory category, LogLevel level, const char* fmt, ...);
+void EngineLog_WriteV(LogCategory category, LogLevel level, const char* fmt, va_list args);
+
+void EngineLog_SetLevel(LogCategory category, LogLevel minLevel);
+LogLevel EngineLog_GetLevel(LogCategory category);
+
+extern std::atomic<uint8_t> g_EngineLogLevels[static_cast<size_t>(LogCategory::Count)];
+
+inline bool EngineLog_IsEnabled(LogCategory category, LogLevel level) {
+    return static_cast<uint8_t>(level) >=
+           g_EngineLogLevels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+#define ENGINE_LOG(category, level, ...)                                                  \
+    do {                                                                                  \
+        if (EngineLog_IsEnabled(LogCategory::category, LogLevel::level))                  \
+            EngineLog_Write(LogCategory::category, LogLevel::level, __VA_ARGS__);         \
+    } while (0)
+
+#ifdef NDEBUG
+// Dead branch: the arguments still count as used, but no code is emitted
+#define ENGINE_LOG_DEBUG(category, ...)                                                   \
+    do {                                                                                  \
+        if (false)                                                                        \
+            EngineLog_Write(LogCategory::category, LogLevel::Debug, __VA_ARGS__);         \
+    } while (0)
+#else
+#define ENGINE_LOG_DEBUG(category, ...)     ENGINE_LOG(category, Debug, __VA_ARGS__)
+#endif
+#define ENGINE_LOG_INFO(category, ...)      ENGINE_LOG(category, Info, __VA_ARGS__)
+#define ENGINE_LOG_WARNING(category, ...)   ENGINE_LOG(category, Warning, __VA_ARGS__)
+#define ENGINE_LOG_ERROR(category, ...)     ENGINE_LOG(category, Error, __VA_ARGS__)
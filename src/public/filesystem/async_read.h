@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "filesystem/file_view.h"
+
+// Asynchronous reads (FS_ReadAsync). A pool of I/O threads opens the file (see
+// FS_OpenMapped) and touches every page of it, so the bytes are resident by the
+// time the callback runs and parsing never stalls on disk.
+//
+// Jobs run highest priority first, in submission order within a priority.
+// Callbacks run on an I/O thread and receive nullptr if the file doesn't exist;
+// keep them short and hand heavy work to the caller's own thread. A cancelled job
+// never calls its callback.
+
+enum class FSReadPriority : uint8_t {
+    Prefetch,       // Might be needed soon; first to wait
+    Normal,
+    High,           // Needed for the next frame or two
+    Count
+};
+
+using FSAsyncHandle = uint64_t;     // 0 is never a valid handle
+using FSReadCallback = std::function<void(FSFileViewPtr file)>;
+
+// Signatures of the exports, for modules that receive them as callbacks
+using FSReadAsyncFn = FSAsyncHandle (*)(const std::string& relative_path, FSReadPriority priority,
+                                        FSReadCallback callback);
+using FSCancelAsyncFn = bool (*)(FSAsyncHandle handle);
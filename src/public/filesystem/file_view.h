@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Read-only bytes of one file, from FS_OpenMapped. Loose files and stored pack
+// entries point straight into a memory mapping; compressed pack entries point at
+// their decompressed copy. The bytes stay valid for as long as any reference to
+// the view is held, including past FS_Shutdown. The data is not NUL-terminated.
+struct FSFileView {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    std::string_view Text() const { return { reinterpret_cast<const char*>(data), size }; }
+};
+
+using FSFileViewPtr = std::shared_ptr<const FSFileView>;
+
+// Signature of FS_OpenMapped, for modules that receive it as a callback
+using FSOpenMappedFn = FSFileViewPtr (*)(const std::string& relative_path);
@@ -0,0 +1,195 @@
+#pragma once
+
+// LZ4 block format codec (no frame header, no checksums), shared by packbuilder and
+// the stdio filesystem. Output is compatible with the reference LZ4_compress_default /
+// LZ4_decompress_safe, so packs can also be inspected with stock lz4 tooling.
+//
+// The compressor is the plain greedy single-probe hash matcher: fast enough for an
+// offline tool and the ratio is close to the reference at its default level.
+// The decompressor validates every length and offset against both buffers, so a
+// corrupt pack fails the read instead of writing out of bounds.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace lz4 {
+
+constexpr size_t MIN_MATCH     = 4;
+constexpr size_t LAST_LITERALS = 5;     // The last 5 bytes of a block are always literals
+constexpr size_t MF_LIMIT      = 12;    // A match can't start within 12 bytes of the end
+constexpr size_t MAX_OFFSET    = 65535;
+constexpr int    HASH_LOG      = 12;
+
+inline size_t CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+namespace detail {
+
+inline uint32_t Read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// 15 in the token nibble, then runs of 255 plus a final remainder byte
+inline bool WriteLength(uint8_t*& op, const uint8_t* opEnd, size_t length) {
+    for (; length >= 255; length -= 255) {
+        if (op >= opEnd)
+            return false;
+        *op++ = 255;
+    }
+    if (op >= opEnd)
+        return false;
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+inline bool ReadLength(const uint8_t*& ip, const uint8_t* ipEnd, size_t& length) {
+    uint8_t b;
+    do {
+        if (ip >= ipEnd)
+            return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+inline bool WriteSequence(uint8_t*& op, const uint8_t* opEnd, const uint8_t* literals, size_t literalLength,
+                          size_t offset, size_t matchLength) {
+    if (op >= opEnd)
+        return false;
+
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+    if (literalLength >= 15 && !WriteLength(op, opEnd, literalLength - 15))
+        return false;
+
+    if (static_cast<size_t>(opEnd - op) < literalLength)
+        return false;
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+
+    if (matchLength == 0)
+        return true; // Last sequence: literals only
+
+    if (opEnd - op < 2)
+        return false;
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    const size_t code = matchLength - MIN_MATCH;
+    *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+    return code < 15 || WriteLength(op, opEnd, code - 15);
+}
+
+} // namespace detail
+
+// Returns the compressed size, or 0 if the output didn't fit in dstCapacity
+// (CompressBound(srcSize) always fits)
+inline size_t CompressBlock(const void* source, size_t srcSize, void* dest, size_t dstCapacity) {
+    const uint8_t* src = static_cast<const uint8_t*>(source);
+    uint8_t* op = static_cast<uint8_t*>(dest);
+    const uint8_t* opEnd = op + dstCapacity;
+
+    size_t anchor = 0;
+    if (srcSize > MF_LIMIT) {
+        uint32_t table[1u << HASH_LOG];
+        std::memset(table, 0, sizeof(table));
+
+        const size_t matchStartLimit = srcSize - MF_LIMIT;
+        const size_t matchEndLimit = srcSize - LAST_LITERALS;
+
+        size_t ip = 1; // Position 0 only seeds the table
+        table[detail::Hash(detail::Read32(src))] = 0;
+
+        while (ip < matchStartLimit) {
+            const uint32_t sequence = detail::Read32(src + ip);
+            const uint32_t h = detail::Hash(sequence);
+            const size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+
+            if (ip - ref > MAX_OFFSET || detail::Read32(src + ref) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            size_t start = ip;
+            size_t match = ref;
+            while (start > anchor && match > 0 && src[start - 1] == src[match - 1]) {
+                --start;
+                --match;
+            }
+
+            size_t end = ip + MIN_MATCH;
+            while (end < matchEndLimit && src[end] == src[match + (end - start)])
+                ++end;
+
+            if (!detail::WriteSequence(op, opEnd, src + anchor, start - anchor, start - match, end - start))
+                return 0;
+
+            anchor = ip = end;
+            if (ip - 2 < matchStartLimit)
+                table[detail::Hash(detail::Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    if (!detail::WriteSequence(op, opEnd, src + anchor, srcSize - anchor, 0, 0))
+        return 0;
+    return static_cast<size_t>(op - static_cast<uint8_t*>(dest));
+}
+
+// Decodes exactly dstSize bytes; false on malformed input or a size mismatch
+inline bool DecompressBlock(const void* source, size_t srcSize, void* dest, size_t dstSize) {
+    const uint8_t* ip = static_cast<const uint8_t*>(source);
+    const uint8_t* const ipEnd = ip + srcSize;
+    uint8_t* const dst = static_cast<uint8_t*>(dest);
+    uint8_t* op = dst;
+    uint8_t* const opEnd = dst + dstSize;
+
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !detail::ReadLength(ip, ipEnd, literalLength))
+            return false;
+        if (static_cast<size_t>(ipEnd - ip) < literalLength || static_cast<size_t>(opEnd - op) < literalLength)
+            return false;
+        std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == ipEnd)
+            break; // Last sequence has no match
+
+        if (ipEnd - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !detail::ReadLength(ip, ipEnd, matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+        if (static_cast<size_t>(opEnd - op) < matchLength)
+            return false;
+
+        // Byte copy: the match may overlap the bytes it produces (offset < length)
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < matchLength; ++i)
+            op[i] = match[i];
+        op += matchLength;
+    }
+
+    return op == opEnd;
+}
+
+} // namespace lz4
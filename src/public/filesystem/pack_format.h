@@ -0,0 +1,61 @@
+#pragma once
+
+// Pack file (.ipak) on-disk layout.
+// Produced offline by packbuilder from a content directory and mounted by the
+// stdio filesystem from gameinfo.txt SearchPaths; the whole pack is mapped once
+// and entries are read straight out of the mapping.
+//
+//   PackHeader
+//   PackDirectory  directories[directoryCount]   (sorted by path)
+//   PackEntry      entries[entryCount]           (grouped by directory, sorted by name)
+//   char           stringTable[stringTableSize]  (NUL-terminated strings)
+//   ...            entry data
+//
+// Directory paths are relative to the pack root, lowercase, '/'-separated and
+// without a trailing slash ("" is the root). Entry names are the file name only,
+// so the full path is "<directory>/<name>". Offsets are in bytes from the start of
+// the file and all values are little-endian.
+
+#include <cstdint>
+
+constexpr uint32_t PACK_MAGIC   = 0x4B415049; // "IPAK"
+constexpr uint32_t PACK_VERSION = 1;
+
+enum class PackCompression : uint32_t {
+    None = 0,
+    LZ4  = 1    // Raw LZ4 block (no frame), see filesystem/lz4_block.h
+};
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    uint32_t directoryCount;
+    uint32_t directoryOffset;
+
+    uint32_t entryCount;
+    uint32_t entryOffset;
+
+    uint32_t stringTableSize;
+    uint32_t stringTableOffset;
+
+    uint64_t fileSize;
+};
+
+struct PackDirectory {
+    uint32_t pathOffset;        // Into the string table
+    uint32_t firstEntry;
+    uint32_t entryCount;
+};
+
+struct PackEntry {
+    uint32_t nameOffset;        // Into the string table
+    uint32_t compression;       // PackCompression
+    uint64_t dataOffset;
+    uint32_t storedSize;        // Bytes in the pack
+    uint32_t size;              // Bytes once decompressed
+};
+
+static_assert(sizeof(PackHeader) == 10 * 4, "PackHeader must stay packed");
+static_assert(sizeof(PackDirectory) == 3 * 4, "PackDirectory must stay packed");
+static_assert(sizeof(PackEntry) == 6 * 4, "PackEntry must stay packed");
@@ -2,6 +2,9 @@
 #include <string>
 #include <vector>
 
+#include "filesystem/async_read.h"
+#include "filesystem/file_view.h"
+
 // Define DLL_EXPORT cross-platform
 #if defined(_WIN32) || defined(_WIN64)
   #ifdef BUILDING_FILESYSTEM_DLL
@@ -15,6 +18,24 @@
 
 // C++-only API — don't wrap in extern "C"
 DLL_EXPORT bool FS_Init(const std::string& gameinfo_path);
+// Full path of a loose file; packed files have no path on disk and resolve to ""
 DLL_EXPORT std::string FS_ResolvePath(const std::string& relative_path);
+// Read-only view of a whole file, loose or packed (.ipak search paths; loose files
+// override packed ones); nullptr if it doesn't exist. Parse straight from the view.
+DLL_EXPORT FSFileViewPtr FS_OpenMapped(const std::string& relative_path);
+// Copy of a whole file, for callers that need to own or modify the bytes
+DLL_EXPORT bool FS_ReadFile(const std::string& relative_path, std::vector<char>& out);
+
+// Queues an FS_OpenMapped on the I/O threads (see filesystem/async_read.h); 0 before FS_Init
+DLL_EXPORT FSAsyncHandle FS_ReadAsync(const std::string& relative_path, FSReadPriority priority,
+                                      FSReadCallback callback);
+// True if the read was still queued and will now never run
+DLL_EXPORT bool FS_CancelAsync(FSAsyncHandle handle);
 DLL_EXPORT const std::string& FS_GetGameDir();
 DLL_EXPORT const std::vector<std::string>& FS_GetSearchPaths();
+
+// Resolves come from an index of every file under the search paths, built at FS_Init.
+// It follows files coming and going under the mounts (Windows change notifications); call
+// this to force a rebuild, e.g. after a tool wrote files on a platform without notifications.
+DLL_EXPORT void FS_RefreshIndex();
+DLL_EXPORT void FS_Shutdown();
@@ -1,5 +1,6 @@
 #pragma once
 #include "mathlib/vector3_d.h"
+#include "mathlib/simd_kernels.h"
 
 class Matrix4x4_d {
 public:
@@ -26,4 +27,28 @@ public:
 	static Matrix4x4_d Translate(const Vector3_d& offset);
 };
 
-Matrix4x4_d operator*(const Matrix4x4_d& a, const Matrix4x4_d& b);
+static_assert(sizeof(Matrix4x4_d) == 16 * sizeof(double), "Matrix4x4_d arrays are passed to the SIMD kernels as flat doubles");
+
+inline Matrix4x4_d operator*(const Matrix4x4_d& a, const Matrix4x4_d& b)
+{
+    Matrix4x4_d result;
+    simd::Mat4Mul(a.Data(), b.Data(), &result.m[0][0]);
+    return result;
+}
+
+inline void TransformVec4(const Matrix4x4_d& m, const double in[4], double out[4])
+{
+    simd::Mat4MulVec4(m.Data(), in, out);
+}
+
+inline void MultiplyBatch(const Matrix4x4_d& a, const Matrix4x4_d* b, Matrix4x4_d* out, size_t count)
+{
+    if (count == 0)
+        return; // b and out may be null (empty vectors' data())
+    simd::Mat4MulBatch(a.Data(), b->Data(), &out->m[0][0], count);
+}
+
+inline bool Invert(const Matrix4x4_d& m, Matrix4x4_d& out)
+{
+    return simd::Mat4Inverse(m.Data(), &out.m[0][0]);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "mathlib/vector3_f.h"
+#include "mathlib/simd_kernels.h"
 
 struct Matrix4x4_f {
     float m[4][4]; // COLUMN-MAJOR: m[col][row]
@@ -12,22 +13,46 @@ struct Matrix4x4_f {
     static Matrix4x4_f Identity();
     static Matrix4x4_f Translation(const Vector3_f& t);
     static Matrix4x4_f LookAt(const Vector3_f& eye, const Vector3_f& center, const Vector3_f& up);
+    static Matrix4x4_f LookTo(const Vector3_f& eye, const Vector3_f& forward, const Vector3_f& up);
     static Matrix4x4_f Perspective(float fovYDeg, float aspect, float nearZ, float farZ);
 
 	// FOR SHADOWS
     static Matrix4x4_f Orthographic(float left, float right, float bottom, float top, float nearZ, float farZ);
 	
 	static Matrix4x4_f Translate(const Vector3_f& offset);
+	static Matrix4x4_f Scale(const Vector3_f& scale);
+
+	// Entity angles in degrees (pitch about X, yaw about Y, roll about Z), applied roll, pitch, then yaw
+	static Matrix4x4_f Rotation(const Vector3_f& anglesDeg);
 };
 
+static_assert(sizeof(Matrix4x4_f) == 16 * sizeof(float), "Matrix4x4_f arrays are passed to the SIMD kernels as flat floats");
+
 inline Matrix4x4_f operator*(const Matrix4x4_f& a, const Matrix4x4_f& b)
 {
-    Matrix4x4_f result = {};
-    for (int col = 0; col < 4; ++col)
-        for (int row = 0; row < 4; ++row)
-            for (int i = 0; i < 4; ++i)
-                result[col][row] += a[i][row] * b[col][i];
+    Matrix4x4_f result;
+    simd::Mat4Mul(a.Data(), b.Data(), &result.m[0][0]);
     return result;
 }
 
+// out = m * in, for a homogeneous (x, y, z, w) vector
+inline void TransformVec4(const Matrix4x4_f& m, const float in[4], float out[4])
+{
+    simd::Mat4MulVec4(m.Data(), in, out);
+}
+
+// out[i] = a * b[i]; e.g. viewProj * model for a whole instance list
+inline void MultiplyBatch(const Matrix4x4_f& a, const Matrix4x4_f* b, Matrix4x4_f* out, size_t count)
+{
+    if (count == 0)
+        return; // b and out may be null (empty vectors' data())
+    simd::Mat4MulBatch(a.Data(), b->Data(), &out->m[0][0], count);
+}
+
+// Returns false and leaves out unchanged when m is singular
+inline bool Invert(const Matrix4x4_f& m, Matrix4x4_f& out)
+{
+    return simd::Mat4Inverse(m.Data(), &out.m[0][0]);
+}
+
 using Mat4_f = Matrix4x4_f;	// Matrix4x4_f and Mat4_f be used interchangeably.
\ No newline at end of file
@@ -0,0 +1,143 @@
+// simd_kernels.h
+#pragma once
+
+// 4x4 matrix kernels on raw column-major arrays (m[col * 4 + row]), shared by
+// Matrix4x4_f and Matrix4x4_d. The instruction set is picked at compile time:
+//
+//   AVX     -march=native / -mavx (Release builds)
+//   SSE2    any x86-64 build (Debug builds)
+//   Scalar  other targets, or when MATHLIB_NO_SIMD is defined
+//
+// simd::scalar holds the plain reference versions, always compiled, used as the
+// fallback and as the baseline for the mathbench tool.
+
+#include <cstddef>
+
+#if !defined(MATHLIB_NO_SIMD) && defined(__AVX__)
+    #define MATHLIB_SIMD_AVX 1
+    #define MATHLIB_SIMD_SSE 1
+    #include <immintrin.h>
+#elif !defined(MATHLIB_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+    #define MATHLIB_SIMD_SSE 1
+    #include <emmintrin.h>
+#endif
+
+namespace simd {
+
+namespace scalar {
+
+template <typename T>
+inline void Mat4Mul(const T* a, const T* b, T* out) {
+    for (int col = 0; col < 4; ++col) {
+        for (int row = 0; row < 4; ++row) {
+            T sum = T(0);
+            for (int i = 0; i < 4; ++i)
+                sum += a[i * 4 + row] * b[col * 4 + i];
+            out[col * 4 + row] = sum;
+        }
+    }
+}
+
+template <typename T>
+inline void Mat4MulVec4(const T* m, const T* v, T* out) {
+    for (int row = 0; row < 4; ++row)
+        out[row] = m[row] * v[0] + m[4 + row] * v[1] + m[8 + row] * v[2] + m[12 + row] * v[3];
+}
+
+void Mat4MulBatch(const float* a, const float* b, float* out, size_t count);
+void Mat4MulBatch(const double* a, const double* b, double* out, size_t count);
+bool Mat4Inverse(const float* m, float* out);
+bool Mat4Inverse(const double* m, double* out);
+
+} // namespace scalar
+
+// out = a * b. out must not alias a or b.
+inline void Mat4Mul(const float* a, const float* b, float* out) {
+#if defined(MATHLIB_SIMD_AVX)
+    // Two output columns per iteration: each 128-bit lane carries one column of b
+    const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 0));
+    const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+    const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+    const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+    for (int col = 0; col < 4; col += 2) {
+        const __m256 bc = _mm256_loadu_ps(b + col * 4);
+        __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bc, bc, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bc, bc, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(a3, _mm256_shuffle_ps(bc, bc, 0xFF)));
+        _mm256_storeu_ps(out + col * 4, r);
+    }
+#elif defined(MATHLIB_SIMD_SSE)
+    const __m128 a0 = _mm_loadu_ps(a + 0);
+    const __m128 a1 = _mm_loadu_ps(a + 4);
+    const __m128 a2 = _mm_loadu_ps(a + 8);
+    const __m128 a3 = _mm_loadu_ps(a + 12);
+    for (int col = 0; col < 4; ++col) {
+        const float* bc = b + col * 4;
+        __m128 r = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_storeu_ps(out + col * 4, r);
+    }
+#else
+    scalar::Mat4Mul(a, b, out);
+#endif
+}
+
+inline void Mat4Mul(const double* a, const double* b, double* out) {
+#if defined(MATHLIB_SIMD_AVX)
+    const __m256d a0 = _mm256_loadu_pd(a + 0);
+    const __m256d a1 = _mm256_loadu_pd(a + 4);
+    const __m256d a2 = _mm256_loadu_pd(a + 8);
+    const __m256d a3 = _mm256_loadu_pd(a + 12);
+    for (int col = 0; col < 4; ++col) {
+        const double* bc = b + col * 4;
+        __m256d r = _mm256_mul_pd(a0, _mm256_broadcast_sd(bc + 0));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a1, _mm256_broadcast_sd(bc + 1)));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a2, _mm256_broadcast_sd(bc + 2)));
+        r = _mm256_add_pd(r, _mm256_mul_pd(a3, _mm256_broadcast_sd(bc + 3)));
+        _mm256_storeu_pd(out + col * 4, r);
+    }
+#elif defined(MATHLIB_SIMD_SSE)
+    // Each column is split into an xy half and a zw half
+    for (int col = 0; col < 4; ++col) {
+        const double* bc = b + col * 4;
+        __m128d lo = _mm_setzero_pd();
+        __m128d hi = _mm_setzero_pd();
+        for (int i = 0; i < 4; ++i) {
+            const __m128d s = _mm_set1_pd(bc[i]);
+            lo = _mm_add_pd(lo, _mm_mul_pd(_mm_loadu_pd(a + i * 4), s));
+            hi = _mm_add_pd(hi, _mm_mul_pd(_mm_loadu_pd(a + i * 4 + 2), s));
+        }
+        _mm_storeu_pd(out + col * 4, lo);
+        _mm_storeu_pd(out + col * 4 + 2, hi);
+    }
+#else
+    scalar::Mat4Mul(a, b, out);
+#endif
+}
+
+// out = m * v for a 4-component column vector. Left scalar on purpose: inlined into
+// a loop over many vectors the compiler vectorizes it across them, which beat the
+// one-vector-at-a-time broadcast kernels in mathbench (0.55x float, 0.76x double).
+inline void Mat4MulVec4(const float* m, const float* v, float* out) {
+    scalar::Mat4MulVec4(m, v, out);
+}
+
+inline void Mat4MulVec4(const double* m, const double* v, double* out) {
+    scalar::Mat4MulVec4(m, v, out);
+}
+
+// out[i] = a * b[i] for count matrices (e.g. viewProj * model[i]); a is loaded once
+void Mat4MulBatch(const float* a, const float* b, float* out, size_t count);
+void Mat4MulBatch(const double* a, const double* b, double* out, size_t count);
+
+// General 4x4 inverse. Returns false (and leaves out untouched) for singular matrices.
+bool Mat4Inverse(const float* m, float* out);
+bool Mat4Inverse(const double* m, double* out);
+
+// "AVX", "SSE2" or "Scalar"
+const char* GetISAName();
+
+} // namespace simd
@@ -0,0 +1,112 @@
+#pragma once
+
+// Structure-of-arrays vector storage: x, y and z each live in their own
+// contiguous array, so bulk operations run SIMD-wide across entities (8 floats
+// or 4 doubles per AVX instruction) instead of one Vector3 at a time.
+// Use these for large homogeneous sets (entity positions, particles, stars);
+// Vector3_f/_d remain the type for individual values.
+//
+// Binary ops process min(Size(), other.Size()) elements. Output batches may
+// alias the input.
+
+#include <cstddef>
+#include <vector>
+#include "mathlib/vector3_f.h"
+#include "mathlib/vector3_d.h"
+#include "mathlib/matrix4x4_f.h"
+#include "mathlib/matrix4x4_d.h"
+
+class Vector3Batch_f {
+public:
+    size_t Size() const { return m_X.size(); }
+    bool Empty() const { return m_X.empty(); }
+
+    void Resize(size_t count) { m_X.resize(count); m_Y.resize(count); m_Z.resize(count); }
+    void Reserve(size_t count) { m_X.reserve(count); m_Y.reserve(count); m_Z.reserve(count); }
+    void Clear() { m_X.clear(); m_Y.clear(); m_Z.clear(); }
+
+    // Returns the index of the new element
+    size_t PushBack(const Vector3_f& v) {
+        m_X.push_back(v.x);
+        m_Y.push_back(v.y);
+        m_Z.push_back(v.z);
+        return m_X.size() - 1;
+    }
+
+    Vector3_f Get(size_t i) const { return Vector3_f(m_X[i], m_Y[i], m_Z[i]); }
+    void Set(size_t i, const Vector3_f& v) { m_X[i] = v.x; m_Y[i] = v.y; m_Z[i] = v.z; }
+
+    // O(1) removal: the last element moves into slot i
+    void EraseSwap(size_t i) {
+        m_X[i] = m_X.back(); m_X.pop_back();
+        m_Y[i] = m_Y.back(); m_Y.pop_back();
+        m_Z[i] = m_Z.back(); m_Z.pop_back();
+    }
+
+    float* X() { return m_X.data(); }
+    float* Y() { return m_Y.data(); }
+    float* Z() { return m_Z.data(); }
+    const float* X() const { return m_X.data(); }
+    const float* Y() const { return m_Y.data(); }
+    const float* Z() const { return m_Z.data(); }
+
+    void Add(const Vector3Batch_f& other);              // this[i] += other[i]
+    void Add(const Vector3_f& offset);                  // this[i] += offset
+    void Scale(float s);                                // this[i] *= s
+    void Normalize();                                   // zero vectors stay zero
+    void Dot(const Vector3Batch_f& other, float* out) const;
+    void Length(float* out) const;
+    void TransformPoints(const Matrix4x4_f& m, Vector3Batch_f& out) const; // w = 1, no divide
+
+private:
+    std::vector<float> m_X, m_Y, m_Z;
+};
+
+class Vector3Batch_d {
+public:
+    size_t Size() const { return m_X.size(); }
+    bool Empty() const { return m_X.empty(); }
+
+    void Resize(size_t count) { m_X.resize(count); m_Y.resize(count); m_Z.resize(count); }
+    void Reserve(size_t count) { m_X.reserve(count); m_Y.reserve(count); m_Z.reserve(count); }
+    void Clear() { m_X.clear(); m_Y.clear(); m_Z.clear(); }
+
+    size_t PushBack(const Vector3_d& v) {
+        m_X.push_back(v.x);
+        m_Y.push_back(v.y);
+        m_Z.push_back(v.z);
+        return m_X.size() - 1;
+    }
+
+    Vector3_d Get(size_t i) const { return Vector3_d(m_X[i], m_Y[i], m_Z[i]); }
+    void Set(size_t i, const Vector3_d& v) { m_X[i] = v.x; m_Y[i] = v.y; m_Z[i] = v.z; }
+
+    void EraseSwap(size_t i) {
+        m_X[i] = m_X.back(); m_X.pop_back();
+        m_Y[i] = m_Y.back(); m_Y.pop_back();
+        m_Z[i] = m_Z.back(); m_Z.pop_back();
+    }
+
+    double* X() { return m_X.data(); }
+    double* Y() { return m_Y.data(); }
+    double* Z() { return m_Z.data(); }
+    const double* X() const { return m_X.data(); }
+    const double* Y() const { return m_Y.data(); }
+    const double* Z() const { return m_Z.data(); }
+
+    void Add(const Vector3Batch_d& other);
+    void Add(const Vector3_d& offset);
+    void Scale(double s);
+    void Normalize();
+    void Dot(const Vector3Batch_d& other, double* out) const;
+    void Length(double* out) const;
+    void TransformPoints(const Matrix4x4_d& m, Vector3Batch_d& out) const;
+
+    // out[i] = float(this[i] - origin) for i in [first, first + count); out must already hold
+    // that range. This is the floating-origin rebase: precise world positions in, render-local
+    // floats out, done in slices so a large rebase can be spread over several frames.
+    void ToLocal(const Vector3_d& origin, Vector3Batch_f& out, size_t first, size_t count) const;
+
+private:
+    std::vector<double> m_X, m_Y, m_Z;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 class Vector3_d {
 public:
     double x, y, z;
@@ -25,19 +27,46 @@ public:
         return *this;
     }
 
-    Vector3_d& operator*=(double f);
-    Vector3_d& operator/=(double f);
-    Vector3_d ProjectOnto(const Vector3_d& other) const;
+    Vector3_d& operator*=(double f) {
+        x *= f; y *= f; z *= f;
+        return *this;
+    }
+
+    Vector3_d& operator/=(double f) {
+        if (f != 0.0) {
+            x /= f; y /= f; z /= f;
+        }
+        return *this;
+    }
 
     double* Base() { return &x; }
     const double* Base() const { return &x; }
-    double Length() const;
-    double LengthSqr() const;
-    double Dot(const Vector3_d& other) const;
-    Vector3_d Cross(const Vector3_d& other) const;
-    Vector3_d Normalize() const;
 
-    bool IsZero(double epsilon = 1e-12) const;
+    double Length() const { return std::sqrt(x * x + y * y + z * z); }
+    double LengthSqr() const { return x * x + y * y + z * z; }
+    double Dot(const Vector3_d& other) const { return x * other.x + y * other.y + z * other.z; }
+
+    Vector3_d Cross(const Vector3_d& other) const {
+        return Vector3_d(
+            y * other.z - z * other.y,
+            z * other.x - x * other.z,
+            x * other.y - y * other.x
+        );
+    }
+
+    Vector3_d Normalize() const {
+        double len = Length();
+        if (len == 0.0) return Vector3_d(0, 0, 0);
+        return Vector3_d(x / len, y / len, z / len);
+    }
+
+    bool IsZero(double epsilon = 1e-12) const { return LengthSqr() < epsilon * epsilon; }
+
+    Vector3_d ProjectOnto(const Vector3_d& other) const {
+        double otherLenSqr = other.LengthSqr();
+        if (otherLenSqr == 0.0) return Vector3_d(0, 0, 0);
+        return other * (Dot(other) / otherLenSqr);
+    }
 };
 
 using Vec3_d = Vector3_d;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 class Vector3_f {
 public:
     float x, y, z;
@@ -30,19 +32,54 @@ public:
         return Vector3_f(-x, -y, -z);
     }
 
-    Vector3_f& operator*=(float f); // physics math used for movement physics
-    Vector3_f& operator/=(float f); // physics math
-    Vector3_f ProjectOnto(const Vector3_f& other) const; // (used for friction, sliding, etc)
+    // physics math used for movement physics
+    Vector3_f& operator*=(float f) {
+        x *= f; y *= f; z *= f;
+        return *this;
+    }
+
+    // physics math
+    Vector3_f& operator/=(float f) {
+        if (f != 0.0f) {
+            x /= f; y /= f; z /= f;
+        }
+        return *this;
+    }
 
     float* Base() { return &x; }
     const float* Base() const { return &x; }
-    float Length() const;
-    float LengthSqr() const;
-    float Dot(const Vector3_f& other) const;
-    Vector3_f Cross(const Vector3_f& other) const;
-    Vector3_f Normalize() const;
-    
-    bool IsZero(float epsilon = 1e-6f) const; // movement physics stuff
+
+    // CAMERA, PLAYER, STUFF
+    float Length() const { return std::sqrt(x * x + y * y + z * z); }
+
+    // MOVEMENT PHYSCIS: for faster length comparisons (avoid sqrt)
+    float LengthSqr() const { return x * x + y * y + z * z; }
+
+    float Dot(const Vector3_f& other) const { return x * other.x + y * other.y + z * other.z; }
+
+    Vector3_f Cross(const Vector3_f& other) const {
+        return Vector3_f(
+            y * other.z - z * other.y,
+            z * other.x - x * other.z,
+            x * other.y - y * other.x
+        );
+    }
+
+    Vector3_f Normalize() const {
+        float len = Length();
+        if (len == 0.0f) return Vector3_f(0, 0, 0);
+        return Vector3_f(x / len, y / len, z / len);
+    }
+
+    // useful for tiny velocity checks and optimization
+    bool IsZero(float epsilon = 1e-6f) const { return LengthSqr() < epsilon * epsilon; }
+
+    // used for friction, sliding, etc
+    Vector3_f ProjectOnto(const Vector3_f& other) const {
+        float otherLenSqr = other.LengthSqr();
+        if (otherLenSqr == 0.0f) return Vector3_f(0, 0, 0);
+        return other * (Dot(other) / otherLenSqr);
+    }
 };
 
 using Vec3_f = Vector3_f; // Alias for float precision vector3
\ No newline at end of file
@@ -3,23 +3,47 @@
 // Interface header: Abstract interface for all rendering backends (OpenGL, Vulkan, DirectX, etc.)
 // This allows the engine to remain backend-agnostic.
 
+#include <cstddef>
+#include <cstdint>
+#include "filesystem/file_view.h"
+#include "shaderapi/render_command.h"
+
 // JSON GEOMETRY STUFF
 class IGPUMesh;
-class Matrix4x4_f;
+struct Matrix4x4_f;
+
+// GPU time of one named pass, resolved a frame or two after it ran.
+// cpuStartNs is the steady-clock time BeginPass was called, to place the pass on a timeline.
+struct GPUPassTiming {
+	const char* name;
+	uint64_t cpuStartNs;
+	uint64_t gpuNs;
+};
+
+// Render state changes of one frame (program, VAO, buffer binds, depth/blend/cull,
+// uniform lookups): issued reached the driver, filtered were already in effect
+struct GPUStateStats {
+	uint32_t issued;
+	uint32_t filtered;
+};
 
 class IGPURenderInterface {
 public:
 	virtual ~IGPURenderInterface() = default;
 	
+	// Sets the viewport and clears, after BeginFrame
 	virtual void PrepareFrame(int width, int height) = 0;
 
+	// Where shader sources are read from (game-relative paths). Call before Init.
+	virtual void SetFileSystem(FSOpenMappedFn openFile) = 0;
+
 	// Initialize renderer with platform-specific window handle
 	virtual bool Init(void* windowHandle, int width, int height) = 0;
 
 	// Shutdown and release resources
 	virtual void Shutdown() = 0;
 
-	// Called at the beginning of each frame (clears, sets viewport, etc.)
+	// Called at the beginning of each frame (uploads, per-frame state; PrepareFrame clears)
 	virtual void BeginFrame() = 0;
 
 	// Called at the end of each frame (swap buffers, flush GPU, etc.)
@@ -33,12 +57,45 @@ public:
 	
 	// Projection matrix (camera lens)
     virtual void SetProjectionMatrix(const Matrix4x4_f& projMatrix) = 0;
+
+	// Seconds since start, for shaders' u_Time. View, projection, time and frame size
+	// reach shaders as one per-frame constant block, not per-draw uniforms.
+	virtual void SetFrameTime(float elapsedTime) = 0;
 	
 	// JSON GEOMETRY Draw a mesh with a transform
 	virtual void DrawMesh(const IGPUMesh& mesh, const Matrix4x4_f& modelMatrix) = 0;
 
+	// Execute commands already sorted by sortKey (see shaderapi/render_command.h).
+	// Pass state is applied when the pass changes and adjacent DrawMesh commands
+	// sharing a mesh go out as one instanced draw. Depth state is left as the last
+	// pass set it.
+	virtual void ExecuteCommands(const RenderCommand* commands, size_t count) = 0;
+
 	// Factory to create backend-specific mesh
 	virtual IGPUMesh* CreateMesh() = 0;
+
+	// Mesh uploads are queued and drained in BeginFrame, stopping at whichever limit
+	// is hit first. At least one mesh goes up per frame, however large. Safe from any
+	// thread; takes effect at the next BeginFrame.
+	virtual void SetUploadBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame) = 0;
+
+	// Uploads everything still queued right away (loading screens, tools). Issues GPU
+	// calls, so only call it on the thread that draws (the engine's Renderer_FlushUploads
+	// hands it to that thread).
+	virtual void FlushUploads() = 0;
+
+	virtual size_t GetPendingUploadCount() const = 0;
+
+	// GPU pass timing. Passes don't nest; name must outlive the result (use literals).
+	virtual void BeginPass(const char* name) = 0;
+	virtual void EndPass() = 0;
+
+	// Passes resolved at the last BeginFrame. Results are never waited for, so they
+	// trail the frame that issued them. The pointer is valid until the next BeginFrame.
+	virtual size_t GetPassTimings(const GPUPassTiming** out) const = 0;
+
+	// State changes of the last completed frame, rolled over at BeginFrame
+	virtual GPUStateStats GetStateStats() const = 0;
 	
 	
 	
@@ -1,12 +1,40 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 
+#include "shaderapi/vertex_layout.h"
+#include "shaderapi/vertex_packing.h"
+
 class IGPUMesh {
 public:
-    virtual void Upload(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) = 0;
+    // Uploads vertex streams laid out as data.layout describes, plus triangle indices.
+    // The data is copied, so the pointers need only live for the call (e.g. straight out
+    // of a mapped file); the GPU upload itself may be deferred to a later frame
+    // (see IGPURenderInterface::SetUploadBudget).
+    virtual void Upload(const GPUMeshData& data) = 0;
+
+    // True once the GPU copy exists; draws of meshes that aren't ready are skipped
+    virtual bool IsReady() const = 0;
     virtual void Bind() const = 0;
     virtual void Unbind() const = 0;
     virtual size_t GetIndexCount() const = 0;
 
+    // xyz positions and 32-bit indices, packed into the default compact layout first
+    void Upload(const float* vertices, size_t vertexFloatCount, const unsigned int* indices, size_t indexCount) {
+        vertexpack::MeshSource src;
+        src.positions = vertices;
+        src.vertexCount = vertexFloatCount / 3;
+        src.indices = indices;
+        src.indexCount = indexCount;
+
+        vertexpack::PackedMesh packed;
+        vertexpack::PackMesh(src, packed);
+        Upload(packed.GetData());
+    }
+
+    void Upload(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+        Upload(vertices.data(), vertices.size(), indices.data(), indices.size());
+    }
+
     virtual ~IGPUMesh() {}
-};
\ No newline at end of file
+};
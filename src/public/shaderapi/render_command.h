@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class IGPUMesh;
+struct Matrix4x4_f;
+
+// Render commands: what the engine wants drawn this frame, as plain data.
+// The engine fills a buffer of them in any order, sorts it by sortKey and hands
+// the sorted stream to IGPURenderInterface::ExecuteCommands, which sets state
+// only where consecutive commands differ.
+//
+// Sort key, most significant bits first:
+//
+//   63..60  pass       RenderPass; fixed render state (depth test/write) per pass
+//   59..52  shader     RenderShader
+//   51..40  material   0 until meshes carry materials
+//   39..16  mesh       per-frame id, equal meshes sort together into instanced runs
+//   15..0   depth      front to back within a mesh (see MakeRenderDepth)
+
+enum class RenderPass : uint8_t {
+    Background,     // Depth test and write off (starfield)
+    Opaque,         // Depth test and write on
+    Count
+};
+
+enum class RenderShader : uint8_t {
+    Starfield,
+    Mesh            // Instanced mesh shader
+};
+
+enum class RenderCommandKind : uint32_t {
+    DrawStarfield,  // param: elapsed time
+    DrawMesh        // mesh + modelMatrix
+};
+
+struct RenderCommand {
+    uint64_t sortKey;
+    const IGPUMesh* mesh;               // DrawMesh
+    const Matrix4x4_f* modelMatrix;     // DrawMesh; must live until ExecuteCommands returns
+    RenderCommandKind kind;
+    float param;
+};
+
+constexpr uint32_t RENDER_KEY_PASS_SHIFT     = 60;
+constexpr uint32_t RENDER_KEY_SHADER_SHIFT   = 52;
+constexpr uint32_t RENDER_KEY_MATERIAL_SHIFT = 40;
+constexpr uint32_t RENDER_KEY_MESH_SHIFT     = 16;
+
+constexpr uint32_t RENDER_KEY_MAX_MATERIAL = (1u << 12) - 1;
+constexpr uint32_t RENDER_KEY_MAX_MESH     = (1u << 24) - 1;
+
+inline uint64_t MakeRenderSortKey(RenderPass pass, RenderShader shader, uint32_t material, uint32_t mesh, uint16_t depth) {
+    return (static_cast<uint64_t>(pass) << RENDER_KEY_PASS_SHIFT) |
+           (static_cast<uint64_t>(shader) << RENDER_KEY_SHADER_SHIFT) |
+           (static_cast<uint64_t>(material & RENDER_KEY_MAX_MATERIAL) << RENDER_KEY_MATERIAL_SHIFT) |
+           (static_cast<uint64_t>(mesh & RENDER_KEY_MAX_MESH) << RENDER_KEY_MESH_SHIFT) |
+           depth;
+}
+
+inline RenderPass GetRenderKeyPass(uint64_t sortKey) {
+    return static_cast<RenderPass>(sortKey >> RENDER_KEY_PASS_SHIFT);
+}
+
+// 16-bit depth key for a view distance: the top half of the float's bits, which
+// order the same way as non-negative floats do (log-like precision, near is finer)
+inline uint16_t MakeRenderDepth(float viewDistance) {
+    if (!(viewDistance > 0.0f))
+        return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &viewDistance, sizeof(bits));
+    return static_cast<uint16_t>(bits >> 16);
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// How a mesh's vertices are laid out in GPU memory (see IGPUMesh::Upload).
+// A layout has up to MAX_VERTEX_STREAMS vertex buffers, each with its own stride.
+// Every element places one semantic in one stream in a fixed or packed format.
+// Packed formats are expanded by the vertex fetch hardware, so shaders still see
+// plain floats. Use vertexpack::PackMesh (shaderapi/vertex_packing.h) to build
+// compact layouts from float data.
+
+constexpr uint32_t MAX_VERTEX_STREAMS = 2;
+constexpr uint32_t MAX_VERTEX_ELEMENTS = 4;
+
+enum class VertexSemantic : uint8_t {
+    Position,
+    Normal,
+    TexCoord,
+    Count
+};
+
+// Shader input location of each semantic. Locations 1-4 belong to the per-instance model matrix.
+constexpr uint32_t VERTEX_SEMANTIC_LOCATIONS[static_cast<size_t>(VertexSemantic::Count)] = { 0, 5, 6 };
+
+enum class VertexFormat : uint8_t {
+    Float2,
+    Float3,
+    Half2,              // IEEE 754 binary16
+    Half4,              // Half positions: xyz plus one pad half, keeping the stride 4-byte aligned
+    UNorm16x2,          // [0, 1] in 16 bits per component, e.g. UVs
+    SNorm10_10_10_2     // xyz in [-1, 1] at 10 bits each, 2 unused bits, e.g. normals
+};
+
+inline uint32_t GetVertexFormatSize(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Float2:          return 8;
+        case VertexFormat::Float3:          return 12;
+        case VertexFormat::Half2:           return 4;
+        case VertexFormat::Half4:           return 8;
+        case VertexFormat::UNorm16x2:       return 4;
+        case VertexFormat::SNorm10_10_10_2: return 4;
+    }
+    return 0;
+}
+
+enum class IndexFormat : uint8_t {
+    UInt16,
+    UInt32
+};
+
+inline uint32_t GetIndexFormatSize(IndexFormat format) {
+    return format == IndexFormat::UInt16 ? 2 : 4;
+}
+
+struct VertexElement {
+    VertexSemantic semantic = VertexSemantic::Position;
+    VertexFormat format = VertexFormat::Float3;
+    uint8_t stream = 0;
+    uint8_t offset = 0;     // Bytes from the start of the vertex within its stream
+};
+
+struct VertexLayout {
+    VertexElement elements[MAX_VERTEX_ELEMENTS];
+    uint32_t elementCount = 0;
+    uint32_t strides[MAX_VERTEX_STREAMS] = {};
+    uint32_t streamCount = 0;
+
+    // Stored positions are relative to a mesh-local frame:
+    // position = positionOrigin + stored * positionScale. Unquantized layouts keep the identity.
+    float positionOrigin[3] = { 0.0f, 0.0f, 0.0f };
+    float positionScale = 1.0f;
+
+    // Appends an element at the end of stream's vertex; false if the layout is full
+    bool Add(VertexSemantic semantic, VertexFormat format, uint32_t stream) {
+        if (elementCount >= MAX_VERTEX_ELEMENTS || stream >= MAX_VERTEX_STREAMS)
+            return false;
+
+        VertexElement& element = elements[elementCount++];
+        element.semantic = semantic;
+        element.format = format;
+        element.stream = static_cast<uint8_t>(stream);
+        element.offset = static_cast<uint8_t>(strides[stream]);
+
+        strides[stream] += GetVertexFormatSize(format);
+        if (stream >= streamCount)
+            streamCount = stream + 1;
+        return true;
+    }
+};
+
+// One mesh upload: the layout plus a pointer to each stream's vertexCount * stride
+// bytes and the index data. Only read during the Upload call.
+struct GPUMeshData {
+    VertexLayout layout;
+    const void* streams[MAX_VERTEX_STREAMS] = {};
+    size_t vertexCount = 0;
+
+    const void* indices = nullptr;
+    size_t indexCount = 0;
+    IndexFormat indexFormat = IndexFormat::UInt32;
+
+    size_t GetStreamBytes(uint32_t stream) const { return vertexCount * layout.strides[stream]; }
+    size_t GetIndexBytes() const { return indexCount * GetIndexFormatSize(indexFormat); }
+};
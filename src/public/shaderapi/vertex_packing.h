@@ -0,0 +1,227 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "shaderapi/vertex_layout.h"
+
+// CPU-side packing of float geometry into the compact vertex formats of
+// shaderapi/vertex_layout.h. PackMesh builds the layout meshes use by default:
+//
+//   stream 0: position   Half4 relative to the bounds centre, scaled into [-1, 1]  (8 bytes)
+//   stream 1: normal     SNorm10_10_10_2                                          (4 bytes)
+//             uv         UNorm16x2, or Half2 when a UV falls outside [0, 1]       (4 bytes)
+//
+// i.e. 16 bytes a vertex instead of 32 for float position/normal/uv, or 8 instead
+// of 12 for position-only meshes. Positions stay in their own stream so
+// position-only passes fetch nothing else. Indices drop to 16 bits whenever the
+// vertex count allows.
+namespace vertexpack {
+
+// IEEE 754 binary16, round to nearest even; out of range values become infinity
+inline uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    bits &= 0x7FFFFFFF;
+
+    if (bits >= 0x7F800000)     // Inf or NaN
+        return sign | 0x7C00 | (bits > 0x7F800000 ? 0x0200 : 0);
+    if (bits >= 0x477FF000)     // Rounds past 65504
+        return sign | 0x7C00;
+
+    uint32_t half, remainder, halfway;
+    if (bits < 0x38800000) {    // Below the smallest normal half: denormal or zero
+        if (bits < 0x33000000)
+            return sign;
+        const uint32_t mantissa = (bits & 0x007FFFFF) | 0x00800000;
+        const uint32_t shift = 126 - (bits >> 23);
+        half = mantissa >> shift;
+        remainder = mantissa & ((1u << shift) - 1);
+        halfway = 1u << (shift - 1);
+    } else {
+        half = (bits - 0x38000000) >> 13;   // Rebias the exponent, drop 13 mantissa bits
+        remainder = bits & 0x1FFF;
+        halfway = 0x1000;
+    }
+
+    if (remainder > halfway || (remainder == halfway && (half & 1)))
+        ++half;     // A carry out of the mantissa correctly bumps the exponent
+    return static_cast<uint16_t>(sign | half);
+}
+
+inline uint16_t PackUNorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+// Matches GL_INT_2_10_10_10_REV, normalized: x in bits 0-9, y 10-19, z 20-29
+inline uint32_t PackSNorm10_10_10_2(float x, float y, float z) {
+    auto pack = [](float v) {
+        const int32_t i = static_cast<int32_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 511.0f));
+        return static_cast<uint32_t>(i) & 0x3FF;
+    };
+    return pack(x) | (pack(y) << 10) | (pack(z) << 20);
+}
+
+inline IndexFormat ChooseIndexFormat(size_t vertexCount) {
+    return vertexCount <= 0x10000 ? IndexFormat::UInt16 : IndexFormat::UInt32;
+}
+
+// Float geometry to pack. Strides are in floats, so interleaved vertices work too.
+struct MeshSource {
+    const float* positions = nullptr;
+    size_t positionStride = 3;
+    const float* normals = nullptr;     // Optional
+    size_t normalStride = 3;
+    const float* uvs = nullptr;         // Optional
+    size_t uvStride = 2;
+    size_t vertexCount = 0;
+
+    const void* indices = nullptr;
+    IndexFormat indexFormat = IndexFormat::UInt32;
+    size_t indexCount = 0;
+
+    bool quantizePositions = true;      // false keeps Float3 positions (very large, very detailed meshes)
+};
+
+// Packed bytes plus their layout; GetData() views them for IGPUMesh::Upload
+struct PackedMesh {
+    VertexLayout layout;
+    std::vector<unsigned char> streams[MAX_VERTEX_STREAMS];
+    size_t vertexCount = 0;
+
+    std::vector<unsigned char> indices;
+    size_t indexCount = 0;
+    IndexFormat indexFormat = IndexFormat::UInt32;
+
+    GPUMeshData GetData() const {
+        GPUMeshData data;
+        data.layout = layout;
+        for (uint32_t s = 0; s < layout.streamCount; ++s)
+            data.streams[s] = streams[s].data();
+        data.vertexCount = vertexCount;
+        data.indices = indices.data();
+        data.indexCount = indexCount;
+        data.indexFormat = indexFormat;
+        return data;
+    }
+};
+
+inline uint32_t ReadIndex(const void* indices, IndexFormat format, size_t i) {
+    if (format == IndexFormat::UInt16) {
+        uint16_t index16;
+        std::memcpy(&index16, static_cast<const unsigned char*>(indices) + i * 2, sizeof(index16));
+        return index16;
+    }
+    uint32_t index;
+    std::memcpy(&index, static_cast<const unsigned char*>(indices) + i * 4, sizeof(index));
+    return index;
+}
+
+inline void PackMesh(const MeshSource& src, PackedMesh& out) {
+    out = PackedMesh();
+    out.vertexCount = src.vertexCount;
+    const size_t n = src.vertexCount;
+
+    // Positions: a mesh-local frame centred on the bounds, so halves spend their precision on the mesh
+    out.layout.Add(VertexSemantic::Position, src.quantizePositions ? VertexFormat::Half4 : VertexFormat::Float3, 0);
+    if (src.quantizePositions && n > 0) {
+        float minP[3], maxP[3];
+        for (int c = 0; c < 3; ++c)
+            minP[c] = maxP[c] = src.positions[c];
+        for (size_t v = 1; v < n; ++v) {
+            for (int c = 0; c < 3; ++c) {
+                minP[c] = std::min(minP[c], src.positions[v * src.positionStride + c]);
+                maxP[c] = std::max(maxP[c], src.positions[v * src.positionStride + c]);
+            }
+        }
+        float extent = 0.0f;
+        for (int c = 0; c < 3; ++c) {
+            out.layout.positionOrigin[c] = 0.5f * (minP[c] + maxP[c]);
+            extent = std::max(extent, 0.5f * (maxP[c] - minP[c]));
+        }
+        out.layout.positionScale = extent > 0.0f ? extent : 1.0f;
+    }
+
+    bool uvsInUnitRange = true;
+    if (src.uvs) {
+        for (size_t v = 0; v < n * src.uvStride && uvsInUnitRange; v += src.uvStride)
+            uvsInUnitRange = src.uvs[v] >= 0.0f && src.uvs[v] <= 1.0f && src.uvs[v + 1] >= 0.0f && src.uvs[v + 1] <= 1.0f;
+    }
+    if (src.normals)
+        out.layout.Add(VertexSemantic::Normal, VertexFormat::SNorm10_10_10_2, 1);
+    if (src.uvs)
+        out.layout.Add(VertexSemantic::TexCoord, uvsInUnitRange ? VertexFormat::UNorm16x2 : VertexFormat::Half2, 1);
+
+    for (uint32_t s = 0; s < out.layout.streamCount; ++s)
+        out.streams[s].resize(n * out.layout.strides[s]);
+
+    const float invScale = 1.0f / out.layout.positionScale;
+    for (uint32_t e = 0; e < out.layout.elementCount; ++e) {
+        const VertexElement& element = out.layout.elements[e];
+        const uint32_t stride = out.layout.strides[element.stream];
+        unsigned char* dst = out.streams[element.stream].data() + element.offset;
+
+        for (size_t v = 0; v < n; ++v, dst += stride) {
+            switch (element.format) {
+                case VertexFormat::Float3:
+                    std::memcpy(dst, src.positions + v * src.positionStride, 3 * sizeof(float));
+                    break;
+                case VertexFormat::Half4: {
+                    const float* p = src.positions + v * src.positionStride;
+                    const uint16_t h[4] = {
+                        FloatToHalf((p[0] - out.layout.positionOrigin[0]) * invScale),
+                        FloatToHalf((p[1] - out.layout.positionOrigin[1]) * invScale),
+                        FloatToHalf((p[2] - out.layout.positionOrigin[2]) * invScale),
+                        0
+                    };
+                    std::memcpy(dst, h, sizeof(h));
+                    break;
+                }
+                case VertexFormat::SNorm10_10_10_2: {
+                    const float* nrm = src.normals + v * src.normalStride;
+                    const uint32_t packed = PackSNorm10_10_10_2(nrm[0], nrm[1], nrm[2]);
+                    std::memcpy(dst, &packed, sizeof(packed));
+                    break;
+                }
+                case VertexFormat::UNorm16x2: {
+                    const float* uv = src.uvs + v * src.uvStride;
+                    const uint16_t u[2] = { PackUNorm16(uv[0]), PackUNorm16(uv[1]) };
+                    std::memcpy(dst, u, sizeof(u));
+                    break;
+                }
+                case VertexFormat::Half2: {
+                    const float* uv = src.uvs + v * src.uvStride;
+                    const uint16_t h[2] = { FloatToHalf(uv[0]), FloatToHalf(uv[1]) };
+                    std::memcpy(dst, h, sizeof(h));
+                    break;
+                }
+                case VertexFormat::Float2:
+                    break;  // Never chosen by PackMesh
+            }
+        }
+    }
+
+    out.indexCount = src.indexCount;
+    out.indexFormat = ChooseIndexFormat(n);
+    out.indices.resize(src.indexCount * GetIndexFormatSize(out.indexFormat));
+    if (out.indexFormat == src.indexFormat) {
+        if (!out.indices.empty())
+            std::memcpy(out.indices.data(), src.indices, out.indices.size());
+    } else {
+        for (size_t i = 0; i < src.indexCount; ++i) {
+            const uint32_t index = ReadIndex(src.indices, src.indexFormat, i);
+            if (out.indexFormat == IndexFormat::UInt16) {
+                const uint16_t index16 = static_cast<uint16_t>(index);
+                std::memcpy(out.indices.data() + i * 2, &index16, sizeof(index16));
+            } else {
+                std::memcpy(out.indices.data() + i * 4, &index, sizeof(index));
+            }
+        }
+    }
+}
+
+} // namespace vertexpack
@@ -0,0 +1,74 @@
+#pragma once
+
+// Compiled map (.imapc) on-disk layout.
+// Produced offline by mapcompiler from maps/<name>.json and read in place by the
+// engine straight out of a memory mapping, so every record is plain old data.
+//
+//   CompiledMapHeader
+//   CompiledMapEntity    entities[entityCount]
+//   CompiledMapGeometry  geometry[geometryCount]
+//   float                vertexPool[vertexFloatCount]   (xyz per vertex, unit-sized primitives)
+//   uint32_t             indexPool[indexCount]
+//   char                 stringTable[stringTableSize]   (NUL-terminated strings)
+//
+// Offsets are in bytes from the start of the file, every section is 4-byte
+// aligned and all values are little-endian.
+//
+// Version 2: geometry is baked as canonical unit primitives (one per type and
+// LOD); each entity carries the scale that restores its authored size.
+// Version 3: entities carry angles and a model path (prop_static).
+
+#include <cstdint>
+
+constexpr uint32_t COMPILED_MAP_MAGIC   = 0x43504D49; // "IMPC"
+constexpr uint32_t COMPILED_MAP_VERSION = 3;
+
+enum class CompiledGeometryType : uint32_t {
+    None   = 0,
+    Cube   = 1,
+    Plane  = 2,
+    Sphere = 3
+};
+
+struct CompiledMapHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;
+
+    uint32_t entityCount;
+    uint32_t entityOffset;
+
+    uint32_t geometryCount;
+    uint32_t geometryOffset;
+
+    uint32_t vertexFloatCount;
+    uint32_t vertexOffset;
+
+    uint32_t indexCount;
+    uint32_t indexOffset;
+
+    uint32_t stringTableSize;
+    uint32_t stringTableOffset;
+};
+
+struct CompiledMapEntity {
+    uint32_t classnameOffset;   // Into the string table
+    float    origin[3];
+    float    scale[3];          // Authored primitive size relative to the unit geometry
+    int32_t  geometryIndex;     // -1 when the entity has no baked geometry
+    uint32_t modelOffset;       // Into the string table, "" when the entity has no model
+    float    angles[3];         // Degrees: pitch, yaw, roll
+};
+
+struct CompiledMapGeometry {
+    uint32_t type;              // CompiledGeometryType
+    float    params[4];         // Unit primitive parameters, sphere: LOD index in [0]
+    uint32_t firstVertexFloat;  // Into the vertex pool
+    uint32_t vertexFloatCount;
+    uint32_t firstIndex;        // Into the index pool
+    uint32_t indexCount;
+};
+
+static_assert(sizeof(CompiledMapHeader) == 13 * 4, "CompiledMapHeader must stay packed");
+static_assert(sizeof(CompiledMapEntity) == 12 * 4, "CompiledMapEntity must stay packed");
+static_assert(sizeof(CompiledMapGeometry) == 9 * 4, "CompiledMapGeometry must stay packed");
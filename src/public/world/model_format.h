@@ -0,0 +1,53 @@
+#pragma once
+
+// Cooked model (.imdlc) on-disk layout.
+// The engine cooks models/<path>.imdl (JSON) into cache/models/<path>.imdlc the
+// first time it loads it, and loads the cooked file in place from then on.
+//
+//   ModelHeader
+//   ModelVertex  vertices[vertexCount]   (interleaved position/normal/uv)
+//   uint16_t or uint32_t indices[indexCount]  (indexSize bytes each, triangle list)
+//   char         material[]              (NUL-terminated)
+//
+// Offsets are in bytes from the start of the file, every section is 4-byte
+// aligned and all values are little-endian. sourceSize and sourceHash identify
+// the .imdl the file was cooked from; a mismatch means it must be cooked again.
+//
+// Version 2: triangles and vertices are stored in optimized order (see
+// geometry::OptimizeMesh).
+
+#include <cstdint>
+
+constexpr uint32_t MODEL_MAGIC   = 0x43444D49; // "IMDC"
+constexpr uint32_t MODEL_VERSION = 2;
+
+struct ModelHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;        // FNV-1a of the .imdl bytes
+    uint32_t sourceSize;
+    uint32_t fileSize;
+
+    uint32_t vertexCount;
+    uint32_t vertexOffset;
+
+    uint32_t indexCount;
+    uint32_t indexSize;         // 2 when every index fits in 16 bits, else 4
+    uint32_t indexOffset;
+
+    uint32_t materialOffset;
+
+    float    boundsMin[3];      // Model space
+    float    boundsMax[3];
+    float    boundsRadius;      // Around the centre of the bounds
+    uint32_t reserved;
+};
+
+struct ModelVertex {
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+static_assert(sizeof(ModelHeader) == 20 * 4, "ModelHeader must stay packed");
+static_assert(sizeof(ModelVertex) == 8 * 4, "ModelVertex must stay packed");
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Handle to an origin-relative entity registered with the engine's
+// FloatingOriginManager. Stable across rebases and removals.
+using OriginHandle = uint32_t;
+constexpr OriginHandle INVALID_ORIGIN_HANDLE = 0xFFFFFFFFu;
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include "world/map_format.h"
+
+// Identifies a canonical unit primitive (see geometry::MakeUnitPrimitive): geometry type plus
+// tessellation. Size and radius are not part of the key, they live in the instance transform.
+// Parameter layout matches CompiledMapGeometry::params so JSON and compiled maps share keys.
+struct PrimitiveMeshKey {
+    CompiledGeometryType type = CompiledGeometryType::None;
+    float params[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // sphere: LOD index, cube/plane: unused
+
+    bool operator==(const PrimitiveMeshKey& other) const {
+        return type == other.type &&
+               params[0] == other.params[0] && params[1] == other.params[1] &&
+               params[2] == other.params[2] && params[3] == other.params[3];
+    }
+};
+
+struct PrimitiveMeshKeyHash {
+    size_t operator()(const PrimitiveMeshKey& key) const;   // Defined with MeshCache
+};
@@ -3,16 +3,55 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include <nlohmann/json.hpp>  // FOR JSON GEOMETRY
 #include "shaderapi/igpu_mesh.h"
 #include "mathlib/vector3_f.h"
 #include "mathlib/matrix4x4_f.h"
+#include "mathlib/vector3_d.h"
+#include "world/origin_handle.h"
+#include "world/primitive_mesh_key.h"
+
+class CompiledMap;
+
+// Group 0 holds the loaded map; streamed sectors use their own groups
+constexpr uint32_t STATIC_GEOMETRY_MAP_GROUP = 0;
 
 struct StaticMeshInstance {
-    std::unique_ptr<IGPUMesh> mesh;
-    Matrix4x4_f transform;
+    std::shared_ptr<IGPUMesh> mesh;     // Shared with every instance of the same primitive (see MeshCache)
+    Matrix4x4_f transform;              // Rotation/scale only; the translation comes from originHandle
+    OriginHandle originHandle = INVALID_ORIGIN_HANDLE; // World position, registered with FloatingOriginManager
+    uint32_t group = STATIC_GEOMETRY_MAP_GROUP;
+};
+
+// CPU-only description of a static_geometry or prop_static entity. Building one
+// touches no GPU or global state, so streaming workers can parse on their own thread.
+struct StaticInstanceDesc {
+    PrimitiveMeshKey key;               // static_geometry only
+    std::string model;                  // prop_static only: path relative to models/ (see ModelCache)
+    Vector3_d position;
+    Vector3_f scale = Vector3_f(1.0f, 1.0f, 1.0f);
+    Vector3_f angles;                   // Degrees: pitch, yaw, roll
 };
 
 void ClearStaticGeometry();
 void LoadStaticGeometryFromMap(const nlohmann::json& mapData);
-const std::vector<StaticMeshInstance>& GetStaticGeometry();
\ No newline at end of file
+void LoadStaticGeometryFromCompiledMap(const CompiledMap& map);
+const std::vector<StaticMeshInstance>& GetStaticGeometry();
+
+bool DescribeStaticGeometry(const nlohmann::json& entity, StaticInstanceDesc& out);
+bool DescribeStaticGeometry(const CompiledMap& map, uint32_t entityIndex, StaticInstanceDesc& out);
+bool DescribeStaticProp(const nlohmann::json& entity, StaticInstanceDesc& out);
+bool DescribeStaticProp(const CompiledMap& map, uint32_t entityIndex, StaticInstanceDesc& out);
+void AddStaticGeometryInstance(const StaticInstanceDesc& desc, std::shared_ptr<IGPUMesh> mesh, uint32_t group);
+
+// Batched form for callers that build instances over several frames: Make registers
+// the instance's origin but leaves it out of the static list, Add publishes a whole
+// batch as one change, and Release drops instances that were never published.
+StaticMeshInstance MakeStaticGeometryInstance(const StaticInstanceDesc& desc, std::shared_ptr<IGPUMesh> mesh, uint32_t group);
+void AddStaticGeometryInstances(std::vector<StaticMeshInstance>&& instances);
+void ReleaseStaticGeometryInstances(std::vector<StaticMeshInstance>& instances);
+void RemoveStaticGeometryGroup(uint32_t group);
+
+// Bumped whenever the static geometry list changes, so cached draw lists know to rebuild
+unsigned int GetStaticGeometryRevision();
\ No newline at end of file
@@ -1,11 +1,12 @@
 #include "renderer/gl_starfield_renderer.h"
+#include "shaderapi/gl_state_cache.h"
 #include <glad/glad.h>
 #include <iostream>
 
 // STARFIELD
 bool GLStarfieldRenderer::LoadStarfieldShaders() {
     m_StarfieldShader = std::make_unique<ShaderProgram>();
-    if (!m_StarfieldShader->CompileFromFile("hl3/shaders/starfield.vert", "hl3/shaders/starfield.frag")) {
+    if (!m_StarfieldShader->CompileFromFile("shaders/starfield.vert", "shaders/starfield.frag")) {
         std::cerr << "[GL] Starfield shader compilation failed\n";
         return false;
     }
@@ -30,9 +31,10 @@ void GLStarfieldRenderer::InitStarfieldGeometry() {
     glGenVertexArrays(1, &m_StarfieldVAO);
     glGenBuffers(1, &m_StarfieldVBO);
 
-    glBindVertexArray(m_StarfieldVAO);
+    GLStateCache& state = GetGLState();
+    state.BindVertexArray(m_StarfieldVAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_StarfieldVBO);
+    state.BindBuffer(GL_ARRAY_BUFFER, m_StarfieldVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0); // position
@@ -41,19 +43,16 @@ void GLStarfieldRenderer::InitStarfieldGeometry() {
     glEnableVertexAttribArray(1); // texCoords
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
 
-    glBindVertexArray(0);
+    state.BindVertexArray(0);
 }
 // STARFIELD
-void GLStarfieldRenderer::RenderStarfield(float elapsedTime) {
+// u_Time comes from the frame constants, which the GL backend updates before calling this
+void GLStarfieldRenderer::RenderStarfield(float /*elapsedTime*/) {
     m_StarfieldShader->Use();
 
-    int timeLocation = glGetUniformLocation(m_StarfieldShader->ID, "u_Time");
-    glUniform1f(timeLocation, elapsedTime);
-
-    glBindVertexArray(m_StarfieldVAO);
+    // Program and VAO stay bound; whoever draws next binds through the state cache
+    GetGLState().BindVertexArray(m_StarfieldVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
-	glUseProgram(0);
 }
 // STARFIELD
 void GLStarfieldRenderer::ReleaseStarfield() {
@@ -67,23 +66,21 @@ void GLStarfieldRenderer::ReleaseStarfield() {
 // STARFIELD
 void GLStarfieldRenderer::CleanupStarfieldGeometry() {
     if (m_StarfieldVBO) {
+        GetGLState().OnBufferDeleted(m_StarfieldVBO);
         glDeleteBuffers(1, &m_StarfieldVBO);
         m_StarfieldVBO = 0;
     }
     if (m_StarfieldVAO) {
+        GetGLState().OnVertexArrayDeleted(m_StarfieldVAO);
         glDeleteVertexArrays(1, &m_StarfieldVAO);
         m_StarfieldVAO = 0;
     }
 }
 // STARFIELD
 void GLStarfieldRenderer::SetDepthTestEnabled(bool enabled) {
-    if (enabled) {
-        glEnable(GL_DEPTH_TEST);
-    } else {
-        glDisable(GL_DEPTH_TEST);
-    }
+    GetGLState().SetDepthTest(enabled);
 }
 // STARFIELD
 void GLStarfieldRenderer::SetDepthMaskEnabled(bool enabled) {
-    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    GetGLState().SetDepthMask(enabled);
 }
\ No newline at end of file
@@ -1,24 +1,28 @@
 // (VertexBuffer)
 
 #include "shaderapi/gl_buffer.h"
+#include "shaderapi/gl_state_cache.h"
 
 VertexBuffer::VertexBuffer(unsigned int target) : Target(target) {
     glGenBuffers(1, &ID);
 }
 
 VertexBuffer::~VertexBuffer() {
-    if (ID) glDeleteBuffers(1, &ID);
+    if (ID) {
+        GetGLState().OnBufferDeleted(ID);
+        glDeleteBuffers(1, &ID);
+    }
 }
 
 void VertexBuffer::Bind() const {
-    glBindBuffer(Target, ID);
+    GetGLState().BindBuffer(Target, ID);
 }
 
 void VertexBuffer::Unbind() const {
-    glBindBuffer(Target, 0);
+    GetGLState().BindBuffer(Target, 0);
 }
 
 void VertexBuffer::SetData(const void* data, size_t size) const {
-    glBindBuffer(Target, ID);
+    GetGLState().BindBuffer(Target, ID);
     glBufferData(Target, size, data, GL_STATIC_DRAW);
 }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include "mathlib/matrix4x4_f.h"
+
+// Per-frame constants, one std140 uniform block shared by every shader that
+// declares it (binding point FRAME_CONSTANTS_BINDING, assigned at link time by
+// ShaderProgram). Must match this declaration, member for member:
+//
+//   layout(std140) uniform FrameConstants {
+//       mat4  u_View;
+//       mat4  u_Projection;
+//       mat4  u_ViewProjection;
+//       vec4  u_CameraPosition;    // xyz: camera in render space, w: 1
+//       float u_Time;              // Seconds since start
+//       vec2  u_Resolution;        // Framebuffer size in pixels
+//   };
+//
+// The shadow pass is meant to bind the same block filled from the light's view,
+// so shaders never need to know which camera they are drawn from.
+constexpr unsigned int FRAME_CONSTANTS_BINDING = 0;
+constexpr const char* FRAME_CONSTANTS_BLOCK = "FrameConstants";
+
+struct GLFrameConstants {
+    Matrix4x4_f view;
+    Matrix4x4_f projection;
+    Matrix4x4_f viewProjection;
+    float cameraPosition[4];
+    float time;
+    float padding;              // std140 aligns vec2 to 8 bytes
+    float resolution[2];
+};
+
+static_assert(offsetof(GLFrameConstants, cameraPosition) == 192, "FrameConstants std140 layout");
+static_assert(offsetof(GLFrameConstants, time) == 208, "FrameConstants std140 layout");
+static_assert(offsetof(GLFrameConstants, resolution) == 216, "FrameConstants std140 layout");
+static_assert(sizeof(GLFrameConstants) == 224, "FrameConstants std140 block size");
@@ -0,0 +1,96 @@
+#include "shaderapi/gl_gpu_timer.h"
+
+#include <chrono>
+#include <iostream>
+
+static uint64_t SteadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void GLGPUTimer::Init() {
+    m_Enabled = GLAD_GL_VERSION_3_3 != 0;
+    if (!m_Enabled)
+        std::cout << "[GL] Timer queries unavailable, GPU pass timing disabled\n";
+}
+
+void GLGPUTimer::Shutdown() {
+    if (m_PassOpen) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_PassOpen = false;
+    }
+
+    for (FrameQueries& frame : m_Frames) {
+        if (!frame.pool.empty())
+            glDeleteQueries(static_cast<GLsizei>(frame.pool.size()), frame.pool.data());
+        frame.pool.clear();
+        frame.passes.clear();
+    }
+    m_Results.clear();
+    m_Enabled = false;
+}
+
+void GLGPUTimer::BeginFrame() {
+    if (!m_Enabled)
+        return;
+
+    if (m_PassOpen)
+        EndPass(); // Last frame forgot to close its pass
+
+    m_Frame = (m_Frame + 1) % FRAMES;
+    FrameQueries& frame = m_Frames[m_Frame];
+
+    m_Results.clear();
+    for (const PassQuery& pass : frame.passes) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(pass.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            ++m_Dropped;
+            continue;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(pass.query, GL_QUERY_RESULT, &elapsed);
+        m_Results.push_back({ pass.name, pass.cpuStartNs, static_cast<uint64_t>(elapsed) });
+    }
+    frame.passes.clear();
+
+    if (m_Dropped >= 100) {
+        std::cout << "[GL] Dropped " << m_Dropped << " GPU pass timings (results not ready after "
+                  << FRAMES << " frames)\n";
+        m_Dropped = 0;
+    }
+}
+
+void GLGPUTimer::BeginPass(const char* name) {
+    if (!m_Enabled)
+        return;
+
+    if (m_PassOpen)
+        EndPass();
+
+    FrameQueries& frame = m_Frames[m_Frame];
+    if (frame.passes.size() == frame.pool.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        frame.pool.push_back(query);
+    }
+
+    const GLuint query = frame.pool[frame.passes.size()];
+    frame.passes.push_back({ name, query, SteadyNowNs() });
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_PassOpen = true;
+}
+
+void GLGPUTimer::EndPass() {
+    if (!m_PassOpen)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_PassOpen = false;
+}
+
+size_t GLGPUTimer::GetResults(const GPUPassTiming** out) const {
+    *out = m_Results.data();
+    return m_Results.size();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+
+#include "shaderapi/gpu_render_interface.h"
+
+// GL_TIME_ELAPSED pass timing. Queries are double-buffered by frame: the set
+// issued two frames ago is read back at BeginFrame, and only if the driver says
+// it's available, so timing never stalls the pipeline. A result that still
+// isn't ready by then is dropped rather than waited for.
+//
+// Elapsed-time queries can't overlap, so passes don't nest; beginning a pass
+// while another is open closes the open one first.
+class GLGPUTimer {
+public:
+    void Init();        // Disabled on contexts without timer queries (GL < 3.3)
+    void Shutdown();
+
+    void BeginFrame();  // Resolves the oldest frame's queries
+    void BeginPass(const char* name);
+    void EndPass();
+
+    // Passes resolved by the last BeginFrame
+    size_t GetResults(const GPUPassTiming** out) const;
+
+private:
+    static constexpr unsigned int FRAMES = 2;
+
+    struct PassQuery {
+        const char* name;
+        GLuint query;
+        uint64_t cpuStartNs;
+    };
+
+    struct FrameQueries {
+        std::vector<PassQuery> passes;
+        std::vector<GLuint> pool;       // Query objects owned by this frame slot, reused
+    };
+
+    bool m_Enabled = false;
+    FrameQueries m_Frames[FRAMES];
+    unsigned int m_Frame = 0;
+    bool m_PassOpen = false;
+    std::vector<GPUPassTiming> m_Results;
+    uint32_t m_Dropped = 0;
+};
@@ -1,39 +1,103 @@
 #include "shaderapi/gl_mesh.h"  			// GLMesh class declaration
 #include <glad/glad.h>           			// For GL constants
 #include <memory>                			// For unique_ptr, if needed
+#include "shaderapi/gl_upload_queue.h"
+#include "shaderapi/gl_state_cache.h"
 
 
-GLMesh::GLMesh() {
-    m_VAO = std::make_unique<VertexArray>();
-    m_VBO = std::make_unique<VertexBuffer>(GL_ARRAY_BUFFER);         	// Vertex buffer
-    m_EBO = std::make_unique<VertexBuffer>(GL_ELEMENT_ARRAY_BUFFER); 	// Index buffer
+GLMesh::GLMesh(GLUploadQueue* uploadQueue) : m_UploadQueue(uploadQueue) {
 }
 
 GLMesh::~GLMesh() {
-    // Unique pointers auto-cleanup
+    if (!m_UploadQueue || !m_Uploaded)
+        return; // Synchronous (or never uploaded): unique pointers auto-cleanup
+
+    // Drop a queued upload, or wait for one the render thread is running, so the
+    // buffers below are final; then let the render thread delete them
+    m_UploadQueue->Cancel(this);
+
+    GLRetiredBuffers retired;
+    retired.vao = std::move(m_VAO);
+    for (uint32_t s = 0; s < MAX_VERTEX_STREAMS; ++s)
+        retired.vbos[s] = std::move(m_VBOs[s]);
+    retired.ebo = std::move(m_EBO);
+    if (retired.vao)
+        m_UploadQueue->Retire(std::move(retired));
 }
 
-void GLMesh::Upload(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
+void GLMesh::Upload(const GPUMeshData& data) {
     if (m_Uploaded)
         return; // Already uploaded once, don't do it again
 
-    m_IndexCount = indices.size();
+    m_IndexCount = data.indexCount;
+    m_Uploaded = true;
+
+    if (m_UploadQueue) {
+        m_UploadQueue->Enqueue(this, data);
+        return;
+    }
+
+    CreateBuffers(data);
+    m_Ready = true;
+}
+
+// GL size/type/normalization for each packed format. Half4 feeds only xyz; the packed
+// 10:10:10:2 type must be read as 4 components, the shader simply ignores w.
+static void GetAttributeFormat(VertexFormat format, GLint& size, GLenum& type, bool& normalized) {
+    normalized = false;
+    switch (format) {
+        case VertexFormat::Float2:          size = 2; type = GL_FLOAT; break;
+        case VertexFormat::Float3:          size = 3; type = GL_FLOAT; break;
+        case VertexFormat::Half2:           size = 2; type = GL_HALF_FLOAT; break;
+        case VertexFormat::Half4:           size = 3; type = GL_HALF_FLOAT; break;
+        case VertexFormat::UNorm16x2:       size = 2; type = GL_UNSIGNED_SHORT; normalized = true; break;
+        case VertexFormat::SNorm10_10_10_2: size = 4; type = GL_INT_2_10_10_10_REV; normalized = true; break;
+        default:                            size = 3; type = GL_FLOAT; break;
+    }
+}
+
+void GLMesh::CreateBuffers(const GPUMeshData& data) {
+    const VertexLayout& layout = data.layout;
+
+    m_VAO = std::make_unique<VertexArray>();
+    m_EBO = std::make_unique<VertexBuffer>(GL_ELEMENT_ARRAY_BUFFER); 	// Index buffer
 
     m_VAO->Bind();
 
-    m_VBO->Bind();
-    m_VBO->SetData(vertices.data(), vertices.size() * sizeof(float));
+    for (uint32_t s = 0; s < layout.streamCount; ++s) {
+        m_VBOs[s] = std::make_unique<VertexBuffer>(GL_ARRAY_BUFFER);
+        m_VBOs[s]->Bind();
+        m_VBOs[s]->SetData(data.streams[s], data.GetStreamBytes(s));
+
+        for (uint32_t e = 0; e < layout.elementCount; ++e) {
+            const VertexElement& element = layout.elements[e];
+            if (element.stream != s)
+                continue;
+
+            GLint size;
+            GLenum type;
+            bool normalized;
+            GetAttributeFormat(element.format, size, type, normalized);
+            m_VAO->AddVertexAttribute(VERTEX_SEMANTIC_LOCATIONS[static_cast<size_t>(element.semantic)], size, type,
+                                      normalized, layout.strides[s], (const void*)(size_t)element.offset);
+        }
+    }
 
     m_EBO->Bind();
-    m_EBO->SetData(indices.data(), indices.size() * sizeof(unsigned int));
+    m_EBO->SetData(data.indices, data.GetIndexBytes());
+    m_IndexType = data.indexFormat == IndexFormat::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
 
-    m_VAO->AddVertexAttribute(0, 3, GL_FLOAT, false, 3 * sizeof(float), (void*)0);
+    for (int c = 0; c < 3; ++c)
+        m_PositionDecode[c] = layout.positionOrigin[c];
+    m_PositionDecode[3] = layout.positionScale;
 
     m_VAO->Unbind();
-    m_VBO->Unbind();
+    GetGLState().BindBuffer(GL_ARRAY_BUFFER, 0);
     m_EBO->Unbind();
+}
 
-    m_Uploaded = true; // uploaded for performance
+bool GLMesh::IsReady() const {
+    return m_Ready;
 }
 
 void GLMesh::Bind() const {
@@ -44,6 +108,18 @@ void GLMesh::Unbind() const {
     m_VAO->Unbind();
 }
 
+void GLMesh::BindInstanceStream(GLuint instanceVBO, size_t byteOffset) const {
+    constexpr size_t matrixStride = 16 * sizeof(float);
+
+    GetGLState().BindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    for (unsigned int col = 0; col < 4; ++col) {
+        unsigned int location = GL_INSTANCE_MATRIX_LOCATION + col;
+        m_VAO->AddVertexAttribute(location, 4, GL_FLOAT, false, matrixStride,
+                                  (const void*)(byteOffset + col * 4 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
 size_t GLMesh::GetIndexCount() const {
     return m_IndexCount;
 }
\ No newline at end of file
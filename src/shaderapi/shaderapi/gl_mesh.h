@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <glad/glad.h>
@@ -8,24 +9,57 @@
 #include "shaderapi/gl_vertex_array.h"
 #include "shaderapi/gl_buffer.h"
 
+class GLUploadQueue;
+
+// Per-instance model matrix occupies attribute locations 1-4 (one per column);
+// vertex attributes use VERTEX_SEMANTIC_LOCATIONS around it
+constexpr unsigned int GL_INSTANCE_MATRIX_LOCATION = 1;
+
+// GL objects are created when the upload actually runs, not at construction, so
+// meshes can be created, filled and destroyed from any thread: with an upload
+// queue, destruction hands the GL objects back to the queue for deletion on the
+// render thread, and only the queue's drain touches GL.
 class GLMesh : public IGPUMesh {
 public:
-    GLMesh();
+    explicit GLMesh(GLUploadQueue* uploadQueue = nullptr);    // No queue: Upload() is synchronous
     ~GLMesh() override;
 
-    void Upload(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) override;
+    using IGPUMesh::Upload;
+    void Upload(const GPUMeshData& data) override;
+    bool IsReady() const override;
     void Bind() const override;
     void Unbind() const override;
     size_t GetIndexCount() const override;
 
-    GLMesh(GLMesh&&) = default;
-    GLMesh& operator=(GLMesh&&) = default;
+    // Points the instance matrix attributes at byteOffset inside instanceVBO (VAO must be bound)
+    void BindInstanceStream(GLuint instanceVBO, size_t byteOffset) const;
+
+    // Render thread, called by the upload queue: creates the VAO, one VBO per stream, the EBO
+    // and the attribute layout. Null stream/index pointers only allocate; the caller fills them.
+    void CreateBuffers(const GPUMeshData& data);
+    void SetReady() { m_Ready = true; }
+    GLuint GetVertexBufferID(uint32_t stream) const { return m_VBOs[stream] ? m_VBOs[stream]->ID : 0; }
+    GLuint GetIndexBufferID() const { return m_EBO ? m_EBO->ID : 0; }
+
+    GLenum GetIndexType() const { return m_IndexType; }
+
+    // (origin.xyz, scale) for the shaders' u_PositionDecode, undoing position quantization
+    const float* GetPositionDecode() const { return m_PositionDecode; }
+
+    // The upload queue keeps a pointer to the mesh until its upload has run
+    GLMesh(const GLMesh&) = delete;
+    GLMesh& operator=(const GLMesh&) = delete;
 
 private:
+    GLUploadQueue* m_UploadQueue = nullptr;
+
     std::unique_ptr<VertexArray> m_VAO;
-    std::unique_ptr<VertexBuffer> m_VBO;
+    std::unique_ptr<VertexBuffer> m_VBOs[MAX_VERTEX_STREAMS];
     std::unique_ptr<VertexBuffer> m_EBO;
 
     size_t m_IndexCount = 0;
-    bool m_Uploaded = false; // Flag to avoid redundant uploads
-};
\ No newline at end of file
+    GLenum m_IndexType = GL_UNSIGNED_INT;
+    float m_PositionDecode[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    bool m_Uploaded = false; // Upload() accepted (possibly still queued); ignore repeats
+    std::atomic<bool> m_Ready{ false };    // GPU buffers filled, safe to draw
+};
@@ -1,45 +1,48 @@
 #include "shaderapi/gl_shader_program.h"
+#include "shaderapi/gl_state_cache.h"
+#include "shaderapi/gl_frame_constants.h"
 #include <glad/glad.h>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 
-bool ShaderProgram::CompileFromFile(const char* vertexPath, const char* fragmentPath) {
-    std::ifstream vFile(vertexPath);
-    std::ifstream fFile(fragmentPath);
+static FSOpenMappedFn s_OpenFile = nullptr;
 
-    if (!vFile || !fFile) {
-        std::cerr << "[Shader] Failed to open shader files\n";
+void ShaderProgram::SetFileSource(FSOpenMappedFn openFile) {
+    s_OpenFile = openFile;
+}
+
+bool ShaderProgram::CompileFromFile(const char* vertexPath, const char* fragmentPath) {
+    if (!s_OpenFile) {
+        std::cerr << "[Shader] No file source set, can't load " << vertexPath << "\n";
         return false;
     }
 
-    std::stringstream vStream, fStream;
-    vStream << vFile.rdbuf();
-    fStream << fFile.rdbuf();
+    FSFileViewPtr vFile = s_OpenFile(vertexPath);
+    FSFileViewPtr fFile = s_OpenFile(fragmentPath);
 
-    std::string vSource = vStream.str();
-    std::string fSource = fStream.str();
+    if (!vFile || !fFile) {
+        std::cerr << "[Shader] Failed to open shader files: " << vertexPath << ", " << fragmentPath << "\n";
+        return false;
+    }
 
-    bool success = Compile(vSource.c_str(), fSource.c_str());
+    bool success = Compile(reinterpret_cast<const char*>(vFile->data), reinterpret_cast<const char*>(fFile->data),
+                           static_cast<int>(vFile->size), static_cast<int>(fFile->size));
 
-    m_MVPLocation = glGetUniformLocation(ID, "u_MVP");
-    if (m_MVPLocation == -1) {
-        std::cerr << "Warning: u_MVP uniform not found\n";
-    }
+    // Per-object transform; -1 for shaders without one (instanced, fullscreen)
+    m_ModelLocation = success ? GetGLState().GetUniformLocation(ID, "u_Model") : -1;
 
     return success;
 }
 
 
 
-bool ShaderProgram::Compile(const char* vertexSrc, const char* fragmentSrc) {
+bool ShaderProgram::Compile(const char* vertexSrc, const char* fragmentSrc, int vertexLength, int fragmentLength) {
     unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSrc, nullptr);
+    glShaderSource(vertexShader, 1, &vertexSrc, &vertexLength);
     glCompileShader(vertexShader);
     if (!CheckCompileErrors(vertexShader, "VERTEX")) return false;
 
     unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSrc, nullptr);
+    glShaderSource(fragmentShader, 1, &fragmentSrc, &fragmentLength);
     glCompileShader(fragmentShader);
     if (!CheckCompileErrors(fragmentShader, "FRAGMENT")) {
         glDeleteShader(vertexShader);
@@ -58,15 +61,22 @@ bool ShaderProgram::Compile(const char* vertexSrc, const char* fragmentSrc) {
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+
+    // GLSL 330 can't pick a block binding itself; every program reading the frame
+    // constants gets the same binding point
+    const GLuint frameBlock = glGetUniformBlockIndex(ID, FRAME_CONSTANTS_BLOCK);
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameBlock, FRAME_CONSTANTS_BINDING);
     return true;
 }
 
 void ShaderProgram::Use() const {
-    glUseProgram(ID);
+    GetGLState().UseProgram(ID);
 }
 
 void ShaderProgram::Delete() {
     if (ID) {
+        GetGLState().OnProgramDeleted(ID);
         glDeleteProgram(ID);
         ID = 0;
     }
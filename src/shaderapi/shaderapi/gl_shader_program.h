@@ -1,19 +1,24 @@
 #pragma once
+#include "filesystem/file_view.h"
 
 class ShaderProgram {
 public:
     unsigned int ID = 0;
 
-    bool Compile(const char* vertexSrc, const char* fragmentSrc);
+    // Lengths < 0 mean the source is NUL-terminated
+    bool Compile(const char* vertexSrc, const char* fragmentSrc, int vertexLength = -1, int fragmentLength = -1);
+
+    // Paths are game-relative and read through the file source, straight from the mapped bytes
     bool CompileFromFile(const char* vertexPath, const char* fragmentPath);
+    static void SetFileSource(FSOpenMappedFn openFile);
 	
     void Use() const;
     void Delete();
 	
-    int GetMVPLocation() const { return m_MVPLocation; }
+    int GetModelLocation() const { return m_ModelLocation; }
 	
 private:
-    int m_MVPLocation = -1;
+    int m_ModelLocation = -1;
 
     bool CheckCompileErrors(unsigned int shader, const char* type);
     bool CheckLinkErrors(unsigned int program);
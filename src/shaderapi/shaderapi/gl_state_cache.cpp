@@ -0,0 +1,174 @@
+#include "shaderapi/gl_state_cache.h"
+
+static GLStateCache s_GLState;
+
+GLStateCache& GetGLState() {
+    return s_GLState;
+}
+
+void GLStateCache::Reset() {
+    m_Program = UNKNOWN;
+    m_VertexArray = UNKNOWN;
+    for (GLuint& buffer : m_Buffers)
+        buffer = UNKNOWN;
+    for (GLuint& buffer : m_UniformBindings)
+        buffer = UNKNOWN;
+    m_DepthTest = Toggle::Unknown;
+    m_DepthMask = Toggle::Unknown;
+    m_Blend = Toggle::Unknown;
+    m_CullFace = Toggle::Unknown;
+    m_BlendSrc = UNKNOWN;
+    m_BlendDst = UNKNOWN;
+    m_UniformLocations.clear();
+    m_Frame = {};
+    m_LastFrame = {};
+}
+
+void GLStateCache::BeginFrame() {
+    m_LastFrame = m_Frame;
+    m_Frame = {};
+}
+
+// Counts the call either way; true means skip it
+bool GLStateCache::Filter(bool redundant) {
+    if (redundant)
+        ++m_Frame.filtered;
+    else
+        ++m_Frame.issued;
+    return redundant;
+}
+
+void GLStateCache::UseProgram(GLuint program) {
+    if (Filter(m_Program == program))
+        return;
+    m_Program = program;
+    glUseProgram(program);
+}
+
+void GLStateCache::BindVertexArray(GLuint vao) {
+    if (Filter(m_VertexArray == vao))
+        return;
+    m_VertexArray = vao;
+    m_Buffers[ELEMENT_BUFFER_SLOT] = UNKNOWN;
+    glBindVertexArray(vao);
+}
+
+int GLStateCache::GetBufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:           return ARRAY_BUFFER_SLOT;
+        case GL_ELEMENT_ARRAY_BUFFER:   return ELEMENT_BUFFER_SLOT;
+        case GL_COPY_READ_BUFFER:       return COPY_READ_SLOT;
+        case GL_COPY_WRITE_BUFFER:      return COPY_WRITE_SLOT;
+        case GL_UNIFORM_BUFFER:         return UNIFORM_BUFFER_SLOT;
+        default:                        return -1;
+    }
+}
+
+void GLStateCache::BindBuffer(GLenum target, GLuint buffer) {
+    const int slot = GetBufferSlot(target);
+    if (slot < 0) {
+        Filter(false);  // Not shadowed, always goes through
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Filter(m_Buffers[slot] == buffer))
+        return;
+    m_Buffers[slot] = buffer;
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::BindUniformBufferBase(GLuint index, GLuint buffer) {
+    if (index >= UNIFORM_BINDING_COUNT) {
+        Filter(false);
+        m_Buffers[UNIFORM_BUFFER_SLOT] = buffer;
+        glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+        return;
+    }
+    if (Filter(m_UniformBindings[index] == buffer))
+        return;
+    m_UniformBindings[index] = buffer;
+    m_Buffers[UNIFORM_BUFFER_SLOT] = buffer;
+    glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+}
+
+void GLStateCache::SetCapability(GLenum capability, Toggle& shadow, bool enabled) {
+    const Toggle wanted = enabled ? Toggle::On : Toggle::Off;
+    if (Filter(shadow == wanted))
+        return;
+    shadow = wanted;
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+    SetCapability(GL_DEPTH_TEST, m_DepthTest, enabled);
+}
+
+void GLStateCache::SetBlend(bool enabled) {
+    SetCapability(GL_BLEND, m_Blend, enabled);
+}
+
+void GLStateCache::SetCullFace(bool enabled) {
+    SetCapability(GL_CULL_FACE, m_CullFace, enabled);
+}
+
+void GLStateCache::SetDepthMask(bool enabled) {
+    const Toggle wanted = enabled ? Toggle::On : Toggle::Off;
+    if (Filter(m_DepthMask == wanted))
+        return;
+    m_DepthMask = wanted;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::SetBlendFunc(GLenum srcFactor, GLenum dstFactor) {
+    if (Filter(m_BlendSrc == srcFactor && m_BlendDst == dstFactor))
+        return;
+    m_BlendSrc = srcFactor;
+    m_BlendDst = dstFactor;
+    glBlendFunc(srcFactor, dstFactor);
+}
+
+// Programs have a handful of uniforms, so a linear scan by pointer beats hashing the name
+GLint GLStateCache::GetUniformLocation(GLuint program, const char* name) {
+    std::vector<UniformLocation>& locations = m_UniformLocations[program];
+    for (const UniformLocation& entry : locations) {
+        if (entry.name == name) {
+            Filter(true);
+            return entry.location;
+        }
+    }
+
+    Filter(false);
+    const GLint location = glGetUniformLocation(program, name);
+    locations.push_back({ name, location });
+    return location;
+}
+
+// Deleting the current program only flags it until it's unbound; treat it as unknown
+void GLStateCache::OnProgramDeleted(GLuint program) {
+    if (m_Program == program)
+        m_Program = UNKNOWN;
+    m_UniformLocations.erase(program);
+}
+
+// GL unbinds a deleted VAO or buffer from the context, and the name can be handed out again
+void GLStateCache::OnVertexArrayDeleted(GLuint vao) {
+    if (m_VertexArray == vao) {
+        m_VertexArray = 0;
+        m_Buffers[ELEMENT_BUFFER_SLOT] = UNKNOWN;
+    }
+}
+
+void GLStateCache::OnBufferDeleted(GLuint buffer) {
+    for (GLuint& bound : m_Buffers) {
+        if (bound == buffer)
+            bound = 0;
+    }
+    // Whether indexed bindings are dropped too varies by GL version; don't guess
+    for (GLuint& bound : m_UniformBindings) {
+        if (bound == buffer)
+            bound = UNKNOWN;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+
+#include "shaderapi/gpu_render_interface.h"
+
+// Shadow copy of the GL state this module changes: the program, VAO, buffer
+// bindings, depth/blend/cull state and every program's uniform locations. Calls
+// that would set what is already set are dropped before they reach the driver.
+//
+// The shadow is only right if nothing changes that state behind its back, so
+// every bind/enable in shaderapi goes through here (ShaderProgram::Use,
+// VertexArray/VertexBuffer::Bind, ...), and GL object wrappers report deletions,
+// which make GL fall back to binding 0.
+//
+// One context, one cache: only call it on the thread the context is current on.
+class GLStateCache {
+public:
+    // Forget everything; the next call of each kind goes to the driver. Call whenever
+    // the context is created or destroyed.
+    void Reset();
+
+    // Moves this frame's counts to GetLastFrameStats()
+    void BeginFrame();
+    const GPUStateStats& GetLastFrameStats() const { return m_LastFrame; }
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    void BindBuffer(GLenum target, GLuint buffer);
+    void BindUniformBufferBase(GLuint index, GLuint buffer);   // Also binds GL_UNIFORM_BUFFER, as GL does
+
+    void SetDepthTest(bool enabled);
+    void SetDepthMask(bool enabled);
+    void SetBlend(bool enabled);
+    void SetBlendFunc(GLenum srcFactor, GLenum dstFactor);
+    void SetCullFace(bool enabled);
+
+    // Looked up once per program and name. The name's pointer is its identity, so
+    // pass string literals.
+    GLint GetUniformLocation(GLuint program, const char* name);
+
+    void OnProgramDeleted(GLuint program);
+    void OnVertexArrayDeleted(GLuint vao);
+    void OnBufferDeleted(GLuint buffer);
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u;
+    static constexpr GLuint UNIFORM_BINDING_COUNT = 8;     // Indexed uniform bindings shadowed
+
+    enum BufferSlot {
+        ARRAY_BUFFER_SLOT,
+        ELEMENT_BUFFER_SLOT,    // Belongs to the bound VAO, unknown after every VAO change
+        COPY_READ_SLOT,
+        COPY_WRITE_SLOT,
+        UNIFORM_BUFFER_SLOT,
+        BUFFER_SLOT_COUNT
+    };
+
+    enum class Toggle : int8_t { Unknown = -1, Off = 0, On = 1 };
+
+    struct UniformLocation {
+        const char* name;
+        GLint location;
+    };
+
+    static int GetBufferSlot(GLenum target);
+    bool Filter(bool redundant);
+    void SetCapability(GLenum capability, Toggle& shadow, bool enabled);
+
+    GLuint m_Program = UNKNOWN;
+    GLuint m_VertexArray = UNKNOWN;
+    GLuint m_Buffers[BUFFER_SLOT_COUNT] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+    GLuint m_UniformBindings[UNIFORM_BINDING_COUNT] = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN,
+                                                        UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+    Toggle m_DepthTest = Toggle::Unknown;
+    Toggle m_DepthMask = Toggle::Unknown;
+    Toggle m_Blend = Toggle::Unknown;
+    Toggle m_CullFace = Toggle::Unknown;
+    GLenum m_BlendSrc = UNKNOWN;
+    GLenum m_BlendDst = UNKNOWN;
+
+    std::unordered_map<GLuint, std::vector<UniformLocation>> m_UniformLocations;
+
+    GPUStateStats m_Frame = {};
+    GPUStateStats m_LastFrame = {};
+};
+
+// The GL context's state cache (render thread)
+GLStateCache& GetGLState();
@@ -0,0 +1,248 @@
+#include "shaderapi/gl_upload_queue.h"
+#include "shaderapi/gl_mesh.h"
+#include "shaderapi/gl_state_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// Copy offsets inside the staging segment stay aligned for the driver's DMA path
+static constexpr size_t STAGING_ALIGNMENT = 256;
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+GLUploadQueue::~GLUploadQueue() {
+    Shutdown();
+}
+
+void GLUploadQueue::Init() {
+    if (!GLAD_GL_VERSION_4_4) {
+        std::cout << "[GL] Mesh uploads: glBufferData (no GL 4.4 buffer storage)\n";
+        return;
+    }
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(STAGING_SEGMENTS * STAGING_SEGMENT_BYTES);
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_StagingBuffer);
+    GetGLState().BindBuffer(GL_COPY_READ_BUFFER, m_StagingBuffer);
+    glBufferStorage(GL_COPY_READ_BUFFER, size, nullptr, flags);
+    m_StagingPtr = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, size, flags));
+    GetGLState().BindBuffer(GL_COPY_READ_BUFFER, 0);
+
+    if (!m_StagingPtr) {
+        std::cerr << "[GL] Failed to map upload staging buffer, falling back to glBufferData\n";
+        GetGLState().OnBufferDeleted(m_StagingBuffer);
+        glDeleteBuffers(1, &m_StagingBuffer);
+        m_StagingBuffer = 0;
+        return;
+    }
+
+    std::cout << "[GL] Mesh uploads: persistent-mapped staging, "
+              << STAGING_SEGMENTS << " x " << (STAGING_SEGMENT_BYTES >> 20) << " MB\n";
+}
+
+void GLUploadQueue::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Pending.clear();
+    }
+    DeleteRetired();
+
+    for (GLsync& fence : m_SegmentFences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_StagingBuffer) {
+        GetGLState().BindBuffer(GL_COPY_READ_BUFFER, m_StagingBuffer);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        GetGLState().BindBuffer(GL_COPY_READ_BUFFER, 0);
+        GetGLState().OnBufferDeleted(m_StagingBuffer);
+        glDeleteBuffers(1, &m_StagingBuffer);
+        m_StagingBuffer = 0;
+    }
+    m_StagingPtr = nullptr;
+    m_Segment = 0;
+    m_SegmentOffset = 0;
+}
+
+void GLUploadQueue::Enqueue(GLMesh* mesh, const GPUMeshData& data) {
+    PendingUpload upload;
+    upload.mesh = mesh;
+    upload.desc = data;
+
+    for (uint32_t s = 0; s < data.layout.streamCount; ++s) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data.streams[s]);
+        upload.streams[s].assign(bytes, bytes + data.GetStreamBytes(s));
+        upload.desc.streams[s] = nullptr;
+    }
+
+    const unsigned char* indexBytes = static_cast<const unsigned char*>(data.indices);
+    upload.indices.assign(indexBytes, indexBytes + data.GetIndexBytes());
+    upload.desc.indices = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pending.push_back(std::move(upload));
+}
+
+void GLUploadQueue::Cancel(GLMesh* mesh) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(),
+        [mesh](const PendingUpload& u) { return u.mesh == mesh; }), m_Pending.end());
+    m_UploadDone.wait(lock, [this, mesh] { return m_Uploading != mesh; });
+}
+
+void GLUploadQueue::Retire(GLRetiredBuffers&& buffers) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Retired.push_back(std::move(buffers));
+}
+
+void GLUploadQueue::DeleteRetired() {
+    std::vector<GLRetiredBuffers> retired;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Retired.empty())
+            return;
+        retired.swap(m_Retired);
+    }
+    retired.clear();    // glDelete* through the wrappers' destructors
+}
+
+void GLUploadQueue::SetBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_BudgetBytes = maxBytesPerFrame;
+    m_BudgetMs = maxMillisecondsPerFrame;
+}
+
+size_t GLUploadQueue::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Pending.size();
+}
+
+void GLUploadQueue::Process() {
+    size_t budgetBytes;
+    double budgetMs;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        budgetBytes = m_BudgetBytes;
+        budgetMs = m_BudgetMs;
+    }
+
+    DeleteRetired();
+    Drain(budgetBytes, budgetMs);
+}
+
+void GLUploadQueue::Flush() {
+    DeleteRetired();
+    Drain(std::numeric_limits<size_t>::max(), std::numeric_limits<double>::infinity());
+}
+
+void GLUploadQueue::Drain(size_t maxBytes, double maxMilliseconds) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    size_t bytes = 0;
+    bool stagingOpen = false;
+
+    for (;;) {
+        PendingUpload upload;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Pending.empty())
+                break;
+            const size_t next = m_Pending.front().GetByteSize();
+            if (bytes > 0 && (next > maxBytes || bytes > maxBytes - next))
+                break;
+            upload = std::move(m_Pending.front());
+            m_Pending.pop_front();
+            m_Uploading = upload.mesh;
+        }
+
+        if (m_StagingPtr && !stagingOpen) {
+            BeginStagingSegment();
+            stagingOpen = true;
+        }
+
+        Upload(upload);
+        bytes += upload.GetByteSize();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Uploading = nullptr;
+        }
+        m_UploadDone.notify_all();
+
+        if (std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= maxMilliseconds)
+            break;
+    }
+
+    if (stagingOpen)
+        EndStagingSegment();
+}
+
+void GLUploadQueue::Upload(PendingUpload& upload) {
+    if (!m_StagingPtr || !UploadStaged(upload))
+        upload.mesh->CreateBuffers(upload.GetData());
+    upload.mesh->SetReady();
+}
+
+bool GLUploadQueue::UploadStaged(PendingUpload& upload) {
+    const uint32_t streamCount = upload.desc.layout.streamCount;
+
+    // Every stream, then the indices, each at an aligned offset in this frame's segment
+    size_t streamOffsets[MAX_VERTEX_STREAMS];
+    size_t end = m_SegmentOffset;
+    for (uint32_t s = 0; s < streamCount; ++s) {
+        streamOffsets[s] = end;
+        end = AlignUp(end + upload.streams[s].size(), STAGING_ALIGNMENT);
+    }
+    const size_t indexOffset = end;
+    end = AlignUp(indexOffset + upload.indices.size(), STAGING_ALIGNMENT);
+    if (end > STAGING_SEGMENT_BYTES)
+        return false;
+
+    unsigned char* segment = m_StagingPtr + m_Segment * STAGING_SEGMENT_BYTES;
+    for (uint32_t s = 0; s < streamCount; ++s)
+        std::memcpy(segment + streamOffsets[s], upload.streams[s].data(), upload.streams[s].size());
+    std::memcpy(segment + indexOffset, upload.indices.data(), upload.indices.size());
+    m_SegmentOffset = end;
+
+    // Allocate the mesh's buffers empty, then let the GPU pull from the staging ring
+    upload.mesh->CreateBuffers(upload.desc);
+
+    const GLintptr base = static_cast<GLintptr>(m_Segment * STAGING_SEGMENT_BYTES);
+    GLStateCache& state = GetGLState();
+    state.BindBuffer(GL_COPY_READ_BUFFER, m_StagingBuffer);
+    for (uint32_t s = 0; s < streamCount; ++s) {
+        state.BindBuffer(GL_COPY_WRITE_BUFFER, upload.mesh->GetVertexBufferID(s));
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, base + streamOffsets[s], 0, upload.streams[s].size());
+    }
+    state.BindBuffer(GL_COPY_WRITE_BUFFER, upload.mesh->GetIndexBufferID());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, base + indexOffset, 0, upload.indices.size());
+    return true;    // Copy bindings stay as they are; only uploads use those targets
+}
+
+// The segment was last written STAGING_SEGMENTS frames ago; normally its fence
+// has long signaled and this costs one query
+void GLUploadQueue::BeginStagingSegment() {
+    GLsync& fence = m_SegmentFences[m_Segment];
+    if (fence) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    m_SegmentOffset = 0;
+}
+
+void GLUploadQueue::EndStagingSegment() {
+    if (m_SegmentOffset > 0) {
+        m_SegmentFences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_Segment = (m_Segment + 1) % STAGING_SEGMENTS;
+    }
+    m_SegmentOffset = 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <glad/glad.h>
+
+#include "shaderapi/vertex_layout.h"
+#include "shaderapi/gl_vertex_array.h"
+#include "shaderapi/gl_buffer.h"
+
+class GLMesh;
+
+// GL objects of a destroyed mesh, waiting for the render thread to delete them
+struct GLRetiredBuffers {
+    std::unique_ptr<VertexArray> vao;
+    std::unique_ptr<VertexBuffer> vbos[MAX_VERTEX_STREAMS];
+    std::unique_ptr<VertexBuffer> ebo;
+};
+
+// Deferred mesh uploads. Enqueue() only copies the CPU geometry, so it may be
+// called from any thread; the render thread drains the queue in Process() once
+// per frame, stopping at the byte or time budget (but always uploading at least
+// one mesh, so oversized meshes still make progress).
+//
+// On GL 4.4+ the data goes through a persistently mapped staging ring split into
+// one segment per frame in flight: a memcpy into mapped memory plus a GPU-side
+// glCopyBufferSubData, with a fence guarding each segment's reuse. Older contexts,
+// and meshes that don't fit what's left of the segment, use plain glBufferData.
+//
+// Meshes may also be destroyed on any thread: Cancel() waits out an upload of
+// that mesh already in progress, and Retire() parks its GL objects until the
+// next Process()/Flush()/Shutdown() deletes them where the context is current.
+class GLUploadQueue {
+public:
+    GLUploadQueue() = default;
+    ~GLUploadQueue();
+    GLUploadQueue(const GLUploadQueue&) = delete;
+    GLUploadQueue& operator=(const GLUploadQueue&) = delete;
+
+    void Init();        // Render thread, after GL functions are loaded
+    void Shutdown();    // Render thread; drops anything still queued
+
+    void Enqueue(GLMesh* mesh, const GPUMeshData& data);
+    void Cancel(GLMesh* mesh);  // Mesh being destroyed; returns once no upload of it is queued or running
+    void Retire(GLRetiredBuffers&& buffers);
+
+    void Process();     // One frame's worth of uploads
+    void Flush();       // Everything, now
+
+    void SetBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame);    // Any thread; next Process() on
+    size_t GetPendingCount() const;
+    bool IsUsingStaging() const { return m_StagingPtr != nullptr; }
+
+private:
+    struct PendingUpload {
+        GLMesh* mesh = nullptr;
+        GPUMeshData desc;       // Layout, counts and formats; the bytes live in the vectors below
+        std::vector<unsigned char> streams[MAX_VERTEX_STREAMS];
+        std::vector<unsigned char> indices;
+
+        GPUMeshData GetData() const {
+            GPUMeshData data = desc;
+            for (uint32_t s = 0; s < data.layout.streamCount; ++s)
+                data.streams[s] = streams[s].data();
+            data.indices = indices.data();
+            return data;
+        }
+
+        size_t GetByteSize() const {
+            size_t bytes = indices.size();
+            for (const auto& stream : streams)
+                bytes += stream.size();
+            return bytes;
+        }
+    };
+
+    static constexpr unsigned int STAGING_SEGMENTS = 3;
+    static constexpr size_t STAGING_SEGMENT_BYTES = 4 * 1024 * 1024;
+
+    void Drain(size_t maxBytes, double maxMilliseconds);
+    void DeleteRetired();
+    void Upload(PendingUpload& upload);
+    bool UploadStaged(PendingUpload& upload);
+    void BeginStagingSegment();
+    void EndStagingSegment();
+
+    mutable std::mutex m_Mutex;
+    std::deque<PendingUpload> m_Pending;
+    const GLMesh* m_Uploading = nullptr;    // Popped by Drain(), buffers being created
+    std::condition_variable m_UploadDone;
+    std::vector<GLRetiredBuffers> m_Retired;
+
+    size_t m_BudgetBytes = STAGING_SEGMENT_BYTES;   // Guarded by m_Mutex
+    double m_BudgetMs = 2.0;
+
+    // Persistent-mapped staging ring (GL 4.4+)
+    GLuint m_StagingBuffer = 0;
+    unsigned char* m_StagingPtr = nullptr;
+    GLsync m_SegmentFences[STAGING_SEGMENTS] = {};
+    unsigned int m_Segment = 0;
+    size_t m_SegmentOffset = 0;
+};
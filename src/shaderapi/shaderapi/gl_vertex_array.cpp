@@ -1,6 +1,7 @@
 // VertexArray
 
 #include "shaderapi/gl_vertex_array.h"
+#include "shaderapi/gl_state_cache.h"
 #include <glad/glad.h>
 
 // Constructor: generate VAO
@@ -10,17 +11,20 @@ VertexArray::VertexArray() {
 
 // Destructor: delete VAO
 VertexArray::~VertexArray() {
-    if (ID) glDeleteVertexArrays(1, &ID);
+    if (ID) {
+        GetGLState().OnVertexArrayDeleted(ID);
+        glDeleteVertexArrays(1, &ID);
+    }
 }
 
 // Bind VAO
 void VertexArray::Bind() const {
-    glBindVertexArray(ID);
+    GetGLState().BindVertexArray(ID);
 }
 
 // Unbind VAO
 void VertexArray::Unbind() const {
-    glBindVertexArray(0);
+    GetGLState().BindVertexArray(0);
 }
 
 void VertexArray::AddVertexAttribute(unsigned int index, int size, unsigned int type, bool normalized, size_t stride, const void* pointer) const {
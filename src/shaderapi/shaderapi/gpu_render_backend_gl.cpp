@@ -3,6 +3,8 @@
 #include "shaderapi/gl_buffer.h"
 #include "shaderapi/gl_vertex_array.h"
 #include "shaderapi/gl_mesh.h"
+#include "shaderapi/gl_state_cache.h"
+#include "shaderapi/gl_frame_constants.h"
 #include "shaderapi/igpu_mesh.h"
 
 #include <glad/glad.h>
@@ -11,7 +13,27 @@
 
 // CreateMesh
 IGPUMesh* GPURenderBackendGL::CreateMesh() {
-    return new GLMesh();
+    return new GLMesh(&m_UploadQueue);
+}
+
+void GPURenderBackendGL::SetUploadBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame) {
+    m_UploadQueue.SetBudget(maxBytesPerFrame, maxMillisecondsPerFrame);
+}
+
+void GPURenderBackendGL::FlushUploads() {
+    m_UploadQueue.Flush();
+}
+
+size_t GPURenderBackendGL::GetPendingUploadCount() const {
+    return m_UploadQueue.GetPendingCount();
+}
+
+GPUStateStats GPURenderBackendGL::GetStateStats() const {
+    return GetGLState().GetLastFrameStats();
+}
+
+void GPURenderBackendGL::SetFileSystem(FSOpenMappedFn openFile) {
+    ShaderProgram::SetFileSource(openFile);
 }
 
 // Init: create GL context, load glad, compile shaders
@@ -73,28 +95,52 @@ bool GPURenderBackendGL::Init(void* windowHandle, int /*width*/, int /*height*/)
     glGetIntegerv(GL_MINOR_VERSION, &minor);
     std::cout << "[GL] Running OpenGL version " << major << "." << minor << "\n";
 
+    GLStateCache& state = GetGLState();
+    state.Reset(); // Fresh context, nothing known yet
+
+    m_UploadQueue.Init();
+    m_GPUTimer.Init();
+
     SDL_GL_SetSwapInterval(0); // Disable vsync for benchmarking Defaukt: (1)
 
 	// Disable face culling to check if it's the cause of invisible spheres
-    glDisable(GL_CULL_FACE); // FOR DEBUG MESH N SHIT, REMOVE LATER..
+    state.SetCullFace(false); // FOR DEBUG MESH N SHIT, REMOVE LATER..
 
 	// Compile and upload main shader
     m_Shader = std::make_unique<ShaderProgram>();
-    if (!m_Shader->CompileFromFile("hl3/shaders/cube.vert", "hl3/shaders/cube.frag")) {
+    if (!m_Shader->CompileFromFile("shaders/cube.vert", "shaders/cube.frag")) {
         std::cerr << "[GL] Shader compilation failed\n";
         return false;
     }
 
     m_ShaderProgram = m_Shader->ID;
-    m_MVPLocation = glGetUniformLocation(m_ShaderProgram, "u_MVP");
+    m_ModelLocation = m_Shader->GetModelLocation();
+    m_PositionDecodeLocation = state.GetUniformLocation(m_ShaderProgram, "u_PositionDecode");
+
+    // Instanced variant: same fragment stage, model matrix comes from the instance stream
+    m_InstancedShader = std::make_unique<ShaderProgram>();
+    if (!m_InstancedShader->CompileFromFile("shaders/cube_instanced.vert", "shaders/cube.frag")) {
+        std::cerr << "[GL] Instanced shader compilation failed\n";
+        return false;
+    }
+    m_InstancedPositionDecodeLocation = state.GetUniformLocation(m_InstancedShader->ID, "u_PositionDecode");
+
+    glGenBuffers(1, &m_InstanceVBO);
+    m_InstanceVBOCapacity = 0;
+
+    // Per-frame constants: filled when something changed, before the next draw
+    glGenBuffers(1, &m_FrameUBO);
+    state.BindBuffer(GL_UNIFORM_BUFFER, m_FrameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GLFrameConstants), nullptr, GL_DYNAMIC_DRAW);
 
-    glEnable(GL_DEPTH_TEST);
+    state.SetDepthTest(true);
 
-	// Initial MVP state
-    m_MVPDirty = true;
+	// Initial frame constants
+    m_FrameConstantsDirty = true;
     m_ViewMatrix = Matrix4x4_f::Identity();
     m_ProjectionMatrix = Matrix4x4_f::Identity();
     m_ViewProjectionMatrix = Matrix4x4_f::Identity();
+    m_Time = 0.0f;
 	
     // --- STARFIELD STARTS HERE ---
 	m_GLStarfieldRenderer = std::make_unique<GLStarfieldRenderer>();
@@ -106,10 +152,31 @@ bool GPURenderBackendGL::Init(void* windowHandle, int /*width*/, int /*height*/)
 }
 
 void GPURenderBackendGL::Shutdown() {
+    m_UploadQueue.Shutdown();
+    m_GPUTimer.Shutdown();
+
     if (m_Shader) {
         m_Shader->Delete();
         m_Shader.reset();
     }
+
+    if (m_InstancedShader) {
+        m_InstancedShader->Delete();
+        m_InstancedShader.reset();
+    }
+
+    if (m_InstanceVBO) {
+        GetGLState().OnBufferDeleted(m_InstanceVBO);
+        glDeleteBuffers(1, &m_InstanceVBO);
+        m_InstanceVBO = 0;
+        m_InstanceVBOCapacity = 0;
+    }
+
+    if (m_FrameUBO) {
+        GetGLState().OnBufferDeleted(m_FrameUBO);
+        glDeleteBuffers(1, &m_FrameUBO);
+        m_FrameUBO = 0;
+    }
 	
 	if (m_GLStarfieldRenderer) {
 		m_GLStarfieldRenderer->ReleaseStarfield();
@@ -120,28 +187,36 @@ void GPURenderBackendGL::Shutdown() {
         SDL_GL_DeleteContext(m_GLContext);
         m_GLContext = nullptr;
     }
+    GetGLState().Reset();
+    m_PositionDecodeMesh = nullptr;
     m_Window = nullptr;
 }
 
+// Clearing is left to PrepareFrame, with the size the frame was built for
 void GPURenderBackendGL::BeginFrame() {
-    int w, h;
-    SDL_GetWindowSize(m_Window, &w, &h);
-    PrepareFrame(w, h);
+    GLStateCache& state = GetGLState();
+    state.BeginFrame();
+    m_PositionDecodeMesh = nullptr; // A mesh freed last frame may come back at the same address
+
+    m_GPUTimer.BeginFrame();
+    m_UploadQueue.Process(); // This frame's share of queued mesh uploads
 
-    UpdateViewProjectionMatrixIfNeeded();
+    // Frame constants bound once per frame, for every shader that reads them
+    state.BindUniformBufferBase(FRAME_CONSTANTS_BINDING, m_FrameUBO);
 
     m_Shader->Use(); // Bind shader once per frame
-	UpdateMVP(Matrix4x4_f::Identity()); // Upload clean MVP for cases with no model (like skybox)
+	SetModelMatrix(Matrix4x4_f::Identity()); // Clean model for cases without one (like skybox)
 }
 
 void GPURenderBackendGL::PrepareFrame(int width, int height) {
     glViewport(0, 0, width, height);
+    GetGLState().SetDepthMask(true); // glClear honours the depth write mask the last pass left
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     float aspect = static_cast<float>(width) / static_cast<float>(height);
     SetProjectionMatrix(Matrix4x4_f::Perspective(30.0f, aspect, 0.1f, 100.0f));
-	UpdateViewProjectionMatrixIfNeeded();
+    SetResolution(width, height);
 }
 
 void GPURenderBackendGL::EndFrame() {
@@ -153,43 +228,174 @@ void GPURenderBackendGL::OnResize(int width, int height) {
 
     float aspect = static_cast<float>(width) / static_cast<float>(height);
     SetProjectionMatrix(Matrix4x4_f::Perspective(30.0f, aspect, 0.1f, 100.0f));
-	UpdateViewProjectionMatrixIfNeeded();
+    SetResolution(width, height);
 }
 
-// MVP
+// FRAME CONSTANTS: setters only mark the block dirty; it goes up once, before the next draw
 void GPURenderBackendGL::SetViewMatrix(const Matrix4x4_f& viewMatrix) {
     m_ViewMatrix = viewMatrix;
-    m_MVPDirty = true;
+    m_FrameConstantsDirty = true;
 }
 
 void GPURenderBackendGL::SetProjectionMatrix(const Matrix4x4_f& projMatrix) {
     m_ProjectionMatrix = projMatrix;
-    m_MVPDirty = true;
+    m_FrameConstantsDirty = true;
+}
+
+void GPURenderBackendGL::SetFrameTime(float elapsedTime) {
+    if (elapsedTime == m_Time)
+        return;
+    m_Time = elapsedTime;
+    m_FrameConstantsDirty = true;
+}
+
+void GPURenderBackendGL::SetResolution(int width, int height) {
+    if (width == m_Width && height == m_Height)
+        return;
+    m_Width = width;
+    m_Height = height;
+    m_FrameConstantsDirty = true;
+}
+
+void GPURenderBackendGL::RenderStarfield(float elapsedTime) {
+    SetFrameTime(elapsedTime);
+    UpdateFrameConstantsIfNeeded();
+    m_GLStarfieldRenderer->RenderStarfield(elapsedTime);
 }
 
 // MESH
 void GPURenderBackendGL::DrawMesh(const IGPUMesh& mesh, const Matrix4x4_f& modelMatrix) {
-    m_Shader->Use();  // Ensure mesh shader is active
-    UpdateMVP(modelMatrix); // Upload MVP
-
-    if (&mesh != m_LastBoundMesh) {
-        mesh.Bind();
-        m_LastBoundMesh = &mesh;
+    if (!mesh.IsReady())
+        return; // Upload still queued
+
+    UpdateFrameConstantsIfNeeded();
+    m_Shader->Use();  // Ensure mesh shader is active (filtered when it already is)
+    SetModelMatrix(modelMatrix);
+
+    // Every mesh in this backend is a GLMesh created by CreateMesh()
+    const GLMesh& glMesh = static_cast<const GLMesh&>(mesh);
+    glMesh.Bind();
+    if (&mesh != m_PositionDecodeMesh) {
+        glUniform4fv(m_PositionDecodeLocation, 1, glMesh.GetPositionDecode());
+        m_PositionDecodeMesh = &mesh;
     }
 
-    glDrawElements(GL_TRIANGLES, mesh.GetIndexCount(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(GL_TRIANGLES, (GLsizei)glMesh.GetIndexCount(), glMesh.GetIndexType(), nullptr);
 }
 
-// PRIVATE HELPER: Recalculate the combined ViewProjection matrix if dirty
-void GPURenderBackendGL::UpdateViewProjectionMatrixIfNeeded() {
-    if (m_MVPDirty) {
-        m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
-        m_MVPDirty = false;
+// COMMAND STREAM: sorted by key, so state only changes between runs. All mesh matrices
+// share one instance-buffer upload; the view-projection multiply happens in the vertex
+// shader, so CPU cost per instance is a copy.
+void GPURenderBackendGL::ExecuteCommands(const RenderCommand* commands, size_t count) {
+    if (count == 0)
+        return;
+
+    UpdateFrameConstantsIfNeeded();
+
+    m_InstanceScratch.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (commands[i].kind == RenderCommandKind::DrawMesh)
+            m_InstanceScratch.push_back(*commands[i].modelMatrix);
     }
+    if (!m_InstanceScratch.empty())
+        UploadInstanceMatrices();
+
+    RenderPass pass = RenderPass::Count;
+    size_t instance = 0;
+    size_t i = 0;
+    while (i < count) {
+        const RenderCommand& command = commands[i];
+        const RenderPass commandPass = GetRenderKeyPass(command.sortKey);
+        if (commandPass != pass) {
+            ApplyPassState(commandPass);
+            pass = commandPass;
+        }
+
+        if (command.kind == RenderCommandKind::DrawStarfield) {
+            RenderStarfield(command.param);
+            ++i;
+            continue;
+        }
+
+        size_t runEnd = i + 1;
+        while (runEnd < count && commands[runEnd].kind == RenderCommandKind::DrawMesh &&
+               commands[runEnd].mesh == command.mesh && GetRenderKeyPass(commands[runEnd].sortKey) == pass)
+            ++runEnd;
+
+        m_InstancedShader->Use(); // Only reaches GL after a starfield command
+        DrawInstancedRun(*command.mesh, instance, runEnd - i);
+        instance += runEnd - i;
+        i = runEnd;
+    }
+}
+
+// Fixed render state of each RenderPass
+void GPURenderBackendGL::ApplyPassState(RenderPass pass) {
+    const bool depth = pass != RenderPass::Background;
+    GLStateCache& state = GetGLState();
+    state.SetDepthTest(depth);
+    state.SetDepthMask(depth);
+}
+
+// Copies m_InstanceScratch into the instance VBO
+void GPURenderBackendGL::UploadInstanceMatrices() {
+    const size_t count = m_InstanceScratch.size();
+    GetGLState().BindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    if (count > m_InstanceVBOCapacity)
+        m_InstanceVBOCapacity = count + count / 2; // Grow with headroom
+
+    // Orphan last frame's storage so the driver never stalls on draws still in flight
+    glBufferData(GL_ARRAY_BUFFER, m_InstanceVBOCapacity * sizeof(Matrix4x4_f), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(Matrix4x4_f), m_InstanceScratch.data());
+}
+
+// Expects the instanced shader bound and the instance VBO filled
+void GPURenderBackendGL::DrawInstancedRun(const IGPUMesh& mesh, size_t firstInstance, size_t instanceCount) {
+    // Every mesh in this backend is a GLMesh created by CreateMesh()
+    const GLMesh& glMesh = static_cast<const GLMesh&>(mesh);
+    if (!glMesh.IsReady())
+        return; // Upload still queued; its instance slots just go unused
+
+    glMesh.Bind();
+    glMesh.BindInstanceStream(m_InstanceVBO, firstInstance * sizeof(Matrix4x4_f));
+    glUniform4fv(m_InstancedPositionDecodeLocation, 1, glMesh.GetPositionDecode());
+
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)glMesh.GetIndexCount(), glMesh.GetIndexType(),
+                            nullptr, (GLsizei)instanceCount);
+}
+
+// PRIVATE HELPER: Rebuild and upload the frame constants if anything changed since the last draw.
+// glBufferData orphans the old storage, so draws still reading it never stall the update.
+void GPURenderBackendGL::UpdateFrameConstantsIfNeeded() {
+    if (!m_FrameConstantsDirty)
+        return;
+
+    m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+
+    GLFrameConstants constants;
+    constants.view = m_ViewMatrix;
+    constants.projection = m_ProjectionMatrix;
+    constants.viewProjection = m_ViewProjectionMatrix;
+
+    // Camera position is the inverse view's translation (the origin when drawing camera-relative)
+    Matrix4x4_f cameraToWorld = Matrix4x4_f::Identity();
+    Invert(m_ViewMatrix, cameraToWorld);
+    constants.cameraPosition[0] = cameraToWorld[3][0];
+    constants.cameraPosition[1] = cameraToWorld[3][1];
+    constants.cameraPosition[2] = cameraToWorld[3][2];
+    constants.cameraPosition[3] = 1.0f;
+
+    constants.time = m_Time;
+    constants.padding = 0.0f;
+    constants.resolution[0] = static_cast<float>(m_Width);
+    constants.resolution[1] = static_cast<float>(m_Height);
+
+    GetGLState().BindBuffer(GL_UNIFORM_BUFFER, m_FrameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(constants), &constants, GL_DYNAMIC_DRAW);
+    m_FrameConstantsDirty = false;
 }
 
-// CENTRALIZED MVP
-void GPURenderBackendGL::UpdateMVP(const Matrix4x4_f& modelMatrix) {
-    Matrix4x4_f mvp = m_ViewProjectionMatrix * modelMatrix;
-    glUniformMatrix4fv(m_MVPLocation, 1, GL_FALSE, &mvp[0][0]);
+// Per-object data is just the model matrix; view and projection live in the frame constants
+void GPURenderBackendGL::SetModelMatrix(const Matrix4x4_f& modelMatrix) {
+    glUniformMatrix4fv(m_ModelLocation, 1, GL_FALSE, &modelMatrix[0][0]);
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "shaderapi/gpu_render_interface.h"
 #include "shaderapi/gl_shader_program.h"
 #include "shaderapi/igpu_mesh.h"
+#include "shaderapi/gl_upload_queue.h"
+#include "shaderapi/gl_gpu_timer.h"
 #include "renderer/istarfieldrenderer.h"
 #include "renderer/gl_starfield_renderer.h"
 #include "mathlib/matrix4x4_f.h"
@@ -10,6 +12,7 @@
 #include <SDL2/SDL.h>
 #include <glad/glad.h>
 #include <memory>
+#include <vector>
 
 // Forward declarations
 class ShaderProgram;
@@ -23,22 +26,34 @@ public:
     void EndFrame() override;
     void OnResize(int width, int height) override;
     void PrepareFrame(int width, int height) override;
+    void SetFileSystem(FSOpenMappedFn openFile) override;
 
     void SetViewMatrix(const Matrix4x4_f& viewMatrix) override;
     void SetProjectionMatrix(const Matrix4x4_f& projMatrix) override;
+    void SetFrameTime(float elapsedTime) override;
 
     void DrawMesh(const IGPUMesh& mesh, const Matrix4x4_f& modelMatrix) override;
+    void ExecuteCommands(const RenderCommand* commands, size_t count) override;
 	
 	// GEOMETRY
 	IGPUMesh* CreateMesh() override;
+	void SetUploadBudget(size_t maxBytesPerFrame, double maxMillisecondsPerFrame) override;
+	void FlushUploads() override;
+	size_t GetPendingUploadCount() const override;
+
+	// GPU PASS TIMING
+	void BeginPass(const char* name) override { m_GPUTimer.BeginPass(name); }
+	void EndPass() override { m_GPUTimer.EndPass(); }
+	size_t GetPassTimings(const GPUPassTiming** out) const override { return m_GPUTimer.GetResults(out); }
+
+	// Counted by the GL state cache (see gl_state_cache.h)
+	GPUStateStats GetStateStats() const override;
 	
 	// STARFIELD
     bool LoadStarfieldShaders() override {
         return m_GLStarfieldRenderer->LoadStarfieldShaders();
     }
-    void RenderStarfield(float elapsedTime) override {
-        m_GLStarfieldRenderer->RenderStarfield(elapsedTime);
-    }
+    void RenderStarfield(float elapsedTime) override;  // Sets the frame time, then draws
     void ReleaseStarfield() override {
         m_GLStarfieldRenderer->ReleaseStarfield();
     }
@@ -50,24 +65,47 @@ public:
     }
 	
 private:
-	const IGPUMesh* m_LastBoundMesh = nullptr; // PERFORMANCE
+	// Mesh whose position decode m_Shader's u_PositionDecode holds; cleared every frame
+	const IGPUMesh* m_PositionDecodeMesh = nullptr;
     SDL_Window* m_Window = nullptr;
     SDL_GLContext m_GLContext = nullptr;
 
+    // Outlives every GLMesh it hands out; meshes cancel their pending upload on destruction
+    GLUploadQueue m_UploadQueue;
+
+    GLGPUTimer m_GPUTimer;
+
     std::unique_ptr<ShaderProgram> m_Shader;
 
+    // INSTANCING: shader reading the model matrix from a per-instance stream
+    std::unique_ptr<ShaderProgram> m_InstancedShader;
+    int m_InstancedPositionDecodeLocation = -1;
+    GLuint m_InstanceVBO = 0;
+    size_t m_InstanceVBOCapacity = 0;             // In matrices
+    std::vector<Matrix4x4_f> m_InstanceScratch;   // Reused every frame, never shrinks
+
     GLuint m_ShaderProgram = 0;
-    GLint m_TransformUBO = 0;
-    GLuint m_UBOHandle = 0;
-    int m_MVPLocation = -1;
+    int m_ModelLocation = -1;
+    int m_PositionDecodeLocation = -1;     // Per mesh: undoes quantized positions (see VertexLayout)
 
-	void UpdateViewProjectionMatrixIfNeeded();
-	void UpdateMVP(const Matrix4x4_f& modelMatrix);
+	void UpdateFrameConstantsIfNeeded();
+	void SetModelMatrix(const Matrix4x4_f& modelMatrix);
+	void SetResolution(int width, int height);
+
+	void ApplyPassState(RenderPass pass);
+	void UploadInstanceMatrices();
+	void DrawInstancedRun(const IGPUMesh& mesh, size_t firstInstance, size_t instanceCount);
 
     Matrix4x4_f m_ViewMatrix;
     Matrix4x4_f m_ProjectionMatrix;
     Matrix4x4_f m_ViewProjectionMatrix;
-    bool m_MVPDirty = true;
+
+    // Per-frame constants (see gl_frame_constants.h), uploaded lazily before the next draw
+    GLuint m_FrameUBO = 0;
+    float m_Time = 0.0f;
+    int m_Width = 0;
+    int m_Height = 0;
+    bool m_FrameConstantsDirty = true;
 	
     // STARFIELD renderer pointer
     std::unique_ptr<GLStarfieldRenderer> m_GLStarfieldRenderer;
@@ -0,0 +1,226 @@
+// mapcompiler.cpp — INC offline map compiler
+//
+// Turns a JSON map (maps/<name>.json) into a compiled binary map (.imapc):
+// - Entity table with classname offsets into a shared string table
+// - Procedural static_geometry baked into vertex/index pools as unit primitives
+// - Each unit primitive (type + LOD) is baked only once; entities carry scale
+// - prop_static keeps its model path and angles; the engine loads the model itself
+// The engine mmaps the result and reads it in place (see world/map_format.h).
+//
+// Usage: mapcompiler <map.json> [out.imapc]
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "world/map_format.h"
+#include "world/mesh_primitives.h"
+
+using json = nlohmann::json;
+
+struct MapBuilder {
+    std::vector<CompiledMapEntity> entities;
+    std::vector<CompiledMapGeometry> geometry;
+    std::vector<float> vertexPool;
+    std::vector<uint32_t> indexPool;
+    std::string strings;
+
+    std::unordered_map<std::string, uint32_t> stringLookup;
+    std::unordered_map<std::string, int32_t> geometryLookup;
+
+    MapBuilder() {
+        AddString(""); // Offset 0 is always the empty string
+    }
+
+    uint32_t AddString(const std::string& str) {
+        auto it = stringLookup.find(str);
+        if (it != stringLookup.end())
+            return it->second;
+
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(str);
+        strings.push_back('\0');
+        stringLookup.emplace(str, offset);
+        return offset;
+    }
+
+    // Returns the geometry index (or -1 for unknown types) and the scale that turns the
+    // unit primitive back into the authored size. Defaults mirror LoadStaticGeometryFromMap.
+    int32_t AddGeometry(const json& geo, float scaleOut[3]) {
+        std::string type = geo.value("type", "");
+
+        CompiledGeometryType geoType;
+        float params[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        if (type == "cube") {
+            auto size = geo.value("size", std::vector<float>{1, 1, 1});
+            geoType = CompiledGeometryType::Cube;
+            params[0] = size[0];
+            params[1] = size[1];
+            params[2] = size[2];
+        } else if (type == "plane") {
+            auto size = geo.value("size", std::vector<float>{1, 1});
+            geoType = CompiledGeometryType::Plane;
+            params[0] = size[0];
+            params[2] = size[1];
+        } else if (type == "sphere") {
+            geoType = CompiledGeometryType::Sphere;
+            params[0] = geo.value("radius", 1.0f);
+            params[1] = static_cast<float>(geo.value("slices", 32));
+            params[2] = static_cast<float>(geo.value("stacks", 16));
+        } else {
+            std::cerr << "[MapCompiler] Unknown geometry type '" << type << "', skipped\n";
+            return -1;
+        }
+
+        CompiledMapGeometry record = {};
+        Vector3_f scale;
+        record.type = static_cast<uint32_t>(geoType);
+        geometry::MakeUnitPrimitive(geoType, params, record.params, scale);
+
+        scaleOut[0] = scale.x;
+        scaleOut[1] = scale.y;
+        scaleOut[2] = scale.z;
+
+        // Dedupe on the raw unit parameter bytes
+        std::string key(reinterpret_cast<const char*>(&record.type), sizeof(record.type) + sizeof(record.params));
+        auto it = geometryLookup.find(key);
+        if (it != geometryLookup.end())
+            return it->second;
+
+        std::vector<float> verts;
+        std::vector<unsigned int> indices;
+        geometry::CreateUnitPrimitiveMesh(geoType, record.params, verts, indices);
+
+        record.firstVertexFloat = static_cast<uint32_t>(vertexPool.size());
+        record.vertexFloatCount = static_cast<uint32_t>(verts.size());
+        record.firstIndex = static_cast<uint32_t>(indexPool.size());
+        record.indexCount = static_cast<uint32_t>(indices.size());
+
+        vertexPool.insert(vertexPool.end(), verts.begin(), verts.end());
+        indexPool.insert(indexPool.end(), indices.begin(), indices.end());
+
+        int32_t index = static_cast<int32_t>(geometry.size());
+        geometry.push_back(record);
+        geometryLookup.emplace(std::move(key), index);
+        return index;
+    }
+
+    void AddEntity(const json& ent) {
+        CompiledMapEntity record = {};
+        record.classnameOffset = AddString(ent.value("classname", "unknown"));
+
+        auto origin = ent.value("origin", std::vector<float>{0, 0, 0});
+        record.origin[0] = origin[0];
+        record.origin[1] = origin[1];
+        record.origin[2] = origin[2];
+
+        auto angles = ent.value("angles", std::vector<float>{0, 0, 0});
+        record.angles[0] = angles[0];
+        record.angles[1] = angles[1];
+        record.angles[2] = angles[2];
+
+        record.modelOffset = AddString(ent.value("model", ""));
+        record.scale[0] = record.scale[1] = record.scale[2] = 1.0f;
+        record.geometryIndex = -1;
+        if (ent.value("classname", "") == "static_geometry" && ent.contains("geometry"))
+            record.geometryIndex = AddGeometry(ent["geometry"], record.scale);
+
+        entities.push_back(record);
+    }
+
+    bool Write(const std::string& outPath) const {
+        CompiledMapHeader header = {};
+        header.magic = COMPILED_MAP_MAGIC;
+        header.version = COMPILED_MAP_VERSION;
+
+        uint32_t offset = sizeof(CompiledMapHeader);
+        auto place = [&offset](uint32_t bytes) {
+            uint32_t start = offset;
+            offset += (bytes + 3) & ~3u; // Keep every section 4-byte aligned
+            return start;
+        };
+
+        header.entityCount = static_cast<uint32_t>(entities.size());
+        header.entityOffset = place(header.entityCount * sizeof(CompiledMapEntity));
+        header.geometryCount = static_cast<uint32_t>(geometry.size());
+        header.geometryOffset = place(header.geometryCount * sizeof(CompiledMapGeometry));
+        header.vertexFloatCount = static_cast<uint32_t>(vertexPool.size());
+        header.vertexOffset = place(header.vertexFloatCount * sizeof(float));
+        header.indexCount = static_cast<uint32_t>(indexPool.size());
+        header.indexOffset = place(header.indexCount * sizeof(uint32_t));
+        header.stringTableSize = static_cast<uint32_t>(strings.size());
+        header.stringTableOffset = place(header.stringTableSize);
+        header.fileSize = offset;
+
+        std::vector<unsigned char> blob(header.fileSize, 0);
+        auto copy = [&blob](uint32_t at, const void* src, size_t bytes) {
+            if (bytes) std::memcpy(blob.data() + at, src, bytes);
+        };
+
+        copy(0, &header, sizeof(header));
+        copy(header.entityOffset, entities.data(), entities.size() * sizeof(CompiledMapEntity));
+        copy(header.geometryOffset, geometry.data(), geometry.size() * sizeof(CompiledMapGeometry));
+        copy(header.vertexOffset, vertexPool.data(), vertexPool.size() * sizeof(float));
+        copy(header.indexOffset, indexPool.data(), indexPool.size() * sizeof(uint32_t));
+        copy(header.stringTableOffset, strings.data(), strings.size());
+
+        std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[MapCompiler] Failed to open output: " << outPath << "\n";
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+        return out.good();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: mapcompiler <map.json> [out.imapc]\n";
+        return 1;
+    }
+
+    std::string inPath = argv[1];
+    std::string outPath;
+    if (argc > 2) {
+        outPath = argv[2];
+    } else {
+        size_t dot = inPath.find_last_of('.');
+        outPath = (dot == std::string::npos ? inPath : inPath.substr(0, dot)) + ".imapc";
+    }
+
+    std::ifstream inFile(inPath);
+    if (!inFile.is_open()) {
+        std::cerr << "[MapCompiler] Failed to open map: " << inPath << "\n";
+        return 1;
+    }
+
+    json mapData;
+    try {
+        inFile >> mapData;
+    } catch (const std::exception& e) {
+        std::cerr << "[MapCompiler] JSON parsing error: " << e.what() << "\n";
+        return 1;
+    }
+
+    MapBuilder builder;
+    if (mapData.contains("entities") && mapData["entities"].is_array()) {
+        for (const auto& ent : mapData["entities"])
+            builder.AddEntity(ent);
+    }
+
+    if (!builder.Write(outPath))
+        return 1;
+
+    std::cout << "[MapCompiler] " << inPath << " -> " << outPath << ": "
+              << builder.entities.size() << " entities, "
+              << builder.geometry.size() << " unique geometry, "
+              << builder.vertexPool.size() / 3 << " vertices, "
+              << builder.indexPool.size() << " indices\n";
+    return 0;
+}
@@ -0,0 +1,289 @@
+// mathbench.cpp — INC mathlib micro-benchmark
+//
+// Times the 4x4 matrix kernels in simd_kernels.h against their simd::scalar
+// reference versions and checks that both produce the same results, then
+// compares Vector3Batch_f bulk ops with the equivalent per-Vector3_f loops.
+// Build with MODE=Release so the numbers reflect -O3 -march=native.
+//
+// Usage: mathbench [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "mathlib/simd_kernels.h"
+#include "mathlib/vector3_batch.h"
+
+static constexpr size_t MATRIX_COUNT = 1024; // 64 KB of floats, stays in L2
+
+static volatile double g_Sink = 0.0; // Keeps results alive under -O3
+
+template <typename T>
+static std::vector<T> RandomMatrices(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-10.0, 10.0);
+    std::vector<T> data(count * 16);
+    for (size_t i = 0; i < count; ++i) {
+        for (int j = 0; j < 16; ++j)
+            data[i * 16 + j] = static_cast<T>(dist(rng));
+        // Diagonal bias keeps the inverse tests well conditioned
+        for (int d = 0; d < 4; ++d)
+            data[i * 16 + d * 5] += static_cast<T>(40.0);
+    }
+    return data;
+}
+
+template <typename T>
+static double Checksum(const std::vector<T>& v) {
+    double sum = 0.0;
+    for (T x : v)
+        sum += static_cast<double>(x);
+    return sum;
+}
+
+// Runs fn over the whole matrix set `iterations` times, returns ns per matrix op
+template <typename Fn>
+static double TimeNsPerOp(int iterations, size_t opsPerIteration, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (static_cast<double>(iterations) * static_cast<double>(opsPerIteration));
+}
+
+// Times a reference and a candidate fairly: both are warmed up first (caches, branch
+// predictors, clock ramp-up), then timed in alternating rounds, swapping which goes
+// first each round. The best round of each is kept, since noise only ever adds time.
+static constexpr int TIMING_ROUNDS = 5;
+
+template <typename RefFn, typename TestFn>
+static void TimePair(int iterations, size_t opsPerIteration, RefFn&& refFn, TestFn&& testFn,
+                     double& refNs, double& testNs) {
+    const int roundIterations = std::max(1, iterations / TIMING_ROUNDS);
+    TimeNsPerOp(roundIterations, opsPerIteration, refFn);
+    TimeNsPerOp(roundIterations, opsPerIteration, testFn);
+
+    refNs = testNs = 1e300;
+    for (int round = 0; round < TIMING_ROUNDS; ++round) {
+        if (round & 1) {
+            testNs = std::min(testNs, TimeNsPerOp(roundIterations, opsPerIteration, testFn));
+            refNs = std::min(refNs, TimeNsPerOp(roundIterations, opsPerIteration, refFn));
+        } else {
+            refNs = std::min(refNs, TimeNsPerOp(roundIterations, opsPerIteration, refFn));
+            testNs = std::min(testNs, TimeNsPerOp(roundIterations, opsPerIteration, testFn));
+        }
+    }
+}
+
+template <typename T>
+static double MaxRelError(const std::vector<T>& a, const std::vector<T>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        double diff = std::fabs(static_cast<double>(a[i]) - static_cast<double>(b[i]));
+        double mag = std::fabs(static_cast<double>(b[i]));
+        worst = std::max(worst, diff / (mag > 1.0 ? mag : 1.0));
+    }
+    return worst;
+}
+
+static void Report(const char* name, double scalarNs, double simdNs, double error) {
+    std::printf("  %-22s %9.2f ns %9.2f ns %7.2fx   max rel err %.2e\n",
+                name, scalarNs, simdNs, scalarNs / simdNs, error);
+}
+
+template <typename T>
+static bool RunSuite(const char* typeName, int iterations, double tolerance) {
+    const std::vector<T> a = RandomMatrices<T>(MATRIX_COUNT, 1);
+    const std::vector<T> b = RandomMatrices<T>(MATRIX_COUNT, 2);
+    std::vector<T> outScalar(MATRIX_COUNT * 16);
+    std::vector<T> outSimd(MATRIX_COUNT * 16);
+    bool ok = true;
+
+    std::printf("%s\n  %-22s %12s %12s %8s\n", typeName, "kernel", "scalar", "simd", "speedup");
+
+    // mat * mat
+    double scalarNs, simdNs;
+    TimePair(iterations, MATRIX_COUNT,
+        [&] {
+            for (size_t i = 0; i < MATRIX_COUNT; ++i)
+                simd::scalar::Mat4Mul(&a[i * 16], &b[i * 16], &outScalar[i * 16]);
+            g_Sink = g_Sink + outScalar[0];
+        },
+        [&] {
+            for (size_t i = 0; i < MATRIX_COUNT; ++i)
+                simd::Mat4Mul(&a[i * 16], &b[i * 16], &outSimd[i * 16]);
+            g_Sink = g_Sink + outSimd[0];
+        },
+        scalarNs, simdNs);
+    double err = MaxRelError(outSimd, outScalar);
+    ok &= err <= tolerance;
+    Report("Mat4Mul", scalarNs, simdNs, err);
+
+    // mat * vec4: simd::Mat4MulVec4 is the scalar code by design (see simd_kernels.h),
+    // so there is nothing to time, only the results to check
+    const size_t vecCount = MATRIX_COUNT * 4;
+    for (size_t i = 0; i < vecCount; ++i) {
+        simd::scalar::Mat4MulVec4(&a[0], &b[i * 4], &outScalar[i * 4]);
+        simd::Mat4MulVec4(&a[0], &b[i * 4], &outSimd[i * 4]);
+    }
+    err = MaxRelError(outSimd, outScalar);
+    ok &= err <= tolerance;
+    std::printf("  %-22s %33s   max rel err %.2e\n", "Mat4MulVec4", "(scalar in every build)", err);
+
+    // one matrix times many (viewProj * model[])
+    TimePair(iterations, MATRIX_COUNT,
+        [&] {
+            simd::scalar::Mat4MulBatch(&a[0], b.data(), outScalar.data(), MATRIX_COUNT);
+            g_Sink = g_Sink + outScalar[0];
+        },
+        [&] {
+            simd::Mat4MulBatch(&a[0], b.data(), outSimd.data(), MATRIX_COUNT);
+            g_Sink = g_Sink + outSimd[0];
+        },
+        scalarNs, simdNs);
+    err = MaxRelError(outSimd, outScalar);
+    ok &= err <= tolerance;
+    Report("Mat4MulBatch", scalarNs, simdNs, err);
+
+    // inverse
+    TimePair(iterations, MATRIX_COUNT,
+        [&] {
+            for (size_t i = 0; i < MATRIX_COUNT; ++i)
+                simd::scalar::Mat4Inverse(&a[i * 16], &outScalar[i * 16]);
+            g_Sink = g_Sink + outScalar[0];
+        },
+        [&] {
+            for (size_t i = 0; i < MATRIX_COUNT; ++i)
+                simd::Mat4Inverse(&a[i * 16], &outSimd[i * 16]);
+            g_Sink = g_Sink + outSimd[0];
+        },
+        scalarNs, simdNs);
+    err = MaxRelError(outSimd, outScalar);
+    ok &= err <= tolerance;
+    Report("Mat4Inverse", scalarNs, simdNs, err);
+
+    // m * inverse(m) must come back as identity
+    double identityErr = 0.0;
+    for (size_t i = 0; i < MATRIX_COUNT; ++i) {
+        T product[16];
+        simd::Mat4Mul(&a[i * 16], &outSimd[i * 16], product);
+        for (int j = 0; j < 16; ++j) {
+            double expected = (j % 5 == 0) ? 1.0 : 0.0;
+            identityErr = std::max(identityErr, std::fabs(static_cast<double>(product[j]) - expected));
+        }
+    }
+    ok &= identityErr <= tolerance * 10.0;
+    std::printf("  %-22s %.2e\n\n", "M * inverse(M) error", identityErr);
+
+    g_Sink = g_Sink + Checksum(outSimd);
+    return ok;
+}
+
+// AoS loop over Vector3_f vs the SoA batch, per element
+static bool RunVectorSuite(int iterations) {
+    const size_t count = MATRIX_COUNT * 4;
+    const std::vector<float> src = RandomMatrices<float>(count * 3 / 16 + 1, 3);
+    const Matrix4x4_f m = Matrix4x4_f::Translation(Vector3_f(1.0f, 2.0f, 3.0f)) *
+                          Matrix4x4_f::Scale(Vector3_f(2.0f, 0.5f, 4.0f));
+
+    std::vector<Vector3_f> aos(count);
+    Vector3Batch_f soa;
+    soa.Resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        aos[i] = Vector3_f(src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+        soa.Set(i, aos[i]);
+    }
+
+    std::vector<Vector3_f> aosOut(count);
+    Vector3Batch_f soaOut;
+    std::vector<float> lengths(count);
+    bool ok = true;
+
+    std::printf("Vector3Batch_f\n  %-22s %12s %12s %8s\n", "op", "Vector3_f", "batch", "speedup");
+
+    double aosNs, soaNs;
+    TimePair(iterations, count,
+        [&] {
+            for (size_t i = 0; i < count; ++i) {
+                const Vector3_f& v = aos[i];
+                aosOut[i] = Vector3_f(m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0],
+                                      m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1],
+                                      m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2]);
+            }
+            g_Sink = g_Sink + aosOut[0].x;
+        },
+        [&] {
+            soa.TransformPoints(m, soaOut);
+            g_Sink = g_Sink + soaOut.X()[0];
+        },
+        aosNs, soaNs);
+    double err = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        Vector3_f d = soaOut.Get(i) - aosOut[i];
+        err = std::max(err, static_cast<double>(std::fabs(d.x) + std::fabs(d.y) + std::fabs(d.z)));
+    }
+    ok &= err <= 1e-3;
+    Report("TransformPoints", aosNs, soaNs, err);
+
+    TimePair(iterations, count,
+        [&] {
+            for (size_t i = 0; i < count; ++i)
+                lengths[i] = aos[i].Length();
+            g_Sink = g_Sink + lengths[0];
+        },
+        [&] {
+            soa.Length(lengths.data());
+            g_Sink = g_Sink + lengths[0];
+        },
+        aosNs, soaNs);
+    Report("Length", aosNs, soaNs, 0.0);
+
+    TimePair(iterations, count,
+        [&] {
+            for (size_t i = 0; i < count; ++i)
+                aosOut[i] = aos[i].Normalize();
+            g_Sink = g_Sink + aosOut[0].x;
+        },
+        [&] {
+            soaOut = soa;
+            soaOut.Normalize();
+            g_Sink = g_Sink + soaOut.X()[0];
+        },
+        aosNs, soaNs);
+    err = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        Vector3_f d = soaOut.Get(i) - aosOut[i];
+        err = std::max(err, static_cast<double>(std::fabs(d.x) + std::fabs(d.y) + std::fabs(d.z)));
+    }
+    ok &= err <= 1e-5;
+    Report("Normalize", aosNs, soaNs, err);
+    std::printf("\n");
+
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (iterations <= 0) {
+        std::fprintf(stderr, "Usage: mathbench [iterations]\n");
+        return 1;
+    }
+
+    std::printf("[mathbench] ISA: %s, %zu matrices x %d iterations\n\n",
+                simd::GetISAName(), MATRIX_COUNT, iterations);
+
+    bool ok = RunSuite<float>("Matrix4x4_f", iterations, 1e-4);
+    ok &= RunSuite<double>("Matrix4x4_d", iterations, 1e-10);
+    ok &= RunVectorSuite(iterations);
+
+    if (!ok) {
+        std::fprintf(stderr, "[mathbench] SIMD results diverge from the scalar reference!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+// meshstats.cpp — INC mesh vertex cache statistics
+//
+// Prints the post-transform cache figures of a mesh as stored and after
+// geometry::OptimizeMesh (see world/mesh_optimizer.h):
+// - ACMR: vertex shader runs per triangle (0.5 ideal, 3 worst)
+// - ATVR: vertex shader runs per referenced vertex (1 ideal)
+// Inputs are .imdl source models, .imdlc cooked models (already optimized when
+// cooked at version 2+) or the built-in primitives. Primitives are measured
+// straight from their generators, i.e. before the engine reorders them.
+//
+// Usage: meshstats <model.imdl | model.imdlc | sphere[:lod] | cube | plane> [-cache N]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "world/mesh_optimizer.h"
+#include "world/mesh_primitives.h"
+#include "world/model_format.h"
+#include "world/model_source.h"
+
+// Float vertices of vertexStride floats, position first
+struct StatsMesh {
+    std::vector<float> verts;
+    size_t vertexStride = 3;
+    std::vector<unsigned int> indices;
+};
+
+static bool EndsWith(const std::string& str, const char* suffix) {
+    const size_t len = std::strlen(suffix);
+    return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+}
+
+static bool ReadWholeFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool LoadSourceModel(const std::string& path, StatsMesh& mesh) {
+    std::vector<char> bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        std::cerr << "[MeshStats] Failed to open " << path << "\n";
+        return false;
+    }
+
+    // Same parse and validation as ModelCache::Cook
+    ModelSource model;
+    std::string error;
+    if (!ParseModelSource(bytes.data(), bytes.size(), model, error)) {
+        std::cerr << "[MeshStats] " << path << " " << error << "\n";
+        return false;
+    }
+    mesh.vertexStride = sizeof(ModelVertex) / sizeof(float);
+    mesh.verts = std::move(model.vertexFloats);
+    mesh.indices = std::move(model.indices);
+    return true;
+}
+
+static bool LoadCookedModel(const std::string& path, StatsMesh& mesh) {
+    std::vector<char> bytes;
+    if (!ReadWholeFile(path, bytes)) {
+        std::cerr << "[MeshStats] Failed to open " << path << "\n";
+        return false;
+    }
+
+    ModelHeader header;
+    if (bytes.size() < sizeof(header)) {
+        std::cerr << "[MeshStats] " << path << " is too small for a cooked model\n";
+        return false;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != MODEL_MAGIC || (header.indexSize != 2 && header.indexSize != 4) ||
+        static_cast<uint64_t>(header.vertexOffset) + uint64_t(header.vertexCount) * sizeof(ModelVertex) > bytes.size() ||
+        static_cast<uint64_t>(header.indexOffset) + uint64_t(header.indexCount) * header.indexSize > bytes.size()) {
+        std::cerr << "[MeshStats] " << path << " is not a valid cooked model\n";
+        return false;
+    }
+
+    mesh.vertexStride = sizeof(ModelVertex) / sizeof(float);
+    mesh.verts.resize(header.vertexCount * mesh.vertexStride);
+    std::memcpy(mesh.verts.data(), bytes.data() + header.vertexOffset, header.vertexCount * sizeof(ModelVertex));
+
+    mesh.indices.resize(header.indexCount);
+    for (uint32_t i = 0; i < header.indexCount; ++i) {
+        const char* src = bytes.data() + header.indexOffset + i * header.indexSize;
+        if (header.indexSize == 2) {
+            uint16_t index16;
+            std::memcpy(&index16, src, sizeof(index16));
+            mesh.indices[i] = index16;
+        } else {
+            std::memcpy(&mesh.indices[i], src, sizeof(uint32_t));
+        }
+    }
+    return true;
+}
+
+static bool LoadPrimitive(const std::string& name, StatsMesh& mesh) {
+    mesh.vertexStride = 3;
+    if (name == "cube") {
+        geometry::CreateCubeMesh(mesh.verts, mesh.indices, Vector3_f(1.0f, 1.0f, 1.0f));
+        return true;
+    }
+    if (name == "plane") {
+        geometry::CreatePlaneMesh(mesh.verts, mesh.indices, Vector3_f(1.0f, 0.0f, 1.0f));
+        return true;
+    }
+    if (name == "sphere" || name.compare(0, 7, "sphere:") == 0) {
+        const int lod = name.size() > 7 ? std::atoi(name.c_str() + 7) : geometry::SPHERE_LOD_COUNT - 1;
+        if (lod < 0 || lod >= geometry::SPHERE_LOD_COUNT) {
+            std::cerr << "[MeshStats] Sphere LOD must be 0-" << geometry::SPHERE_LOD_COUNT - 1 << "\n";
+            return false;
+        }
+        const geometry::SphereLOD& sphere = geometry::SPHERE_LODS[lod];
+        geometry::CreateSphereMesh(mesh.verts, mesh.indices, 1.0f, sphere.slices, sphere.stacks);
+        return true;
+    }
+    std::cerr << "[MeshStats] Unknown mesh " << name << "\n";
+    return false;
+}
+
+static void PrintStats(const char* label, const geometry::VertexCacheStats& stats) {
+    std::printf("  %-10s ACMR %.3f  ATVR %.3f\n", label, stats.acmr, stats.atvr);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: meshstats <model.imdl | model.imdlc | sphere[:lod] | cube | plane> [-cache N]\n";
+        return 1;
+    }
+
+    const std::string input = argv[1];
+    uint32_t cacheSize = geometry::VERTEX_CACHE_SIZE;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-cache") == 0 && i + 1 < argc)
+            cacheSize = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+    }
+
+    StatsMesh mesh;
+    bool loaded;
+    if (EndsWith(input, ".imdlc"))
+        loaded = LoadCookedModel(input, mesh);
+    else if (EndsWith(input, ".imdl"))
+        loaded = LoadSourceModel(input, mesh);
+    else
+        loaded = LoadPrimitive(input, mesh);
+    if (!loaded)
+        return 1;
+
+    const size_t vertexCount = mesh.verts.size() / mesh.vertexStride;
+    if (mesh.indices.size() % 3 != 0 || mesh.indices.empty()) {
+        std::cerr << "[MeshStats] " << input << " has no complete triangles\n";
+        return 1;
+    }
+    for (unsigned int index : mesh.indices) {
+        if (index >= vertexCount) {
+            std::cerr << "[MeshStats] " << input << " has index " << index << " out of range\n";
+            return 1;
+        }
+    }
+
+    std::printf("%s: %zu vertices, %zu triangles, %u-entry FIFO cache\n",
+                input.c_str(), vertexCount, mesh.indices.size() / 3, cacheSize);
+    PrintStats("stored", geometry::AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), vertexCount, cacheSize));
+
+    const geometry::MeshOptimizeReport report = geometry::OptimizeMesh(mesh.verts, mesh.vertexStride, mesh.indices);
+    PrintStats("optimized", geometry::AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(),
+                                                          mesh.verts.size() / mesh.vertexStride, cacheSize));
+    if (report.overdrawReordered)
+        std::printf("  clusters reordered for overdraw\n");
+    return 0;
+}
@@ -0,0 +1,202 @@
+// packbuilder.cpp — INC offline pack builder
+//
+// Packs a content directory into a single .ipak (see filesystem/pack_format.h):
+// - Directory table and per-directory entry tables over a shared string table
+// - Paths stored lowercase with '/' separators, as the filesystem indexes them
+// - Each entry LZ4-compressed when that saves at least 1/8 of its size, else stored
+// List the pack in gameinfo.txt SearchPaths (game "platform/pak01.ipak"); loose
+// files in other search paths still override what is packed.
+//
+// Usage: packbuilder <content dir> <out.ipak> [-nocompress]
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "filesystem/lz4_block.h"
+#include "filesystem/pack_format.h"
+
+namespace fs = std::filesystem;
+
+// Entries below this size are always stored; the sequence overhead eats any gain
+constexpr size_t MIN_COMPRESS_SIZE = 64;
+constexpr uint64_t DATA_ALIGNMENT = 16;
+
+struct SourceFile {
+    std::string name;       // Lowercase file name
+    fs::path source;
+};
+
+static std::string ToLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+static bool ReadWholeFile(const fs::path& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static void PadTo(std::ofstream& out, uint64_t alignment) {
+    static const char zeros[DATA_ALIGNMENT] = {};
+    const uint64_t pos = static_cast<uint64_t>(out.tellp());
+    const uint64_t padding = (alignment - pos % alignment) % alignment;
+    out.write(zeros, static_cast<std::streamsize>(padding));
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: packbuilder <content dir> <out.ipak> [-nocompress]\n";
+        return 1;
+    }
+
+    const fs::path root = argv[1];
+    const fs::path outPath = argv[2];
+    const bool compress = !(argc > 3 && std::strcmp(argv[3], "-nocompress") == 0);
+
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        std::cerr << "[PackBuilder] Not a directory: " << root.string() << "\n";
+        return 1;
+    }
+
+    // Gather files grouped by directory; std::map keeps both levels sorted
+    std::map<std::string, std::map<std::string, SourceFile>> tree;
+    const fs::path outAbsolute = fs::absolute(outPath, ec);
+    for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+         it != end; it.increment(ec)) {
+        if (ec)
+            break;
+        std::error_code ignored;
+        if (!it->is_regular_file(ignored) || fs::equivalent(it->path(), outAbsolute, ignored))
+            continue;
+
+        const fs::path relative = it->path().lexically_relative(root);
+        const std::string directory = ToLower(relative.parent_path().generic_string());
+        const std::string name = ToLower(relative.filename().string());
+
+        auto& files = tree[directory];
+        if (!files.emplace(name, SourceFile{ name, it->path() }).second)
+            std::cerr << "[PackBuilder] '" << relative.generic_string() << "' differs from another file only by case, skipped\n";
+    }
+
+    // String table and directory/entry records; data offsets are filled in while writing
+    std::string strings(1, '\0'); // Offset 0 is the empty string (the root directory)
+    auto addString = [&](const std::string& str) {
+        if (str.empty())
+            return 0u;
+        const uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(str);
+        strings.push_back('\0');
+        return offset;
+    };
+
+    std::vector<PackDirectory> directories;
+    std::vector<PackEntry> entries;
+    std::vector<const SourceFile*> sources;
+    for (const auto& [directory, files] : tree) {
+        PackDirectory record = {};
+        record.pathOffset = addString(directory);
+        record.firstEntry = static_cast<uint32_t>(entries.size());
+        record.entryCount = static_cast<uint32_t>(files.size());
+        directories.push_back(record);
+
+        for (const auto& [name, file] : files) {
+            PackEntry entry = {};
+            entry.nameOffset = addString(name);
+            entries.push_back(entry);
+            sources.push_back(&file);
+        }
+    }
+
+    PackHeader header = {};
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.directoryCount = static_cast<uint32_t>(directories.size());
+    header.directoryOffset = sizeof(PackHeader);
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.entryOffset = header.directoryOffset + header.directoryCount * sizeof(PackDirectory);
+    header.entryOffset = (header.entryOffset + 7u) & ~7u;
+    header.stringTableSize = static_cast<uint32_t>(strings.size());
+    header.stringTableOffset = header.entryOffset + header.entryCount * sizeof(PackEntry);
+
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[PackBuilder] Failed to write " << outPath.string() << "\n";
+        return 1;
+    }
+
+    // Tables are rewritten once the data offsets are known
+    out.seekp(header.stringTableOffset);
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    std::vector<char> data;
+    std::vector<char> packed;
+    uint64_t totalSize = 0;
+    uint64_t totalStored = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        PackEntry& entry = entries[i];
+        if (!ReadWholeFile(sources[i]->source, data)) {
+            std::cerr << "[PackBuilder] Failed to read " << sources[i]->source.string() << "\n";
+            return 1;
+        }
+        if (data.size() > UINT32_MAX) {
+            std::cerr << "[PackBuilder] " << sources[i]->source.string() << " is larger than 4 GB\n";
+            return 1;
+        }
+
+        const char* stored = data.data();
+        entry.size = static_cast<uint32_t>(data.size());
+        entry.storedSize = entry.size;
+        entry.compression = static_cast<uint32_t>(PackCompression::None);
+
+        if (compress && data.size() >= MIN_COMPRESS_SIZE) {
+            packed.resize(lz4::CompressBound(data.size()));
+            const size_t packedSize = lz4::CompressBlock(data.data(), data.size(), packed.data(), packed.size());
+            if (packedSize > 0 && packedSize <= data.size() - data.size() / 8) {
+                stored = packed.data();
+                entry.storedSize = static_cast<uint32_t>(packedSize);
+                entry.compression = static_cast<uint32_t>(PackCompression::LZ4);
+            }
+        }
+
+        PadTo(out, DATA_ALIGNMENT);
+        entry.dataOffset = static_cast<uint64_t>(out.tellp());
+        out.write(stored, entry.storedSize);
+
+        totalSize += entry.size;
+        totalStored += entry.storedSize;
+    }
+
+    header.fileSize = static_cast<uint64_t>(out.tellp());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(directories.data()),
+              static_cast<std::streamsize>(directories.size() * sizeof(PackDirectory)));
+    out.seekp(header.entryOffset);
+    out.write(reinterpret_cast<const char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+    out.close();
+
+    if (!out) {
+        std::cerr << "[PackBuilder] Write failed: " << outPath.string() << "\n";
+        return 1;
+    }
+
+    std::cout << "[PackBuilder] " << outPath.string() << ": " << entries.size() << " files in "
+              << directories.size() << " directories, " << totalSize << " -> " << totalStored << " bytes of data, "
+              << header.fileSize << " bytes total\n";
+    return 0;
+}